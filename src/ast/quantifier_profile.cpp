@@ -0,0 +1,303 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    quantifier_profile.cpp
+
+Abstract:
+
+    Profiler for quantifier instantiation.
+
+--*/
+#include "ast/quantifier_profile.h"
+#include "ast/ast_smt2_pp.h"
+#include "util/warning.h"
+#include <fstream>
+#include <sstream>
+
+namespace q {
+
+    unsigned quantifier_profile::trigger::dominant_producer() const {
+        unsigned best = UINT_MAX, best_count = 0;
+        for (auto const& [p, count] : m_producers)
+            if (count > best_count || (count == best_count && p < best))
+                best = p, best_count = count;
+        return best;
+    }
+
+    quantifier_profile::quantifier_profile(ast_manager& m, unsigned loop_generation):
+        m(m),
+        m_pinned(m),
+        m_terms(m),
+        m_loop_generation(loop_generation) {
+    }
+
+    unsigned quantifier_profile::get_trigger(quantifier* q, app* pat) {
+        unsigned t = m_triggers.size();
+        if (pat) {
+            if (m_pattern2trigger.find(q, pat, t))
+                return t;
+            m_pattern2trigger.insert(q, pat, t);
+        }
+        else {
+            if (m_nopat2trigger.find(q, t))
+                return t;
+            m_nopat2trigger.insert(q, t);
+        }
+        m_pinned.push_back(q);
+        if (pat)
+            m_pinned.push_back(pat);
+        m_triggers.push_back(alloc(trigger, q, pat));
+        return t;
+    }
+
+    void quantifier_profile::start_instance(unsigned t) {
+        SASSERT(m_current == UINT_MAX);
+        m_current = t;
+        m_producer = UINT_MAX;
+        m_producer_generation = 0;
+        m_triggers[t]->m_watch.start();
+    }
+
+    void quantifier_profile::add_binding(expr* e) {
+        std::pair<unsigned, unsigned> p;
+        if (m_term2trigger.find(e, p) && (m_producer == UINT_MAX || p.second > m_producer_generation)) {
+            m_producer = p.first;
+            m_producer_generation = p.second;
+        }
+    }
+
+    void quantifier_profile::add_term(expr* e, unsigned generation) {
+        if (m_current == UINT_MAX)
+            return;
+        trigger& t = *m_triggers[m_current];
+        if (!m_term2trigger.contains(e)) {
+            m_term2trigger.insert(e, std::make_pair(m_current, generation));
+            m_terms.push_back(e);
+        }
+        ++t.m_terms;
+        if (generation > t.m_max_generation)
+            t.m_max_generation = generation;
+    }
+
+    void quantifier_profile::add_var(unsigned v) {
+        if (m_current == UINT_MAX)
+            return;
+        if (v >= m_var2trigger.size())
+            m_var2trigger.resize(v + 1, 0);
+        m_var2trigger[v] = m_current + 1;
+    }
+
+    void quantifier_profile::end_instance(bool instantiated) {
+        if (m_current == UINT_MAX)
+            return;
+        trigger& t = *m_triggers[m_current];
+        t.m_watch.stop();
+        if (!instantiated)
+            ++t.m_redundant;
+        else {
+            ++t.m_instances;
+            if (m_producer != UINT_MAX)
+                t.m_producers.insert_if_not_there(m_producer, 0)++;
+        }
+        m_current = UINT_MAX;
+    }
+
+    void quantifier_profile::shrink_vars(unsigned num_vars) {
+        if (num_vars < m_var2trigger.size())
+            m_var2trigger.shrink(num_vars);
+    }
+
+    void quantifier_profile::shrink_terms(unsigned n) {
+        for (unsigned i = n; i < m_terms.size(); ++i)
+            m_term2trigger.erase(m_terms.get(i));
+        m_terms.shrink(n);
+    }
+
+    void quantifier_profile::add_conflict_var(unsigned v) {
+        if (v >= m_var2trigger.size() || m_var2trigger[v] == 0)
+            return;
+        trigger& t = *m_triggers[m_var2trigger[v] - 1];
+        if (t.m_last_conflict == m_num_conflicts)
+            return;
+        t.m_last_conflict = m_num_conflicts;
+        ++t.m_conflicts;
+    }
+
+    void quantifier_profile::add_match_time(func_decl* head, double secs) {
+        m_match_time.insert_if_not_there(head, 0) += secs;
+    }
+
+    void quantifier_profile::get_heads(app* pat, ptr_vector<func_decl>& heads) {
+        if (!pat)
+            return;
+        for (expr* arg : *pat) {
+            if (!is_app(arg))
+                continue;
+            func_decl* head = to_app(arg)->get_decl();
+            if (!heads.contains(head))
+                heads.push_back(head);
+        }
+    }
+
+    std::ostream& quantifier_profile::display_string(std::ostream& out, std::string const& s) {
+        out << "\"";
+        for (char c : s) {
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    out << ' ';
+                else
+                    out << c;
+            }
+        }
+        return out << "\"";
+    }
+
+    std::ostream& quantifier_profile::display_pattern(std::ostream& out, app* pat) const {
+        if (!pat)
+            return out << "null";
+        std::ostringstream strm;
+        for (unsigned i = 0; i < pat->get_num_args(); ++i)
+            strm << (i > 0 ? " " : "") << mk_ismt2_pp(pat->get_arg(i), m);
+        return display_string(out, strm.str());
+    }
+
+    void quantifier_profile::display_loops(std::ostream& out) const {
+        // follow the dominant producers of triggers that reached the loop generation.
+        // Each trigger is on at most one path, so every cycle is reported once.
+        unsigned n = m_triggers.size();
+        unsigned_vector color(n, 0u);  // 0: not visited, 1: on the current path, 2: done
+        unsigned_vector path;
+        bool first = true;
+        out << "  \"loops\": [";
+        for (unsigned start = 0; start < n; ++start) {
+            if (color[start] != 0 || m_triggers[start]->m_max_generation < m_loop_generation)
+                continue;
+            path.reset();
+            unsigned t = start;
+            while (t != UINT_MAX && color[t] == 0) {
+                color[t] = 1;
+                path.push_back(t);
+                t = m_triggers[t]->dominant_producer();
+            }
+            if (t != UINT_MAX && color[t] == 1) {
+                unsigned i = path.size();
+                while (path[--i] != t)
+                    ;
+                unsigned max_generation = 0;
+                out << (first ? "\n" : ",\n") << "    {\"triggers\": [";
+                first = false;
+                // the path runs from consumers to producers, display the loop in the order of production.
+                for (unsigned j = path.size(); j-- > i; ) {
+                    trigger const& tr = *m_triggers[path[j]];
+                    max_generation = std::max(max_generation, tr.m_max_generation);
+                    out << (j + 1 < path.size() ? ", " : "") << path[j];
+                }
+                out << "], \"qids\": [";
+                for (unsigned j = path.size(); j-- > i; ) {
+                    out << (j + 1 < path.size() ? ", " : "");
+                    display_string(out, m_triggers[path[j]]->m_q->get_qid().str());
+                }
+                out << "], \"max_generation\": " << max_generation << "}";
+            }
+            for (unsigned p : path)
+                color[p] = 2;
+        }
+        out << (first ? "]\n" : "\n  ]\n");
+    }
+
+    std::ostream& quantifier_profile::display_json(std::ostream& out) const {
+        // group the triggers by quantifier, in the order of their first instance.
+        ptr_vector<quantifier> qs;
+        obj_map<quantifier, unsigned_vector> q2triggers;
+        for (unsigned t = 0; t < m_triggers.size(); ++t) {
+            quantifier* q = m_triggers[t]->m_q;
+            if (!q2triggers.contains(q)) {
+                qs.push_back(q);
+                q2triggers.insert(q, unsigned_vector());
+            }
+            q2triggers.find(q).push_back(t);
+        }
+        out << "{\n";
+        out << "  \"conflicts\": " << m_num_conflicts << ",\n";
+        out << "  \"quantifiers\": [";
+        for (unsigned i = 0; i < qs.size(); ++i) {
+            quantifier* q = qs[i];
+            unsigned instances = 0, redundant = 0, terms = 0, conflicts = 0;
+            double time = 0;
+            for (unsigned t : q2triggers[q]) {
+                trigger const& tr = *m_triggers[t];
+                instances += tr.m_instances;
+                redundant += tr.m_redundant;
+                terms += tr.m_terms;
+                conflicts += tr.m_conflicts;
+                time += tr.m_watch.get_seconds();
+            }
+            out << (i > 0 ? ",\n" : "\n") << "    {\"qid\": ";
+            display_string(out, q->get_qid().str());
+            out << ", \"instances\": " << instances << ", \"redundant\": " << redundant
+                << ", \"terms\": " << terms << ", \"conflicts\": " << conflicts
+                << ", \"time\": " << time << ",\n      \"triggers\": [";
+            bool first = true;
+            for (unsigned t : q2triggers[q]) {
+                trigger const& tr = *m_triggers[t];
+                ptr_vector<func_decl> heads;
+                get_heads(tr.m_pat, heads);
+                double match_time = 0;
+                for (func_decl* head : heads) {
+                    double secs = 0;
+                    if (m_match_time.find(head, secs))
+                        match_time += secs;
+                }
+                out << (first ? "\n" : ",\n") << "        {\"id\": " << t << ", \"pattern\": ";
+                first = false;
+                display_pattern(out, tr.m_pat);
+                out << ", \"heads\": [";
+                for (unsigned h = 0; h < heads.size(); ++h) {
+                    out << (h > 0 ? ", " : "");
+                    display_string(out, heads[h]->get_name().str());
+                }
+                out << "]";
+                out << ", \"instances\": " << tr.m_instances << ", \"redundant\": " << tr.m_redundant
+                    << ", \"terms\": " << tr.m_terms << ", \"conflicts\": " << tr.m_conflicts
+                    << ", \"time\": " << tr.m_watch.get_seconds() << ", \"match_time\": " << match_time
+                    << ", \"max_generation\": " << tr.m_max_generation << ", \"producers\": [";
+                bool first_producer = true;
+                for (auto const& [p, count] : tr.m_producers) {
+                    out << (first_producer ? "" : ", ") << "{\"id\": " << p << ", \"instances\": " << count << "}";
+                    first_producer = false;
+                }
+                out << "]}";
+            }
+            out << "\n      ]}";
+        }
+        out << (qs.empty() ? "],\n" : "\n  ],\n");
+        out << "  \"code_trees\": [";
+        bool first = true;
+        for (auto const& [head, secs] : m_match_time) {
+            out << (first ? "\n" : ",\n") << "    {\"head\": ";
+            first = false;
+            display_string(out, head->get_name().str());
+            out << ", \"match_time\": " << secs << "}";
+        }
+        out << (first ? "],\n" : "\n  ],\n");
+        display_loops(out);
+        out << "}\n";
+        return out;
+    }
+
+    void quantifier_profile::write(std::string const& file_name) const {
+        std::ofstream out(file_name);
+        if (!out) {
+            warning_msg("could not open file '%s' for the quantifier profile", file_name.c_str());
+            return;
+        }
+        display_json(out);
+    }
+};
@@ -0,0 +1,127 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    quantifier_profile.h
+
+Abstract:
+
+    Profiler for quantifier instantiation.
+
+    Costs are attributed to triggers, that is, pairs of a quantifier
+    and the pattern that produced the instance (the pattern is null for
+    instances that were not produced by E-matching). For each trigger
+    the profiler records the number of instances, the number of redundant
+    instances, the terms created by the instances, the conflicts whose
+    lemma contains an atom created by the instances, the time spent
+    creating the instances and the largest generation of a created term.
+
+    The trigger that created the binding of highest generation of an
+    instance is recorded as the producer of the instance. Matching loops
+    are reported as cycles of dominant producers among the triggers that
+    reached the loop generation threshold.
+
+    Matching time is measured per code tree, which is shared by all the
+    patterns with the same head symbol. A multi-pattern has a code tree
+    for the head of each of its arguments, and is charged all of them.
+
+    The terms created by the instances are pinned while they are mapped to
+    their trigger. They are released when the scope that created them is
+    popped, see shrink_terms.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+#include "util/obj_pair_hashtable.h"
+#include "util/scoped_ptr_vector.h"
+#include "util/stopwatch.h"
+#include "util/hashtable.h"
+
+namespace q {
+
+    class quantifier_profile {
+
+        struct trigger {
+            quantifier*     m_q;
+            app*            m_pat;
+            unsigned        m_instances { 0 };
+            unsigned        m_redundant { 0 };
+            unsigned        m_terms { 0 };
+            unsigned        m_conflicts { 0 };
+            unsigned        m_last_conflict { UINT_MAX };
+            unsigned        m_max_generation { 0 };
+            stopwatch       m_watch;          // time spent creating the instances
+            u_map<unsigned> m_producers;  // producer trigger -> number of instances
+            trigger(quantifier* q, app* pat): m_q(q), m_pat(pat) {}
+            unsigned dominant_producer() const;
+        };
+
+        ast_manager&                            m;
+        ast_ref_vector                          m_pinned;
+        scoped_ptr_vector<trigger>              m_triggers;
+        obj_pair_map<quantifier, app, unsigned> m_pattern2trigger;
+        obj_map<quantifier, unsigned>           m_nopat2trigger;
+        obj_map<expr, std::pair<unsigned, unsigned>> m_term2trigger; // term -> (trigger, generation)
+        expr_ref_vector                         m_terms;          // the keys of m_term2trigger, in insertion order
+        unsigned_vector                         m_var2trigger;    // bool var -> trigger + 1
+        obj_map<func_decl, double>              m_match_time;
+        unsigned                                m_num_conflicts { 0 };
+        unsigned                                m_loop_generation;
+        // instance being created
+        unsigned                                m_current { UINT_MAX };
+        unsigned                                m_producer { UINT_MAX };
+        unsigned                                m_producer_generation { 0 };
+
+        void display_loops(std::ostream& out) const;
+        std::ostream& display_pattern(std::ostream& out, app* pat) const;
+        static std::ostream& display_string(std::ostream& out, std::string const& s);
+        static void get_heads(app* pat, ptr_vector<func_decl>& heads);
+
+    public:
+
+        quantifier_profile(ast_manager& m, unsigned loop_generation);
+
+        unsigned get_trigger(quantifier* q, app* pat);
+
+        /**
+           \brief bracket the creation of an instance of trigger t.
+           add_binding is called for each binding, add_term and add_var
+           for each term and atom created by the instance.
+         */
+        void start_instance(unsigned t);
+        void add_binding(expr* e);
+        void add_term(expr* e, unsigned generation);
+        void add_var(unsigned v);
+        void end_instance(bool instantiated);
+
+        /**
+           \brief bool variables at or above num_vars were deleted on backtracking.
+         */
+        void shrink_vars(unsigned num_vars);
+
+        /**
+           \brief the terms created after num_terms() returned n were deleted on backtracking.
+         */
+        unsigned num_terms() const { return m_terms.size(); }
+        void shrink_terms(unsigned n);
+
+        /**
+           \brief attribute a conflict to the triggers that created the variables of its lemma.
+         */
+        void begin_conflict() { ++m_num_conflicts; }
+        void add_conflict_var(unsigned v);
+
+        /**
+           \brief the match time of the code trees is cumulative, it is collected anew for each report.
+         */
+        void reset_match_time() { m_match_time.reset(); }
+        void add_match_time(func_decl* head, double secs);
+
+        std::ostream& display_json(std::ostream& out) const;
+
+        void write(std::string const& file_name) const;
+    };
+};
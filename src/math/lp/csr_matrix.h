@@ -0,0 +1,155 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    csr_matrix.h
+
+Abstract:
+
+    A compressed sparse row copy of the rows of a static_matrix.
+
+    The cells of all the rows are kept in one array, so a row is scanned
+    linearly and consecutive rows are close in memory. Each row has slack
+    capacity and is rewritten in place when it still fits. A row that
+    grows beyond its capacity moves to the end of the array, and the
+    array is compacted when more than half of it is unused.
+
+    A row is copied again only when its stamp in the static_matrix
+    differs from the stamp of the copy, that is, when the row changed
+    since it was copied.
+
+--*/
+#pragma once
+
+#include "util/vector.h"
+#include "math/lp/static_matrix.h"
+
+namespace lp {
+
+template <typename T>
+class csr_matrix {
+public:
+    class cell {
+        unsigned m_j;
+        T        m_coeff;
+    public:
+        cell(): m_j(UINT_MAX) {}
+        unsigned var() const { return m_j; }
+        T const & coeff() const { return m_coeff; }
+        void set(unsigned j, T const & coeff) { m_j = j; m_coeff = coeff; }
+    };
+
+    // a view of a row, it is valid until the next call to sync_row()
+    class row {
+        cell const * m_begin;
+        cell const * m_end;
+    public:
+        row(cell const * b, cell const * e): m_begin(b), m_end(e) {}
+        cell const * begin() const { return m_begin; }
+        cell const * end() const { return m_end; }
+        unsigned size() const { return static_cast<unsigned>(m_end - m_begin); }
+        cell const & operator[](unsigned k) const { return m_begin[k]; }
+    };
+
+private:
+    struct row_info {
+        unsigned m_start { 0 };
+        unsigned m_size { 0 };
+        unsigned m_capacity { 0 };
+        uint64_t m_stamp { 0 };
+    };
+
+    vector<cell>     m_cells;
+    vector<row_info> m_rows;
+    unsigned         m_unused { 0 };      // cells that belong to no row
+    unsigned         m_num_copies { 0 };
+    unsigned         m_num_compactions { 0 };
+
+    static unsigned capacity_for(unsigned sz) { return sz + sz / 4 + 2; }
+
+    template <typename X>
+    void copy_row(static_matrix<T, X> const & A, unsigned i) {
+        row_info & r = m_rows[i];
+        auto const & src = A.m_rows[i];
+        unsigned sz = src.size();
+        if (sz > r.m_capacity) {
+            m_unused += r.m_capacity;
+            r.m_start = m_cells.size();
+            r.m_capacity = capacity_for(sz);
+            m_cells.resize(r.m_start + r.m_capacity);
+        }
+        for (unsigned k = 0; k < sz; k++)
+            m_cells[r.m_start + k].set(src[k].var(), src[k].coeff());
+        r.m_size = sz;
+        r.m_stamp = A.row_stamp(i);
+        ++m_num_copies;
+    }
+
+    void compact() {
+        vector<cell> cells;
+        unsigned sz = 0;
+        for (row_info const & r : m_rows)
+            sz += capacity_for(r.m_size);
+        cells.resize(sz);
+        unsigned start = 0;
+        for (row_info & r : m_rows) {
+            for (unsigned k = 0; k < r.m_size; k++)
+                cells[start + k] = m_cells[r.m_start + k];
+            r.m_start = start;
+            r.m_capacity = capacity_for(r.m_size);
+            start += r.m_capacity;
+        }
+        m_cells.swap(cells);
+        m_unused = 0;
+        ++m_num_compactions;
+    }
+
+public:
+
+    // copies row i of A when it changed since it was last copied
+    template <typename X>
+    void sync_row(static_matrix<T, X> const & A, unsigned i) {
+        unsigned m = A.row_count();
+        if (m_rows.size() > m) {
+            // the rows were popped
+            for (unsigned k = m; k < m_rows.size(); k++)
+                m_unused += m_rows[k].m_capacity;
+            m_rows.shrink(m);
+        }
+        else if (m_rows.size() < m)
+            m_rows.resize(m);
+        row_info & r = m_rows[i];
+        // a row that was popped and added again without cells keeps the stamp, the size tells it apart
+        if (r.m_stamp != A.row_stamp(i) || r.m_size != A.m_rows[i].size()) {
+            copy_row(A, i);
+            if (m_unused > 1024 && 2 * m_unused > m_cells.size())
+                compact();
+        }
+    }
+
+    // the copy of row i, it does not change until the next call to sync_row(),
+    // so the rows can be read concurrently
+    row get_row(unsigned i) const {
+        cell const * b = m_cells.data() + m_rows[i].m_start;
+        return row(b, b + m_rows[i].m_size);
+    }
+
+    template <typename X>
+    row get_row(static_matrix<T, X> const & A, unsigned i) {
+        sync_row(A, i);
+        return get_row(i);
+    }
+
+    void reset() {
+        m_cells.reset();
+        m_rows.reset();
+        m_unused = 0;
+    }
+
+    unsigned num_copies() const { return m_num_copies; }
+    unsigned num_compactions() const { return m_num_compactions; }
+    unsigned num_cells() const { return m_cells.size(); }
+};
+
+}
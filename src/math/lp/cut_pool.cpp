@@ -0,0 +1,329 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    cut_pool.cpp
+
+Abstract:
+
+    A pool of cuts for int_solver.
+
+--*/
+#include <algorithm>
+#include <cmath>
+#include "math/lp/cut_pool.h"
+#include "math/lp/int_solver.h"
+#include "math/lp/lar_solver.h"
+
+namespace lp {
+
+cut_pool::cut_pool(int_solver& lia): lia(lia), lra(lia.lra), m_gomory(lia) {}
+
+bool cut_pool::is_usable(cut const& c) const {
+    // the constraints of a cut found in another branch may be retracted
+    for (unsigned ci : c.m_ex)
+        if (!lra.constraints().valid_index(ci) || !lra.constraints().is_active(ci))
+            return false;
+    return true;
+}
+
+double cut_pool::efficacy(cut const& c) const {
+    impq v;
+    for (lar_term::ival p : c.m_t)
+        v += p.coeff() * lia.get_value(p.column().index());
+    impq violation = c.m_upper ? v - impq(c.m_k) : impq(c.m_k) - v;
+    if (!violation.x.is_pos())
+        return 0;
+    return violation.x.get_double() / c.m_norm;
+}
+
+double cut_pool::norm(lar_term const& t) {
+    double r = 0;
+    for (lar_term::ival p : t) {
+        double a = p.coeff().get_double();
+        r += a * a;
+    }
+    return std::sqrt(r);
+}
+
+// the cosine of the angle between the normals of the cuts written as t >= k
+double cut_pool::parallelism(cut const& a, cut const& b) {
+    cut const& s = a.m_t.size() <= b.m_t.size() ? a : b;
+    cut const& l = a.m_t.size() <= b.m_t.size() ? b : a;
+    auto const& coeffs = l.m_t.coeffs<u_map<mpq>>();
+    double dot = 0;
+    for (lar_term::ival p : s.m_t) {
+        auto* e = coeffs.find_core(p.column().index());
+        if (e)
+            dot += p.coeff().get_double() * e->get_data().m_value.get_double();
+    }
+    if (a.m_upper != b.m_upper)
+        dot = -dot;
+    return dot / (a.m_norm * b.m_norm);
+}
+
+bool cut_pool::is_binary(unsigned j) const {
+    return lia.column_is_int(j) && lia.is_boxed(j) &&
+        lia.lower_bound(j) == impq(0) && lia.upper_bound(j) == impq(1);
+}
+
+void cut_pool::age_cuts() {
+    unsigned max_age = lia.settings().cut_pool_max_age();
+    unsigned k = 0;
+    for (unsigned i = 0; i < m_cuts.size(); i++) {
+        cut& c = m_cuts[i];
+        c.m_efficacy = is_usable(c) ? efficacy(c) : 0;
+        if (c.m_efficacy >= min_efficacy)
+            c.m_age = 0;
+        else if (++c.m_age > max_age) {
+            lia.settings().stats().m_cut_pool_aged++;
+            continue;
+        }
+        if (i != k)
+            m_cuts[k] = c;
+        k++;
+    }
+    m_cuts.shrink(k);
+}
+
+void cut_pool::add_candidate(cut& c) {
+    c.m_norm = norm(c.m_t);
+    if (c.m_norm == 0)
+        return;
+    c.m_efficacy = efficacy(c);
+    c.m_round = m_round;
+    lia.settings().stats().m_cut_pool_candidates++;
+    m_candidates.push_back(c);
+}
+
+void cut_pool::add_gomory_candidates(unsigned j, row_strip<mpq> const& row) {
+    for (unsigned m = 1; m <= max_mir_multiplier; m++) {
+        mpq mult(m);
+        if (fractional_part(mult * lia.get_value(j).x).is_zero())
+            continue;
+        cut c;
+        explanation ex;
+        lia_move r = m_gomory.cut(c.m_t, c.m_k, &ex, j, row, mult);
+        if (r == lia_move::conflict) {
+            m_conflict = true;
+            m_conflict_ex.reset();
+            for (auto ev : ex)
+                m_conflict_ex.push_back(ev.ci());
+            return;
+        }
+        if (r != lia_move::cut)
+            continue;
+        c.m_upper = false;
+        c.m_kind = m == 1 ? cut_kind::gomory : cut_kind::mir;
+        for (auto ev : ex)
+            c.m_ex.push_back(ev.ci());
+        add_candidate(c);
+    }
+}
+
+/**
+   The row is sum_i c_i x_i = 0. When all its columns, except at most one column s,
+   are binary or fixed, and s is bounded from the right side, then the row gives the knapsack
+   sum_i a_i y_i <= b over the binary columns, where y_i is x_i when c_i is positive,
+   and 1 - x_i otherwise, and a_i = |c_i|. A cover C is a set of items with
+   sum_{i in C} a_i > b, it gives the cut sum_{i in C} y_i <= |C| - 1.
+   The cover is built greedily from the items with the largest values.
+*/
+void cut_pool::add_cover_candidate(row_strip<mpq> const& row) {
+    unsigned s = UINT_MAX;
+    mpq c_s, b(0);
+    cut c;
+    vector<knapsack_item> items;
+    for (auto const& p : row) {
+        unsigned j = p.var();
+        if (lia.is_fixed(j)) {
+            b -= p.coeff() * lia.lower_bound(j).x;
+            c.m_ex.push_back(lia.column_lower_bound_constraint(j));
+            c.m_ex.push_back(lia.column_upper_bound_constraint(j));
+        }
+        else if (is_binary(j)) {
+            mpq const& x = lia.get_value(j).x;
+            if (p.coeff().is_pos())
+                items.push_back({ j, p.coeff(), false, x });
+            else {
+                items.push_back({ j, -p.coeff(), true, 1 - x });
+                b -= p.coeff();
+            }
+            c.m_ex.push_back(lia.column_lower_bound_constraint(j));
+            c.m_ex.push_back(lia.column_upper_bound_constraint(j));
+        }
+        else if (s != UINT_MAX)
+            return;
+        else {
+            s = j;
+            c_s = p.coeff();
+        }
+    }
+    if (s != UINT_MAX) {
+        if (c_s.is_pos()) {
+            if (!lia.has_lower(s))
+                return;
+            b -= c_s * lia.lower_bound(s).x;
+            c.m_ex.push_back(lia.column_lower_bound_constraint(s));
+        }
+        else {
+            if (!lia.has_upper(s))
+                return;
+            b -= c_s * lia.upper_bound(s).x;
+            c.m_ex.push_back(lia.column_upper_bound_constraint(s));
+        }
+    }
+    if (b.is_neg() || items.empty())
+        return;
+    std::sort(items.begin(), items.end(), [](knapsack_item const& x, knapsack_item const& y) {
+        return x.m_value > y.m_value || (x.m_value == y.m_value && x.m_a > y.m_a);
+    });
+    mpq sum(0);
+    unsigned n = 0;
+    for (; n < items.size() && sum <= b; n++)
+        sum += items[n].m_a;
+    if (sum <= b)
+        return;
+    // drop the items of least value that are not needed for the cover
+    bool_vector in_cover(n, true);
+    for (unsigned i = n; i-- > 0; ) {
+        if (sum - items[i].m_a > b) {
+            sum -= items[i].m_a;
+            in_cover[i] = false;
+        }
+    }
+    mpq value(0);
+    unsigned size = 0, num_complemented = 0;
+    for (unsigned i = 0; i < n; i++) {
+        if (!in_cover[i])
+            continue;
+        value += items[i].m_value;
+        size++;
+        if (items[i].m_complemented) {
+            num_complemented++;
+            c.m_t.add_monomial(mpq(-1), items[i].m_j);
+        }
+        else
+            c.m_t.add_monomial(mpq(1), items[i].m_j);
+    }
+    if (value <= mpq(size - 1))
+        return;
+    c.m_k = mpq(size - 1) - mpq(num_complemented);
+    c.m_upper = true;
+    c.m_kind = cut_kind::cover;
+    TRACE("cut_pool", lra.print_term(c.m_t, tout << "cover cut: ") << " <= " << c.m_k << "\n";);
+    add_candidate(c);
+}
+
+void cut_pool::generate_candidates() {
+    m_conflict = false;
+    // the short rows are tried first, they give sparse cuts
+    vector<std::pair<unsigned, unsigned>> rows;
+    for (unsigned j : lra.r_basis()) {
+        if (!lia.column_is_int_inf(j))
+            continue;
+        auto const& row = lra.get_row(lia.row_of_basic_column(j));
+        if (m_gomory.is_gomory_cut_target(row))
+            rows.push_back(std::make_pair(row.size(), j));
+    }
+    std::sort(rows.begin(), rows.end());
+    for (unsigned k = 0; k < rows.size() && k < max_rows_per_round && !m_conflict; k++) {
+        unsigned j = rows[k].second;
+        auto const& row = lra.get_row(lia.row_of_basic_column(j));
+        add_gomory_candidates(j, row);
+        if (!m_conflict)
+            add_cover_candidate(row);
+    }
+}
+
+void cut_pool::select_candidates() {
+    auto& st = lia.settings().stats();
+    double max_parallelism = lia.settings().cut_pool_max_parallelism();
+    unsigned_vector order;
+    for (unsigned i = 0; i < m_candidates.size(); i++)
+        order.push_back(i);
+    std::stable_sort(order.begin(), order.end(), [&](unsigned i, unsigned j) {
+        return m_candidates[i].m_efficacy > m_candidates[j].m_efficacy;
+    });
+    unsigned num_selected = 0;
+    for (unsigned i : order) {
+        cut const& c = m_candidates[i];
+        if (c.m_efficacy < min_efficacy || num_selected == max_cuts_per_round || m_cuts.size() >= max_pool_size)
+            break;
+        bool is_parallel = false;
+        for (cut const& d : m_cuts) {
+            if (parallelism(c, d) > max_parallelism) {
+                is_parallel = true;
+                break;
+            }
+        }
+        if (is_parallel) {
+            st.m_cut_pool_parallel++;
+            continue;
+        }
+        switch (c.m_kind) {
+        case cut_kind::gomory: st.m_cut_pool_gomory_cuts++; break;
+        case cut_kind::mir: st.m_cut_pool_mir_cuts++; break;
+        case cut_kind::cover: st.m_cut_pool_cover_cuts++; break;
+        }
+        m_cuts.push_back(c);
+        num_selected++;
+    }
+    m_candidates.reset();
+}
+
+lia_move cut_pool::add_best_cut() {
+    cut* best = nullptr;
+    for (cut& c : m_cuts)
+        if (c.m_efficacy >= min_efficacy && (!best || c.m_efficacy > best->m_efficacy))
+            best = &c;
+    if (!best)
+        return lia_move::undef;
+    if (best->m_round != m_round)
+        lia.settings().stats().m_cut_pool_reused++;
+    lia.m_t = best->m_t;
+    lia.m_k = best->m_k;
+    lia.m_upper = best->m_upper;
+    for (unsigned ci : best->m_ex)
+        lia.m_ex->push_back(ci);
+    TRACE("cut_pool", lra.print_term(lia.m_t, tout << "cut: ") << (lia.m_upper ? " <= " : " >= ") << lia.m_k
+          << " efficacy: " << best->m_efficacy << " pool size: " << m_cuts.size() << "\n";);
+    SASSERT(lia.current_solution_is_inf_on_cut());
+    return lia_move::cut;
+}
+
+lia_move cut_pool::operator()() {
+    m_round++;
+    lia.settings().stats().m_cut_pool_rounds++;
+    lra.move_non_basic_columns_to_bounds(true);
+    age_cuts();
+    generate_candidates();
+    if (m_conflict) {
+        for (unsigned ci : m_conflict_ex)
+            lia.m_ex->push_back(ci);
+        return lia_move::conflict;
+    }
+    select_candidates();
+    return add_best_cut();
+}
+
+void cut_pool::shrink(unsigned num_columns, unsigned num_constraints) {
+    unsigned k = 0;
+    for (unsigned i = 0; i < m_cuts.size(); i++) {
+        cut const& c = m_cuts[i];
+        bool is_valid = true;
+        for (unsigned ci : c.m_ex)
+            is_valid &= ci < num_constraints;
+        for (lar_term::ival p : c.m_t)
+            is_valid &= p.column().index() < num_columns;
+        if (!is_valid)
+            continue;
+        if (i != k)
+            m_cuts[k] = c;
+        k++;
+    }
+    m_cuts.shrink(k);
+}
+
+}
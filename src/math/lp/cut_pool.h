@@ -0,0 +1,94 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    cut_pool.h
+
+Abstract:
+
+    A pool of cuts for int_solver.
+
+    A cut round generates candidate cuts from the rows of the integer
+    infeasible basic columns: the Gomory cut of the row, the mixed integer
+    rounding cuts of the row multiplied by small integers, and a knapsack
+    cover cut when the row is a knapsack over binary columns. The
+    candidates are ranked by efficacy, the violation of the cut divided by
+    its Euclidean norm, and a candidate is kept in the pool unless it is
+    almost parallel to a cut that is already there.
+
+    A round returns the most efficacious violated cut of the pool, so cuts
+    found in one branch are reused in the other branches. A cut that is not
+    violated ages and is removed after max_age rounds. A cut is removed at
+    once when the lar_solver pops a column or a constraint that it uses.
+
+--*/
+#pragma once
+
+#include "math/lp/lar_term.h"
+#include "math/lp/lia_move.h"
+#include "math/lp/explanation.h"
+#include "math/lp/static_matrix.h"
+#include "math/lp/gomory.h"
+
+namespace lp {
+    class int_solver;
+    class lar_solver;
+    class cut_pool {
+        enum class cut_kind { gomory, mir, cover };
+
+        struct cut {
+            lar_term        m_t;
+            mpq             m_k;
+            bool            m_upper { false };  // the cut is m_t <= m_k if m_upper, and m_t >= m_k otherwise
+            unsigned_vector m_ex;               // the constraints that imply the cut
+            cut_kind        m_kind { cut_kind::gomory };
+            double          m_norm { 0 };
+            double          m_efficacy { 0 };   // zero when the cut is not violated
+            unsigned        m_age { 0 };
+            unsigned        m_round { 0 };      // the round that created the cut
+        };
+
+        struct knapsack_item {
+            unsigned m_j;
+            mpq      m_a;            // positive
+            bool     m_complemented; // the item is 1 - x_j
+            mpq      m_value;
+        };
+
+        class int_solver& lia;
+        class lar_solver& lra;
+        gomory            m_gomory;
+        vector<cut>       m_cuts;
+        vector<cut>       m_candidates;
+        unsigned          m_round { 0 };
+        bool              m_conflict { false };
+        unsigned_vector   m_conflict_ex;
+
+        static const unsigned max_rows_per_round = 32;
+        static const unsigned max_mir_multiplier = 3;
+        static const unsigned max_cuts_per_round = 8;
+        static const unsigned max_pool_size = 256;
+        static constexpr double min_efficacy = 1e-6;
+
+        bool is_usable(cut const& c) const;
+        double efficacy(cut const& c) const;
+        static double norm(lar_term const& t);
+        static double parallelism(cut const& a, cut const& b);
+        bool is_binary(unsigned j) const;
+
+        void age_cuts();
+        void generate_candidates();
+        void add_gomory_candidates(unsigned j, row_strip<mpq> const& row);
+        void add_cover_candidate(row_strip<mpq> const& row);
+        void add_candidate(cut& c);
+        void select_candidates();
+        lia_move add_best_cut();
+
+    public:
+        cut_pool(int_solver& lia);
+        lia_move operator()();
+        void shrink(unsigned num_columns, unsigned num_constraints);
+        unsigned size() const { return m_cuts.size(); }
+    };
+}
@@ -32,6 +32,7 @@ class create_cut {
     unsigned              m_inf_col; // a basis column which has to be an integer but has a non integral value
     const row_strip<mpq>& m_row;
     const int_solver&     lia;
+    mpq                   m_mult; // the cut is created from the row multiplied by m_mult
     mpq                   m_lcm_den;
     mpq                   m_f;
     mpq                   m_one_minus_f;
@@ -287,15 +288,15 @@ public:
         m_t.clear();
         mpq m_lcm_den(1);
         bool some_int_columns = false;
-        mpq m_f  = fractional_part(get_value(m_inf_col));
+        mpq m_f  = fractional_part(m_mult * get_value(m_inf_col).x);
         TRACE("gomory_cut_detail", tout << "m_f: " << m_f << ", ";
-              tout << "1 - m_f: " << 1 - m_f << ", get_value(m_inf_col).x - m_f = " << get_value(m_inf_col).x - m_f << "\n";);
-        lp_assert(m_f.is_pos() && (get_value(m_inf_col).x - m_f).is_int());  
+              tout << "1 - m_f: " << 1 - m_f << ", m_mult * get_value(m_inf_col).x - m_f = " << m_mult * get_value(m_inf_col).x - m_f << "\n";);
+        lp_assert(m_f.is_pos() && (m_mult * get_value(m_inf_col).x - m_f).is_int());  
 
 #if SMALL_CUTS
         m_abs_max = 0;
         for (const auto & p : m_row) {
-            mpq t = abs(ceil(p.coeff()));
+            mpq t = abs(ceil(m_mult * p.coeff()));
             if (t > m_abs_max)
                 m_abs_max = t;
         }
@@ -317,11 +318,12 @@ public:
                     m_ex->push_back(column_upper_bound_constraint(j));
                     continue;
                 }
+                mpq a = m_mult * p.coeff();
                 if (is_real(j))   
-                    real_case_in_gomory_cut(- p.coeff(), j);
-                else if (!p.coeff().is_int()) {
+                    real_case_in_gomory_cut(- a, j);
+                else if (!a.is_int()) {
                     some_int_columns = true;
-                    m_fj = fractional_part(-p.coeff());
+                    m_fj = fractional_part(-a);
                     m_one_minus_fj = 1 - m_fj;
                     int_case_in_gomory_cut(j);
                 }
@@ -338,26 +340,27 @@ public:
         if (some_int_columns)
             adjust_term_and_k_for_some_ints_case_gomory();
         TRACE("gomory_cut_detail", dump_cut_and_constraints_as_smt_lemma(tout););
-        lp_assert(lia.current_solution_is_inf_on_cut());  // checks that indices are columns
+        lp_assert(lia.current_solution_is_inf_on_cut(m_t, m_k, false));  // checks that indices are columns
         TRACE("gomory_cut", print_linear_combination_of_column_indices_only(m_t.coeffs_as_vector(), tout << "gomory cut:"); tout << " <= " << m_k << std::endl;);
         return lia_move::cut;
     }
 
-    create_cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row, const int_solver& lia) :
+    create_cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row, const int_solver& lia, mpq const& mult) :
         m_t(t),
         m_k(k),
         m_ex(ex),
         m_inf_col(basic_inf_int_j),
         m_row(row),
         lia(lia),
+        m_mult(mult),
         m_lcm_den(1),
-        m_f(fractional_part(get_value(basic_inf_int_j).x)),
+        m_f(fractional_part(mult * get_value(basic_inf_int_j).x)),
         m_one_minus_f(1 - m_f) {}
     
 };
 
-lia_move gomory::cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row) {
-    create_cut cc(t, k, ex, basic_inf_int_j, row, lia);
+lia_move gomory::cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row, mpq const& mult) {
+    create_cut cc(t, k, ex, basic_inf_int_j, row, lia, mult);
     return cc.cut();
 }
 
@@ -410,7 +413,7 @@ lia_move gomory::operator()() {
     SASSERT(lra.row_is_correct(r));
     SASSERT(is_gomory_cut_target(row));
     lia.m_upper = false;
-    return cut(lia.m_t, lia.m_k, lia.m_ex, j, row);
+    return cut(lia.m_t, lia.m_k, lia.m_ex, j, row, mpq(1));
 }
 
 
@@ -28,10 +28,12 @@ namespace lp {
         class int_solver& lia;
         class lar_solver& lra;
         int find_basic_var();
-        bool is_gomory_cut_target(const row_strip<mpq>& row);
-        lia_move cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row);
     public:
         gomory(int_solver& lia);
         lia_move operator()();
+        bool is_gomory_cut_target(const row_strip<mpq>& row);
+        // the cut t >= k from the row of basic_inf_int_j multiplied by mult, a positive integer;
+        // for mult > 1 it is the mixed integer rounding cut of the scaled row
+        lia_move cut(lar_term & t, mpq & k, explanation* ex, unsigned basic_inf_int_j, const row_strip<mpq>& row, mpq const& mult);
     };
 }
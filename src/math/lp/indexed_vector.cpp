@@ -19,6 +19,7 @@ Revision History:
 --*/
 #include "util/vector.h"
 #include "math/lp/indexed_vector_def.h"
+#include "math/lp/small_rational.h"
 namespace lp {
 template void indexed_vector<double>::clear();
 template void indexed_vector<double>::clear_all();
@@ -32,6 +33,11 @@ template void indexed_vector<mpq>::resize(unsigned int);
 template void indexed_vector<unsigned>::resize(unsigned int);
 template void indexed_vector<mpq>::set_value(const mpq&, unsigned int);
 template void indexed_vector<unsigned>::set_value(const unsigned&, unsigned int);
+template void indexed_vector<small_rational>::clear();
+template void indexed_vector<small_rational>::clear_all();
+template void indexed_vector<small_rational>::erase_from_index(unsigned int);
+template void indexed_vector<small_rational>::resize(unsigned int);
+template void indexed_vector<small_rational>::set_value(const small_rational&, unsigned int);
 #ifdef Z3DEBUG
 template bool indexed_vector<unsigned>::is_OK() const;
 template bool indexed_vector<double>::is_OK() const;
@@ -122,7 +122,8 @@ int_solver::int_solver(lar_solver& lar_slv) :
     m_patcher(*this),
     m_number_of_calls(0),
     m_hnf_cutter(*this),
-    m_hnf_cut_period(settings().hnf_cut_period()) {
+    m_hnf_cut_period(settings().hnf_cut_period()),
+    m_cut_pool(*this) {
     lra.set_int_solver(this);
 }
 
@@ -162,7 +163,7 @@ lia_move int_solver::check(lp::explanation * e) {
     if (r == lia_move::undef && m_patcher.should_apply()) r = m_patcher();
     if (r == lia_move::undef && should_find_cube()) r = int_cube(*this)();
     if (r == lia_move::undef && should_hnf_cut()) r = hnf_cut();
-    if (r == lia_move::undef && should_gomory_cut()) r = gomory(*this)();
+    if (r == lia_move::undef && should_gomory_cut()) r = settings().cut_pool() ? m_cut_pool() : gomory(*this)();
     if (r == lia_move::undef) r = int_branch(*this)();
     return r;
 }
@@ -189,7 +190,11 @@ std::ostream& int_solver::display_inf_rows(std::ostream& out) const {
 }
 
 bool int_solver::cut_indices_are_columns() const {
-    for (lar_term::ival p : m_t) {
+    return cut_indices_are_columns(m_t);
+}
+
+bool int_solver::cut_indices_are_columns(lar_term const& t) const {
+    for (lar_term::ival p : t) {
         if (p.column().index() >= lra.A_r().column_count())
             return false;
     }
@@ -197,15 +202,19 @@ bool int_solver::cut_indices_are_columns() const {
 }
 
 bool int_solver::current_solution_is_inf_on_cut() const {
-    SASSERT(cut_indices_are_columns());
+    return current_solution_is_inf_on_cut(m_t, m_k, m_upper);
+}
+
+bool int_solver::current_solution_is_inf_on_cut(lar_term const& t, mpq const& k, bool upper) const {
+    SASSERT(cut_indices_are_columns(t));
     const auto & x = lrac.m_r_x;
-    impq v = m_t.apply(x);
-    mpq sign = m_upper ? one_of_type<mpq>()  : -one_of_type<mpq>();
-    CTRACE("current_solution_is_inf_on_cut", v * sign <= impq(m_k) * sign,
-           tout << "m_upper = " << m_upper << std::endl;
-           tout << "v = " << v << ", k = " << m_k << std::endl;
+    impq v = t.apply(x);
+    mpq sign = upper ? one_of_type<mpq>()  : -one_of_type<mpq>();
+    CTRACE("current_solution_is_inf_on_cut", v * sign <= impq(k) * sign,
+           tout << "upper = " << upper << std::endl;
+           tout << "v = " << v << ", k = " << k << std::endl;
           );
-    return v * sign > impq(m_k) * sign;
+    return v * sign > impq(k) * sign;
 }
 
 bool int_solver::has_inf_int() const {
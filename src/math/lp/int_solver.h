@@ -27,6 +27,7 @@ Revision History:
 #include "math/lp/int_gcd_test.h"
 #include "math/lp/lia_move.h"
 #include "math/lp/explanation.h"
+#include "math/lp/cut_pool.h"
 
 namespace lp {
 class lar_solver;
@@ -39,6 +40,7 @@ class int_solver {
     friend class int_branch;
     friend class int_gcd_test;
     friend class hnf_cutter;
+    friend class cut_pool;
 
     class patcher {
         int_solver&         lia;
@@ -68,6 +70,7 @@ class int_solver {
     bool                m_upper;           // we have a cut m_t*x <= k if m_upper is true nad m_t*x >= k otherwise
     hnf_cutter          m_hnf_cutter;
     unsigned            m_hnf_cut_period;
+    cut_pool            m_cut_pool;
 public:
     int_solver(lar_solver& lp);
     
@@ -108,12 +111,14 @@ private:
     unsigned row_of_basic_column(unsigned j) const;
     bool non_basic_columns_are_at_bounds() const;
     bool cut_indices_are_columns() const;
+    bool cut_indices_are_columns(lar_term const& t) const;
     
 public:
     std::ostream& display_column(std::ostream & out, unsigned j) const;
     constraint_index column_upper_bound_constraint(unsigned j) const;
     constraint_index column_lower_bound_constraint(unsigned j) const;
     bool current_solution_is_inf_on_cut() const;
+    bool current_solution_is_inf_on_cut(lar_term const& t, mpq const& k, bool upper) const;
 
     bool shift_var(unsigned j, unsigned range);
     std::ostream&  display_row_info(std::ostream & out, unsigned row_index) const;
@@ -129,5 +134,7 @@ public:
     void find_feasible_solution();
     lia_move hnf_cut();
     void patch_nbasic_column(unsigned j) { m_patcher.patch_nbasic_column(j); }
+    // the lar_solver popped the columns from num_columns and the constraints from num_constraints on
+    void shrink_cut_pool(unsigned num_columns, unsigned num_constraints) { m_cut_pool.shrink(num_columns, num_constraints); }
   };
 }
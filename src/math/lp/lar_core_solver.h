@@ -18,6 +18,7 @@ Author:
 #include "math/lp/stacked_vector.h"
 #include "math/lp/lar_solution_signature.h"
 #include "util/stacked_value.h"
+#include "math/lp/u_set.h"
 namespace lp {
 
 class lar_core_solver  {
@@ -55,6 +56,17 @@ public:
     vector<unsigned> m_d_nbasis;
     vector<int> m_d_heading;
 
+    // f - a shadow of the tableau in doubles, used by solve_float_first().
+    // A row of m_f_A is copied again only when the row stamp of m_r_A moved,
+    // so adding, popping and pivoting rows of m_r_A reaches the shadow row by row.
+    static_matrix<double, double> m_f_A;
+    vector<uint64_t> m_f_row_stamps; // the stamp of the row of m_r_A that the row of m_f_A copies
+    vector<double>   m_f_x;
+    vector<double>   m_f_lower_bounds;
+    vector<double>   m_f_upper_bounds;
+    vector<unsigned> m_f_basis;
+    vector<int>      m_f_heading; // the row of a basic column, -1 for a non-basic column
+    u_set            m_f_inf_set;
 
     lp_primal_core_solver<mpq, numeric_pair<mpq>> m_r_solver; // solver in rational numbers
 
@@ -128,6 +140,56 @@ public:
 
     void solve();
 
+    // Pivots on the copy of the tableau in doubles towards a feasible basis,
+    // then replays the basis changes in the rational tableau and lets the
+    // rational solver repair the solution.
+    void solve_float_first();
+
+    bool init_float_tableau(double delta);
+
+    bool sync_float_tableau();
+
+    bool copy_row_to_float_tableau(unsigned i);
+
+    void remove_float_row_cells(unsigned i);
+
+    void invalidate_float_row(unsigned i) { m_f_row_stamps[i] = UINT64_MAX; }
+
+    unsigned float_leaving_candidate() const;
+
+    bool find_basis_with_floats(vector<unsigned> & changes_of_basis);
+
+    bool pivot_float_column(unsigned j, unsigned row);
+
+    void drop_small_float_cells(unsigned i);
+
+    double float_tolerance(double bound) const {
+        return settings().primal_feasibility_tolerance * std::max(1.0, std::abs(bound));
+    }
+
+    bool float_column_is_below_lower_bound(unsigned j) const {
+        return lower_bound_is_set(j) && m_f_x[j] < m_f_lower_bounds[j] - float_tolerance(m_f_lower_bounds[j]);
+    }
+
+    bool float_column_is_above_upper_bound(unsigned j) const {
+        return upper_bound_is_set(j) && m_f_x[j] > m_f_upper_bounds[j] + float_tolerance(m_f_upper_bounds[j]);
+    }
+
+    bool float_column_can_increase(unsigned j) const {
+        return !upper_bound_is_set(j) || m_f_x[j] < m_f_upper_bounds[j] - float_tolerance(m_f_upper_bounds[j]);
+    }
+
+    bool float_column_can_decrease(unsigned j) const {
+        return !lower_bound_is_set(j) || m_f_x[j] > m_f_lower_bounds[j] + float_tolerance(m_f_lower_bounds[j]);
+    }
+
+    void update_float_inf_set(unsigned j) {
+        if (float_column_is_below_lower_bound(j) || float_column_is_above_upper_bound(j))
+            m_f_inf_set.insert(j);
+        else
+            m_f_inf_set.erase(j);
+    }
+
     bool lower_bounds_are_set() const { return true; }
 
     const indexed_vector<mpq> & get_pivot_row() const {
@@ -750,6 +812,31 @@ public:
         return delta;
     }
 
+    // Strict one-sided bounds do not constrain delta against another bound.
+    // The delta keeps their shift below half of the bound magnitude, or of one.
+    mpq find_delta_for_strict_one_sided_bounds(const mpq & initial_delta) const {
+        mpq delta = initial_delta;
+        auto update = [&](numeric_pair<mpq> const& b) {
+            if (b.y.is_zero())
+                return;
+            mpq delta1 = std::max(abs(b.x), numeric_traits<mpq>::one()) / (2 * abs(b.y));
+            if (delta1 < delta)
+                delta = delta1;
+        };
+        for (unsigned j = 0; j < m_r_A.column_count(); j++) {
+            switch (m_column_types()[j]) {
+            case column_type::lower_bound:
+                update(m_r_lower_bounds[j]);
+                break;
+            case column_type::upper_bound:
+                update(m_r_upper_bounds[j]);
+                break;
+            default:
+                break;
+            }
+        }
+        return delta;
+    }
     
     mpq find_delta_for_strict_bounds(const mpq & initial_delta) const{
         mpq delta = initial_delta;
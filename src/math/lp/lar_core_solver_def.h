@@ -174,8 +174,12 @@ void lar_core_solver::solve() {
             if (snapped)
                 m_r_solver.solve_Ax_eq_b();
         }
-        if (m_r_solver.m_look_for_feasible_solution_only) //todo : should it be set?
-            m_r_solver.find_feasible_solution();
+        if (m_r_solver.m_look_for_feasible_solution_only) { //todo : should it be set?
+            if (settings().float_first() && settings().use_tableau())
+                solve_float_first();
+            else
+                m_r_solver.find_feasible_solution();
+        }
         else {
             m_r_solver.solve();
         }
@@ -200,6 +204,277 @@ void lar_core_solver::solve() {
     TRACE("lar_solver", tout << m_r_solver.get_status() << "\n";);
 }
 
+void lar_core_solver::solve_float_first() {
+    auto & st = settings().stats();
+    ++st.m_float_first_calls;
+    // m_r_x is infeasible here, so the delta depends on the bounds only
+    mpq delta = find_delta_for_strict_one_sided_bounds(find_delta_for_strict_boxed_bounds());
+    vector<unsigned> changes_of_basis;
+    if (!init_float_tableau(std::min(delta.get_double(), 0.000001)) ||
+        !find_basis_with_floats(changes_of_basis)) {
+        TRACE("lar_solver", tout << "float first failed after " << changes_of_basis.size() / 2 << " pivots\n";);
+        ++st.m_float_first_failures;
+        m_r_solver.find_feasible_solution();
+        return;
+    }
+    st.m_float_first_pivots += changes_of_basis.size() / 2;
+    // a failed rational pivot leaves a valid basis, the rational solver starts from it
+    catch_up_in_lu_tableau(changes_of_basis, m_f_heading);
+    lar_solution_signature signature;
+    for (unsigned k = 1; k < changes_of_basis.size(); k += 2) {
+        unsigned j = changes_of_basis[k];
+        if (m_f_heading[j] >= 0 || m_r_heading[j] >= 0)
+            continue;
+        if (m_column_types[j] == column_type::fixed)
+            signature[j] = at_fixed;
+        else if (lower_bound_is_set(j) && m_f_x[j] == m_f_lower_bounds[j])
+            signature[j] = at_lower_bound;
+        else if (upper_bound_is_set(j) && m_f_x[j] == m_f_upper_bounds[j])
+            signature[j] = at_upper_bound;
+    }
+    prepare_solver_x_with_signature_tableau(signature);
+    TRACE("lar_solver", tout << "float first pivots = " << changes_of_basis.size() / 2 << ", infeasibles = " << m_r_solver.inf_set_size() << "\n";);
+    if (m_r_solver.current_x_is_feasible()) {
+        m_r_solver.find_feasible_solution();
+        return;
+    }
+    ++st.m_float_first_repairs;
+    unsigned iterations = m_r_solver.total_iterations();
+    m_r_solver.find_feasible_solution();
+    st.m_float_first_repair_pivots += m_r_solver.total_iterations() - iterations;
+}
+
+// Brings the shadow tableau up to date with the rational tableau and copies the solution
+// and the bounds to doubles. Strict bounds are replaced by delta-close non-strict bounds.
+bool lar_core_solver::init_float_tableau(double delta) {
+    if (!sync_float_tableau())
+        return false;
+    unsigned m = m_r_A.row_count(), n = m_r_A.column_count();
+    auto to_double = [&](numeric_pair<mpq> const & v) { return v.x.get_double() + delta * v.y.get_double(); };
+    m_f_x.resize(n);
+    m_f_lower_bounds.resize(n);
+    m_f_upper_bounds.resize(n);
+    for (unsigned j = 0; j < n; j++) {
+        m_f_x[j] = to_double(m_r_x[j]);
+        if (lower_bound_is_set(j))
+            m_f_lower_bounds[j] = to_double(m_r_solver.m_lower_bounds[j]);
+        if (upper_bound_is_set(j))
+            m_f_upper_bounds[j] = to_double(m_r_solver.m_upper_bounds[j]);
+    }
+    m_f_basis = m_r_basis;
+    m_f_heading.clear();
+    m_f_heading.resize(n, -1);
+    m_f_inf_set.clear();
+    m_f_inf_set.resize(n);
+    for (unsigned i = 0; i < m; i++) {
+        unsigned j = m_f_basis[i];
+        m_f_heading[j] = i;
+        update_float_inf_set(j);
+    }
+    return true;
+}
+
+// Drops the rows and the columns that were popped from the rational tableau,
+// adds the new ones, and copies the rows whose stamp moved since they were copied.
+bool lar_core_solver::sync_float_tableau() {
+    unsigned m = m_r_A.row_count(), n = m_r_A.column_count();
+    while (m_f_A.row_count() > m) {
+        remove_float_row_cells(m_f_A.row_count() - 1);
+        m_f_A.m_rows.pop_back();
+    }
+    m_f_row_stamps.shrink(m_f_A.row_count());
+    while (m_f_A.column_count() > n) {
+        auto & column = m_f_A.m_columns.back();
+        while (!column.empty()) {
+            auto const & c = column.back();
+            auto & row = m_f_A.m_rows[c.var()];
+            invalidate_float_row(c.var());
+            m_f_A.remove_element(row, row[c.offset()]);
+        }
+        m_f_A.m_columns.pop_back();
+        m_f_A.m_vector_of_row_offsets.pop_back();
+    }
+    while (m_f_A.column_count() < n)
+        m_f_A.add_column();
+    while (m_f_A.row_count() < m) {
+        m_f_A.add_row();
+        m_f_row_stamps.push_back(UINT64_MAX);
+    }
+    for (unsigned i = 0; i < m; i++) {
+        // a row that was popped and added again without cells keeps the stamp, the size tells it apart
+        if ((m_f_row_stamps[i] != m_r_A.row_stamp(i) || m_f_A.m_rows[i].size() != m_r_A.m_rows[i].size()) &&
+            !copy_row_to_float_tableau(i))
+            return false;
+    }
+    return true;
+}
+
+bool lar_core_solver::copy_row_to_float_tableau(unsigned i) {
+    remove_float_row_cells(i);
+    for (auto const & c : m_r_A.m_rows[i]) {
+        double v = c.coeff().get_double();
+        if (v == 0) // the coefficient is too small for a double, the row is copied again on the next call
+            return false;
+        m_f_A.add_new_element(i, c.var(), v);
+    }
+    m_f_row_stamps[i] = m_r_A.row_stamp(i);
+    ++settings().stats().m_float_first_row_copies;
+    return true;
+}
+
+void lar_core_solver::remove_float_row_cells(unsigned i) {
+    auto & row = m_f_A.m_rows[i];
+    while (!row.empty())
+        m_f_A.remove_element(row, row.back());
+    if (i < m_f_row_stamps.size())
+        invalidate_float_row(i);
+}
+
+// Bland's rule: the infeasible basic column with the smallest index is repaired
+unsigned lar_core_solver::float_leaving_candidate() const {
+    unsigned r = UINT_MAX;
+    for (unsigned j : m_f_inf_set)
+        r = std::min(r, j);
+    return r;
+}
+
+// Bland's rule: the infeasible basic column with the smallest index is moved towards
+// its violated bound by the smallest column of its row that can move in the needed direction.
+// The ratio test stops the step where a feasible basic column, or the entering column itself,
+// reaches a bound. The column that blocks the step leaves the basis, ties going to the smallest column;
+// when the entering column blocks, it just moves to its bound.
+// The basis changes are recorded as pairs (entering, leaving).
+// Returns false when the pivot budget is exhausted or a pivot fails.
+bool lar_core_solver::find_basis_with_floats(vector<unsigned> & changes_of_basis) {
+    unsigned max_pivots = std::max(1000u, 10 * m_f_A.row_count());
+    unsigned pivots = 0;
+    while (!m_f_inf_set.empty()) {
+        if (pivots++ >= max_pivots || settings().get_cancel_flag())
+            return false;
+        unsigned inf_j = float_leaving_candidate();
+        unsigned row = m_f_heading[inf_j];
+        bool increase = float_column_is_below_lower_bound(inf_j);
+        double target = increase ? m_f_lower_bounds[inf_j] : m_f_upper_bounds[inf_j];
+        unsigned entering = UINT_MAX;
+        double a = 0;
+        for (auto const & c : m_f_A.m_rows[row]) {
+            unsigned j = c.var();
+            if (j == inf_j || j > entering || std::abs(c.coeff()) < settings().pivot_epsilon)
+                continue;
+            // the row is x_inf_j + sum a_j x_j = 0
+            bool increase_j = (c.coeff() < 0) == increase;
+            if (increase_j ? float_column_can_increase(j) : float_column_can_decrease(j)) {
+                entering = j;
+                a = c.coeff();
+            }
+        }
+        if (entering == UINT_MAX) // the row is infeasible, the rational solver finds the explanation
+            return true;
+        // the step of x_entering that brings x_inf_j to the target
+        double theta = (m_f_x[inf_j] - target) / a;
+        double sign = theta > 0 ? 1.0 : -1.0;
+        double step = std::abs(theta);
+        unsigned leaving = inf_j;
+        double leaving_value = target;
+        // the entering column may reach its own bound first
+        if (sign > 0 && upper_bound_is_set(entering) && m_f_upper_bounds[entering] - m_f_x[entering] < step) {
+            step = std::max(0.0, m_f_upper_bounds[entering] - m_f_x[entering]);
+            leaving = entering;
+            leaving_value = m_f_upper_bounds[entering];
+        }
+        else if (sign < 0 && lower_bound_is_set(entering) && m_f_x[entering] - m_f_lower_bounds[entering] < step) {
+            step = std::max(0.0, m_f_x[entering] - m_f_lower_bounds[entering]);
+            leaving = entering;
+            leaving_value = m_f_lower_bounds[entering];
+        }
+        for (auto const & cc : m_f_A.m_columns[entering]) {
+            unsigned j = m_f_basis[cc.var()];
+            // a tiny coefficient cannot be pivoted on, the rational solver repairs the small drift of x_j
+            if (j == inf_j || m_f_inf_set.contains(j) || std::abs(m_f_A.get_val(cc)) < settings().pivot_epsilon)
+                continue;
+            // x_j changes by rate * step
+            double rate = - sign * m_f_A.get_val(cc);
+            double limit;
+            if (rate > 0 && upper_bound_is_set(j))
+                limit = (m_f_upper_bounds[j] - m_f_x[j]) / rate;
+            else if (rate < 0 && lower_bound_is_set(j))
+                limit = (m_f_x[j] - m_f_lower_bounds[j]) / -rate;
+            else
+                continue;
+            limit = std::max(0.0, limit);
+            if (limit < step || (limit == step && leaving != entering && j < leaving)) {
+                step = limit;
+                leaving = j;
+                leaving_value = rate > 0 ? m_f_upper_bounds[j] : m_f_lower_bounds[j];
+            }
+        }
+        double delta = sign * step;
+        m_f_x[entering] += delta;
+        for (auto const & cc : m_f_A.m_columns[entering]) {
+            unsigned j = m_f_basis[cc.var()];
+            m_f_x[j] -= m_f_A.get_val(cc) * delta;
+        }
+        // the column that blocked the step stops exactly at its bound
+        m_f_x[leaving] = leaving_value;
+        for (auto const & cc : m_f_A.m_columns[entering])
+            update_float_inf_set(m_f_basis[cc.var()]);
+        if (leaving != entering) {
+            unsigned leaving_row = m_f_heading[leaving];
+            if (!pivot_float_column(entering, leaving_row))
+                return false;
+            m_f_basis[leaving_row] = entering;
+            m_f_heading[entering] = leaving_row;
+            m_f_heading[leaving] = -1;
+            m_f_inf_set.erase(leaving);
+            update_float_inf_set(entering);
+            changes_of_basis.push_back(entering);
+            changes_of_basis.push_back(leaving);
+        }
+    }
+    return true;
+}
+
+// Makes column j the unit column of the row.
+// The rows it changes no longer copy the rational tableau, so they are copied again on the next call.
+bool lar_core_solver::pivot_float_column(unsigned j, unsigned row) {
+    auto & column = m_f_A.m_columns[j];
+    unsigned k = 0;
+    while (k < column.size() && column[k].var() != row)
+        k++;
+    if (k == column.size())
+        return false;
+    auto & pivot_row = m_f_A.m_rows[row];
+    double pivot = pivot_row[column[k].offset()].coeff();
+    if (std::abs(pivot) < settings().pivot_epsilon)
+        return false;
+    for (auto & c : pivot_row)
+        c.coeff() = c.var() == j ? 1.0 : c.coeff() / pivot;
+    invalidate_float_row(row);
+    drop_small_float_cells(row);
+    if (k > 0) {
+        // the cell of the pivot row goes first, the other cells are eliminated from the back
+        std::swap(column[0], column[k]);
+        m_f_A.m_rows[column[0].var()][column[0].offset()].offset() = 0;
+        m_f_A.m_rows[column[k].var()][column[k].offset()].offset() = k;
+    }
+    while (column.size() > 1) {
+        unsigned i = column.back().var();
+        invalidate_float_row(i);
+        if (!m_f_A.pivot_row_to_row_given_cell(row, column.back(), j))
+            return false;
+        drop_small_float_cells(i);
+    }
+    return true;
+}
+
+// Removes the cells of row i that are below the drop tolerance, they are the rounding noise of the pivots.
+void lar_core_solver::drop_small_float_cells(unsigned i) {
+    auto & row = m_f_A.m_rows[i];
+    for (unsigned k = row.size(); k-- > 0; ) {
+        if (std::abs(row[k].coeff()) < settings().drop_tolerance)
+            m_f_A.remove_element(row, row[k]);
+    }
+}
 
 }
 
@@ -31,7 +31,9 @@ namespace lp {
         m_mpq_lar_core_solver(m_settings, *this),
         m_var_register(false),
         m_term_register(true),
-        m_constraints(*this) {}
+        m_constraints(*this) {
+        m_mpq_lar_core_solver.m_r_solver.m_csr_rows = &m_csr_rows;
+    }
 
     void lar_solver::set_track_pivoted_rows(bool v) {
         m_mpq_lar_core_solver.m_r_solver.m_pivoted_rows = v ? (&m_rows_with_changed_bounds) : nullptr;
@@ -291,6 +293,8 @@ namespace lp {
 
 
         m_constraints.pop(k);
+        if (m_int_solver)
+            m_int_solver->shrink_cut_pool(n, m_constraints.size());
         m_term_count.pop(k);
         for (unsigned i = m_term_count; i < m_terms.size(); i++) {
             if (m_need_register_terms)
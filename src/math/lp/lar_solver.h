@@ -38,11 +38,16 @@
 #include "math/lp/stacked_vector.h"
 #include "math/lp/implied_bound.h"
 #include "math/lp/bound_analyzer_on_row.h"
+#include "math/lp/csr_matrix.h"
 #include "math/lp/conversion_helper.h"
 #include "math/lp/int_solver.h"
 #include "math/lp/nra_solver.h"
 #include "math/lp/lp_types.h"
 #include "math/lp/lp_bound_propagator.h"
+#include "util/scoped_ptr_vector.h"
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
 
 namespace lp {
 
@@ -91,6 +96,10 @@ class lar_solver : public column_namer {
     u_set                                               m_columns_with_changed_bounds;
     u_set                                               m_rows_with_changed_bounds;
     unsigned_vector                                     m_row_bounds_to_replay;
+    // the rows scanned by bound propagation and the pivot rows of the simplex when 
+    // settings().csr_rows() is set, or when the bounds are propagated in parallel
+    csr_matrix<mpq>                                     m_csr_rows;
+    static const unsigned                               min_rows_per_bprop_thread = 256;
     
     u_set                                               m_basic_columns_with_changed_cost;
     // these are basic columns with the value changed, so the corresponding row in the tableau
@@ -170,16 +179,32 @@ class lar_solver : public column_namer {
     bool sizes_are_correct() const;
     bool implied_bound_is_correctly_explained(implied_bound const & be, const vector<std::pair<mpq, unsigned>> & explanation) const;
     
+    bool row_is_too_long_or_big_for_bound_propagation(unsigned row_index) const {
+        return A_r().m_rows[row_index].size() > settings().max_row_length_for_bound_propagation
+            || row_has_a_big_num(row_index);
+    }
+
     template <typename T>
     void analyze_new_bounds_on_row_tableau(
         unsigned row_index,
         lp_bound_propagator<T> & bp ) {
         
-        if (A_r().m_rows[row_index].size() > settings().max_row_length_for_bound_propagation
-            || row_has_a_big_num(row_index))
+        if (row_is_too_long_or_big_for_bound_propagation(row_index))
             return;
         lp_assert(use_tableau());
-        
+
+        if (settings().csr_rows()) {
+            auto row = m_csr_rows.get_row(A_r(), row_index);
+            stats().m_csr_row_copies = m_csr_rows.num_copies();
+            stats().m_csr_compactions = m_csr_rows.num_compactions();
+            bound_analyzer_on_row<csr_matrix<mpq>::row, lp_bound_propagator<T>>::analyze_row(row,
+                                                                                            null_ci,
+                                                                                            zero_of_type<numeric_pair<mpq>>(),
+                                                                                            row_index,
+                                                                                            bp
+                                                                                            );
+            return;
+        }
         bound_analyzer_on_row<row_strip<mpq>, lp_bound_propagator<T>>::analyze_row(A_r().m_rows[row_index],
                                                                                    null_ci,
                                                                                    zero_of_type<numeric_pair<mpq>>(),
@@ -381,14 +406,72 @@ public:
     void activate(constraint_index);
     void random_update(unsigned sz, var_index const * vars);
     void mark_rows_for_bound_prop(lpvar j);
+    // The rows are copied to m_csr_rows first. The threads then read only the
+    // copy and the column bounds, each with its own propagator on a contiguous
+    // range of the rows. Merging the bounds in the order of the threads gives
+    // the bounds of the sequential loop.
+    template <typename T>
+    void propagate_bounds_for_touched_rows_in_parallel(lp_bound_propagator<T> & bp, unsigned num_threads) {
+        unsigned_vector rows;
+        for (unsigned i : m_rows_with_changed_bounds) {
+            if (row_is_too_long_or_big_for_bound_propagation(i))
+                continue;
+            m_csr_rows.sync_row(A_r(), i);
+            rows.push_back(i);
+        }
+        stats().m_csr_row_copies = m_csr_rows.num_copies();
+        stats().m_csr_compactions = m_csr_rows.num_compactions();
+        scoped_ptr_vector<lp_bound_propagator<T>> bps;
+        for (unsigned t = 0; t < num_threads; t++)
+            bps.push_back(alloc(lp_bound_propagator<T>, bp.imp()));
+        auto begin = [&](unsigned t) { return static_cast<unsigned>(static_cast<uint64_t>(rows.size()) * t / num_threads); };
+        auto analyze = [&](unsigned t) {
+            for (unsigned k = begin(t); k < begin(t + 1); k++) {
+                if (settings().get_cancel_flag())
+                    return;
+                bound_analyzer_on_row<csr_matrix<mpq>::row, lp_bound_propagator<T>>::analyze_row(m_csr_rows.get_row(rows[k]),
+                                                                                                null_ci,
+                                                                                                zero_of_type<numeric_pair<mpq>>(),
+                                                                                                rows[k],
+                                                                                                *bps[t]);
+            }
+        };
+#ifdef SINGLE_THREAD
+        for (unsigned t = 0; t < num_threads; t++)
+            analyze(t);
+#else
+        vector<std::thread> threads;
+        for (unsigned t = 1; t < num_threads; t++)
+            threads.push_back(std::thread([&, t]() { analyze(t); }));
+        analyze(0);
+        for (auto & th : threads)
+            th.join();
+#endif
+        ++stats().m_bprop_parallel_rounds;
+        for (unsigned t = 0; t < num_threads; t++) {
+            stats().m_bprop_thread_rows[t] += begin(t + 1) - begin(t);
+            stats().m_bprop_thread_bounds[t] += bps[t]->ibounds().size();
+            for (implied_bound const& ib : bps[t]->ibounds())
+                bp.merge(ib);
+        }
+    }
+
     template <typename T>
     void propagate_bounds_for_touched_rows(lp_bound_propagator<T> & bp) {
         SASSERT(use_tableau());
-        for (unsigned i : m_rows_with_changed_bounds) {
-            calculate_implied_bounds_for_row(i, bp);
+        unsigned num_threads = std::min(settings().bprop_threads(), m_rows_with_changed_bounds.size() / min_rows_per_bprop_thread);
+        if (num_threads > 1) {
+            propagate_bounds_for_touched_rows_in_parallel(bp, num_threads);
             if (settings().get_cancel_flag())
                 return;
         }
+        else {
+            for (unsigned i : m_rows_with_changed_bounds) {
+                calculate_implied_bounds_for_row(i, bp);
+                if (settings().get_cancel_flag())
+                    return;
+            }
+        }
         // these two loops should be run sequentially
         // since the first loop might change column bounds
         // and add fixed columns this way
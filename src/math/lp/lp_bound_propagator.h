@@ -309,6 +309,8 @@ public:
         m_imp(imp) {}
 
     const vector<implied_bound>& ibounds() const { return m_ibounds; }
+
+    T& imp() { return m_imp; }
     
     void init() {
         m_improved_upper_bounds.clear();
@@ -353,6 +355,15 @@ public:
     
         if (!m_imp.bound_is_interesting(j, kind, v))
             return;
+        add_bound(v, j, is_low, coeff_before_j_is_pos, row_or_term_index, strict);
+    }
+
+    // adds a bound found by another propagator, keeping the stronger bound on each column
+    void merge(implied_bound const& ib) {
+        add_bound(ib.m_bound, ib.m_j, ib.m_is_lower_bound, ib.m_coeff_before_j_is_pos, ib.m_row_or_term_index, ib.m_strict);
+    }
+
+    void add_bound(mpq const& v, unsigned j, bool is_low, bool coeff_before_j_is_pos, unsigned row_or_term_index, bool strict) {
         unsigned k; // index to ibounds
         if (is_low) {
             if (try_get_value(m_improved_lower_bounds, j, k)) {
@@ -25,6 +25,7 @@ Revision History:
 #include "math/lp/core_solver_pretty_printer.h"
 #include "math/lp/numeric_pair.h"
 #include "math/lp/static_matrix.h"
+#include "math/lp/csr_matrix.h"
 #include "math/lp/lu.h"
 #include "math/lp/permutation_matrix.h"
 #include "math/lp/column_namer.h"
@@ -91,6 +92,8 @@ public:
     vector<unsigned>      m_trace_of_basis_change_vector; // the even positions are entering, the odd positions are leaving
     bool                  m_tracing_basis_changes;
     u_set*              m_pivoted_rows;
+    // when set and settings().csr_rows() holds, the pivot row is read from its compressed copy
+    csr_matrix<T>*        m_csr_rows;
     bool                  m_look_for_feasible_solution_only;
 
     void start_tracing_basis_changes() {
@@ -69,6 +69,7 @@ lp_core_solver_base(static_matrix<T, X> & A,
     m_steepest_edge_coefficients(A.column_count()),
     m_tracing_basis_changes(false),
     m_pivoted_rows(nullptr),
+    m_csr_rows(nullptr),
     m_look_for_feasible_solution_only(false) {
     lp_assert(bounds_for_boxed_are_set_correctly());    
     init();
@@ -607,6 +608,7 @@ divide_row_by_pivot(unsigned pivot_row, unsigned pivot_col) {
         }
     }
     coeff = one_of_type<T>();
+    m_A.row_changed(pivot_row);
     CASSERT("check_static_matrix", m_A.is_correct());
     return true;
 }
@@ -635,12 +637,17 @@ pivot_column_tableau(unsigned j, unsigned piv_row_index) {
         m_A.m_rows[piv_row_index][column[0].offset()].offset() = 0;
         m_A.m_rows[c.var()][c.offset()].offset() = pivot_col_cell_index;
     }
+    // the pivot row does not change below, so its compressed copy is made once 
+    // and is scanned for every row of the column; bound propagation reads the same copy
+    bool use_csr = m_csr_rows != nullptr && m_settings.csr_rows();
     while (column.size() > 1) {
         auto & c = column.back();
         lp_assert(c.var() != piv_row_index);
-        if(! m_A.pivot_row_to_row_given_cell(piv_row_index, c, j)) {
+        bool nonempty = use_csr ? 
+            m_A.pivot_row_cells_to_row_given_cell(m_csr_rows->get_row(m_A, piv_row_index), c, j) : 
+            m_A.pivot_row_to_row_given_cell(piv_row_index, c, j);
+        if (!nonempty) 
             return false;
-        }
         if (m_pivoted_rows!= nullptr)
             m_pivoted_rows->insert(c.var());
     }
@@ -33,4 +33,10 @@ void lp::lp_settings::updt_params(params_ref const& _p) {
     report_frequency = p.arith_rep_freq();
     m_simplex_strategy = static_cast<lp::simplex_strategy_enum>(p.arith_simplex_strategy());
     m_nlsat_delay = p.arith_nl_delay();
+    m_float_first = p.arith_float_first();
+    m_csr_rows = p.arith_csr_rows();
+    m_bprop_threads = std::max(1u, std::min(p.arith_bprop_threads(), statistics::max_bprop_threads));
+    m_cut_pool = p.arith_cut_pool();
+    m_cut_pool_max_age = p.arith_cut_pool_max_age();
+    m_cut_pool_max_parallelism = p.arith_cut_pool_max_parallelism();
 }
@@ -127,6 +127,26 @@ struct statistics {
     unsigned m_grobner_calls;
     unsigned m_grobner_conflicts;
     unsigned m_offset_eqs;
+    unsigned m_float_first_calls;
+    unsigned m_float_first_pivots;
+    unsigned m_float_first_repairs;
+    unsigned m_float_first_repair_pivots;
+    unsigned m_float_first_failures;
+    unsigned m_float_first_row_copies;
+    unsigned m_csr_row_copies;
+    unsigned m_csr_compactions;
+    unsigned m_cut_pool_rounds;
+    unsigned m_cut_pool_candidates;
+    unsigned m_cut_pool_gomory_cuts;
+    unsigned m_cut_pool_mir_cuts;
+    unsigned m_cut_pool_cover_cuts;
+    unsigned m_cut_pool_parallel;
+    unsigned m_cut_pool_reused;
+    unsigned m_cut_pool_aged;
+    static constexpr unsigned max_bprop_threads = 8;
+    unsigned m_bprop_parallel_rounds;
+    unsigned m_bprop_thread_rows[max_bprop_threads];   // rows analyzed by each thread
+    unsigned m_bprop_thread_bounds[max_bprop_threads]; // bounds found by each thread
     statistics() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
     void collect_statistics(::statistics& st) const {
@@ -148,6 +168,37 @@ struct statistics {
         st.update("arith-grobner-calls", m_grobner_calls);
         st.update("arith-grobner-conflicts", m_grobner_conflicts);
         st.update("arith-offset-eqs", m_offset_eqs);
+        st.update("arith-float-first-calls", m_float_first_calls);
+        st.update("arith-float-first-pivots", m_float_first_pivots);
+        st.update("arith-float-first-repairs", m_float_first_repairs);
+        st.update("arith-float-first-repair-pivots", m_float_first_repair_pivots);
+        st.update("arith-float-first-failures", m_float_first_failures);
+        st.update("arith-float-first-row-copies", m_float_first_row_copies);
+        st.update("arith-csr-row-copies", m_csr_row_copies);
+        st.update("arith-csr-compactions", m_csr_compactions);
+        st.update("arith-cut-pool-rounds", m_cut_pool_rounds);
+        st.update("arith-cut-pool-candidates", m_cut_pool_candidates);
+        st.update("arith-cut-pool-gomory", m_cut_pool_gomory_cuts);
+        st.update("arith-cut-pool-mir", m_cut_pool_mir_cuts);
+        st.update("arith-cut-pool-cover", m_cut_pool_cover_cuts);
+        st.update("arith-cut-pool-parallel", m_cut_pool_parallel);
+        st.update("arith-cut-pool-reused", m_cut_pool_reused);
+        st.update("arith-cut-pool-aged", m_cut_pool_aged);
+        if (m_bprop_parallel_rounds > 0) {
+            static char const* rows_keys[max_bprop_threads] = {
+                "arith-bprop-thread-0-rows", "arith-bprop-thread-1-rows", "arith-bprop-thread-2-rows", "arith-bprop-thread-3-rows",
+                "arith-bprop-thread-4-rows", "arith-bprop-thread-5-rows", "arith-bprop-thread-6-rows", "arith-bprop-thread-7-rows" };
+            static char const* bounds_keys[max_bprop_threads] = {
+                "arith-bprop-thread-0-bounds", "arith-bprop-thread-1-bounds", "arith-bprop-thread-2-bounds", "arith-bprop-thread-3-bounds",
+                "arith-bprop-thread-4-bounds", "arith-bprop-thread-5-bounds", "arith-bprop-thread-6-bounds", "arith-bprop-thread-7-bounds" };
+            st.update("arith-bprop-parallel-rounds", m_bprop_parallel_rounds);
+            for (unsigned i = 0; i < max_bprop_threads; i++) {
+                if (m_bprop_thread_rows[i] == 0)
+                    continue;
+                st.update(rows_keys[i], m_bprop_thread_rows[i]);
+                st.update(bounds_keys[i], m_bprop_thread_bounds[i]);
+            }
+        }
 
     }
 };
@@ -242,9 +293,24 @@ private:
     bool             m_enable_hnf { true };
     bool             m_print_external_var_name { false };
     bool             m_propagate_eqs { false };
+    bool             m_float_first { false };
+    bool             m_csr_rows { false };
+    unsigned         m_bprop_threads { 1 };
+    bool             m_cut_pool { false };
+    unsigned         m_cut_pool_max_age { 10 };
+    double           m_cut_pool_max_parallelism { 0.95 };
 public:
     bool print_external_var_name() const { return m_print_external_var_name; }
     bool propagate_eqs() const { return m_propagate_eqs;}
+    bool float_first() const { return m_float_first; }
+    bool& float_first() { return m_float_first; }
+    bool csr_rows() const { return m_csr_rows; }
+    bool& csr_rows() { return m_csr_rows; }
+    unsigned bprop_threads() const { return m_bprop_threads; }
+    unsigned& bprop_threads() { return m_bprop_threads; }
+    bool cut_pool() const { return m_cut_pool; }
+    unsigned cut_pool_max_age() const { return m_cut_pool_max_age; }
+    double cut_pool_max_parallelism() const { return m_cut_pool_max_parallelism; }
     unsigned hnf_cut_period() const { return m_hnf_cut_period; }
     void set_hnf_cut_period(unsigned period) { m_hnf_cut_period = period;  }
     unsigned random_next() { return m_rand(); }
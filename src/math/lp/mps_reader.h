@@ -154,7 +154,6 @@ class mps_reader {
     std::string m_file_name;
     std::unordered_map<std::string, row *> m_rows;
     std::unordered_map<std::string, column *> m_columns;
-    std::unordered_map<std::string, unsigned> m_names_to_var_index;
     std::string m_line;
     std::string m_name;
     std::string m_cost_row_name;
@@ -807,24 +806,16 @@ public:
         }
     }
 
-    unsigned get_var_index(std::string s) {
-        auto it = m_names_to_var_index.find(s);
-        if (it != m_names_to_var_index.end())
-            return it->second;
-        unsigned ret = static_cast<unsigned>(m_names_to_var_index.size());
-        m_names_to_var_index[s] = ret;
-        return ret;
-    }
-    
     void fill_lar_solver_on_row(row * row, lar_solver *solver, int row_index)  {
         if (row->m_name != m_cost_row_name) {
             auto kind = get_lar_relation_from_row(row->m_type);
             vector<std::pair<mpq, var_index>> ls;
             for (auto s : row->m_row_columns) {
-                var_index i = solver->add_var(get_var_index(s.first), false);
+                var_index i = solver->add_var(m_columns[s.first]->m_index, false);
                 ls.push_back(std::make_pair(s.second, i));
             }
-            unsigned j = solver->add_term(ls, row_index);
+            // the columns take the external indices below m_columns.size()
+            unsigned j = solver->add_term(ls, static_cast<unsigned>(m_columns.size()) + row_index);
             solver->add_var_bound(j, kind, row->m_right_side);
         } else {
             // ignore the cost row
@@ -860,7 +851,7 @@ public:
             mps_reader::column * col = s.second;
             solver->add_var(col->m_index, false);
             auto b = col->m_bound;
-            if (b == nullptr) return;
+            if (b == nullptr) continue;
 
             if (b->m_free) continue;
 
@@ -0,0 +1,306 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    small_rational.h
+
+Abstract:
+
+    Rational numbers for the cells of the LP tableau.
+
+    A value whose numerator and denominator fit in 64 bits is kept inline
+    and the arithmetic on such values is done inline with overflow checks
+    in the style of checked_int64. A result that overflows is promoted to
+    a rational allocated on the heap. A big result that fits in 64 bits
+    again is demoted.
+
+    The type can be used as the coefficient type of static_matrix,
+    row_strip and indexed_vector. These are instantiated with it for the
+    pivot benchmark of src/test/lp, lar_solver does not use it yet.
+
+--*/
+#pragma once
+
+#include "util/rational.h"
+#include "util/mpz.h"
+#include <climits>
+#include "math/lp/numeric_pair.h"
+
+namespace lp {
+
+class small_rational {
+    int64_t    m_num { 0 };
+    int64_t    m_den { 1 };         // positive and coprime with m_num
+    rational * m_big { nullptr };   // the value when it does not fit in 64 bits
+
+    // INT64_MIN is excluded to keep negation and abs inline.
+    static bool fits(int64_t v) { return v != INT64_MIN; }
+
+    static bool add_overflow(int64_t a, int64_t b, int64_t & r) {
+        r = static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+        return (a > 0 && b > 0 && r <= 0) || (a < 0 && b < 0 && r >= 0) || !fits(r);
+    }
+
+    static bool mul_overflow(int64_t a, int64_t b, int64_t & r) {
+        if (INT_MIN < a && a <= INT_MAX && INT_MIN < b && b <= INT_MAX) {
+            r = a * b;
+            return false;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_mul_overflow(a, b, &r) || !fits(r);
+#else
+        uint64_t ua = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+        uint64_t ub = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+        // the product must fit in INT64_MAX, which also excludes INT64_MIN
+        if (ua != 0 && ub > static_cast<uint64_t>(INT64_MAX) / ua)
+            return true;
+        r = a * b;
+        return false;
+#endif
+    }
+
+    static int64_t gcd(int64_t a, int64_t b) {
+        return static_cast<int64_t>(u64_gcd(static_cast<uint64_t>(a < 0 ? -a : a), static_cast<uint64_t>(b)));
+    }
+
+    void set_small(int64_t num, int64_t den) {
+        SASSERT(den > 0);
+        if (den != 1 && num != 1 && num != -1) {
+            int64_t g = gcd(num, den);
+            if (g > 1) {
+                num /= g;
+                den /= g;
+            }
+        }
+        if (num == 0)
+            den = 1;
+        m_num = num;
+        m_den = den;
+        if (m_big) {
+            dealloc(m_big);
+            m_big = nullptr;
+        }
+    }
+
+    void set_big(rational const & r) {
+        if (r.is_int64() && fits(r.get_int64())) {
+            set_small(r.get_int64(), 1);
+            return;
+        }
+        if (!r.is_int()) {
+            rational n = numerator(r), d = denominator(r);
+            if (n.is_int64() && d.is_int64() && fits(n.get_int64()) && fits(d.get_int64())) {
+                set_small(n.get_int64(), d.get_int64());
+                return;
+            }
+        }
+        if (m_big)
+            *m_big = r;
+        else
+            m_big = alloc(rational, r);
+    }
+
+    // slow paths
+    void add_big(small_rational const & b) { set_big(to_rational() + b.to_rational()); }
+    void mul_big(small_rational const & b) { set_big(to_rational() * b.to_rational()); }
+
+public:
+    small_rational() {}
+    small_rational(int v): m_num(v) {}
+    explicit small_rational(rational const & r) { set_big(r); }
+    small_rational(small_rational const & other): m_num(other.m_num), m_den(other.m_den) {
+        if (other.m_big)
+            m_big = alloc(rational, *other.m_big);
+    }
+    small_rational(small_rational && other) noexcept: m_num(other.m_num), m_den(other.m_den), m_big(other.m_big) {
+        other.m_big = nullptr;
+    }
+    ~small_rational() {
+        if (m_big)
+            dealloc(m_big);
+    }
+
+    small_rational & operator=(small_rational const & other) {
+        if (this == &other)
+            return *this;
+        if (other.m_big)
+            set_big(*other.m_big);
+        else
+            set_small(other.m_num, other.m_den);
+        return *this;
+    }
+
+    small_rational & operator=(small_rational && other) noexcept {
+        std::swap(m_num, other.m_num);
+        std::swap(m_den, other.m_den);
+        std::swap(m_big, other.m_big);
+        return *this;
+    }
+
+    bool is_big() const { return m_big != nullptr; }
+    bool is_zero() const { return !m_big && m_num == 0; }
+    bool is_one() const { return !m_big && m_num == 1 && m_den == 1; }
+    bool is_pos() const { return m_big ? m_big->is_pos() : m_num > 0; }
+    bool is_neg() const { return m_big ? m_big->is_neg() : m_num < 0; }
+    bool is_int() const { return m_big ? m_big->is_int() : m_den == 1; }
+
+    rational to_rational() const {
+        if (m_big)
+            return *m_big;
+        if (m_den == 1)
+            return rational(m_num, rational::i64());
+        return rational(m_num, rational::i64()) / rational(m_den, rational::i64());
+    }
+
+    double get_double() const {
+        return m_big ? m_big->get_double() : static_cast<double>(m_num) / static_cast<double>(m_den);
+    }
+
+    small_rational & neg() {
+        if (m_big)
+            m_big->neg();
+        else
+            m_num = -m_num;
+        return *this;
+    }
+
+    small_rational & operator+=(small_rational const & b) {
+        int64_t n, d, t1, t2;
+        if (m_big || b.m_big)
+            add_big(b);
+        else if (m_den == 1 && b.m_den == 1) {
+            if (add_overflow(m_num, b.m_num, n))
+                add_big(b);
+            else
+                m_num = n;
+        }
+        else if (m_den == b.m_den) {
+            if (add_overflow(m_num, b.m_num, n))
+                add_big(b);
+            else
+                set_small(n, m_den);
+        }
+        else if (mul_overflow(m_num, b.m_den, t1) || mul_overflow(b.m_num, m_den, t2) ||
+                 add_overflow(t1, t2, n) || mul_overflow(m_den, b.m_den, d))
+            add_big(b);
+        else
+            set_small(n, d);
+        return *this;
+    }
+
+    small_rational & operator-=(small_rational const & b) {
+        if (this == &b) {
+            set_small(0, 1);
+            return *this;
+        }
+        neg();
+        *this += b;
+        return neg();
+    }
+
+    small_rational & operator*=(small_rational const & b) {
+        int64_t n, d;
+        if (m_big || b.m_big)
+            mul_big(b);
+        else if (m_den == 1 && b.m_den == 1) {
+            if (mul_overflow(m_num, b.m_num, n))
+                mul_big(b);
+            else
+                m_num = n;
+        }
+        else {
+            // cross cancel first, the result is then in lowest terms
+            int64_t g1 = gcd(m_num, b.m_den), g2 = gcd(b.m_num, m_den);
+            if (g1 == 0) g1 = 1;
+            if (g2 == 0) g2 = 1;
+            if (mul_overflow(m_num / g1, b.m_num / g2, n) || mul_overflow(m_den / g2, b.m_den / g1, d))
+                mul_big(b);
+            else {
+                m_num = n;
+                m_den = n == 0 ? 1 : d;
+            }
+        }
+        return *this;
+    }
+
+    small_rational & operator/=(small_rational const & b) {
+        SASSERT(!b.is_zero());
+        if (m_big || b.m_big) {
+            set_big(to_rational() / b.to_rational());
+            return *this;
+        }
+        small_rational inv;
+        inv.m_num = b.m_num < 0 ? -b.m_den : b.m_den;
+        inv.m_den = b.m_num < 0 ? -b.m_num : b.m_num;
+        return *this *= inv;
+    }
+
+    // this += a * b
+    small_rational & addmul(small_rational const & a, small_rational const & b) {
+        if (!m_big && !a.m_big && !b.m_big && m_den == 1 && a.m_den == 1 && b.m_den == 1) {
+            int64_t p, n;
+            if (!mul_overflow(a.m_num, b.m_num, p) && !add_overflow(m_num, p, n)) {
+                m_num = n;
+                return *this;
+            }
+        }
+        small_rational p(a);
+        p *= b;
+        return *this += p;
+    }
+
+    friend bool operator==(small_rational const & a, small_rational const & b) {
+        if (a.m_big || b.m_big)
+            return a.m_big && b.m_big && *a.m_big == *b.m_big;
+        return a.m_num == b.m_num && a.m_den == b.m_den;
+    }
+
+    friend bool operator<(small_rational const & a, small_rational const & b) {
+        int64_t l, r;
+        if (!a.m_big && !b.m_big) {
+            if (a.m_den == b.m_den)
+                return a.m_num < b.m_num;
+            if (!mul_overflow(a.m_num, b.m_den, l) && !mul_overflow(b.m_num, a.m_den, r))
+                return l < r;
+        }
+        return a.to_rational() < b.to_rational();
+    }
+
+    static small_rational const & zero() { static small_rational z(0); return z; }
+    static small_rational const & one() { static small_rational o(1); return o; }
+
+    std::string to_string() const { return to_rational().to_string(); }
+};
+
+inline bool operator!=(small_rational const & a, small_rational const & b) { return !(a == b); }
+inline bool operator>(small_rational const & a, small_rational const & b) { return b < a; }
+inline bool operator<=(small_rational const & a, small_rational const & b) { return !(b < a); }
+inline bool operator>=(small_rational const & a, small_rational const & b) { return !(a < b); }
+
+inline small_rational operator-(small_rational const & a) { small_rational r(a); return r.neg(); }
+inline small_rational operator+(small_rational const & a, small_rational const & b) { small_rational r(a); return r += b; }
+inline small_rational operator-(small_rational const & a, small_rational const & b) { small_rational r(a); return r -= b; }
+inline small_rational operator*(small_rational const & a, small_rational const & b) { small_rational r(a); return r *= b; }
+inline small_rational operator/(small_rational const & a, small_rational const & b) { small_rational r(a); return r /= b; }
+inline small_rational abs(small_rational const & a) { return a.is_neg() ? -a : a; }
+
+inline void addmul(small_rational & r, small_rational const & a, small_rational const & b) { r.addmul(a, b); }
+
+inline std::ostream & operator<<(std::ostream & out, small_rational const & r) { return out << r.to_string(); }
+
+template<>
+class numeric_traits<small_rational> {
+public:
+    static bool precise() { return true; }
+    static small_rational const & zero() { return small_rational::zero(); }
+    static small_rational const & one() { return small_rational::one(); }
+    static bool is_zero(small_rational const & v) { return v.is_zero(); }
+    static double get_double(small_rational const & d) { return d.get_double(); }
+    static bool is_pos(small_rational const & d) { return d.is_pos(); }
+    static bool is_neg(small_rational const & d) { return d.is_neg(); }
+    static bool is_int(small_rational const & d) { return d.is_int(); }
+    static bool is_big(small_rational const & d) { return d.is_big(); }
+};
+
+}
@@ -28,6 +28,7 @@ Revision History:
 #include "math/lp/lp_primal_core_solver.h"
 #include "math/lp/scaler.h"
 #include "math/lp/lar_solver.h"
+#include "math/lp/small_rational.h"
 namespace lp {
 template void static_matrix<double, double>::add_columns_at_the_end(unsigned int);
 template void static_matrix<double, double>::clear();
@@ -46,9 +47,12 @@ template double static_matrix<double, double>::get_min_abs_in_column(unsigned in
 template double static_matrix<double, double>::get_min_abs_in_row(unsigned int) const;
 template void static_matrix<double, double>::init_empty_matrix(unsigned int, unsigned int);
 template void static_matrix<double, double>::init_row_columns(unsigned int, unsigned int);
+template void static_matrix<double, double>::init_vector_of_row_offsets();
 template static_matrix<double, double>::ref & static_matrix<double, double>::ref::operator=(double const&);
 template void static_matrix<double, double>::set(unsigned int, unsigned int, double const&);
 template static_matrix<double, double>::static_matrix(unsigned int, unsigned int);
+template void static_matrix<double, double>::add_new_element(unsigned int, unsigned int, double const&);
+template void static_matrix<double, double>::remove_element(vector<row_cell<double>>&, row_cell<double>&);
 template void static_matrix<mpq, mpq>::add_column_to_vector(mpq const&, unsigned int, mpq*) const;
 template void static_matrix<mpq, mpq>::add_columns_at_the_end(unsigned int);
 template bool static_matrix<mpq, mpq>::is_correct() const;
@@ -78,7 +82,18 @@ template void static_matrix<mpq, numeric_pair<mpq> >::set(unsigned int, unsigned
 template bool lp::static_matrix<double, double>::pivot_row_to_row_given_cell(unsigned int, column_cell &, unsigned int);
 template bool lp::static_matrix<lp::mpq, lp::mpq>::pivot_row_to_row_given_cell(unsigned int, column_cell& , unsigned int);
 template bool lp::static_matrix<lp::mpq, lp::numeric_pair<lp::mpq> >::pivot_row_to_row_given_cell(unsigned int, column_cell&, unsigned int);
+template void lp::static_matrix<double, double>::scan_row_ii_to_offset_vector(const row_strip<double> &);
+template void lp::static_matrix<lp::mpq, lp::mpq>::scan_row_ii_to_offset_vector(const row_strip<lp::mpq> &);
+template void lp::static_matrix<lp::mpq, lp::numeric_pair<lp::mpq> >::scan_row_ii_to_offset_vector(const row_strip<lp::mpq> &);
 template void lp::static_matrix<lp::mpq, lp::numeric_pair<lp::mpq> >::remove_element(vector<lp::row_cell<lp::mpq>, true, unsigned int>&, lp::row_cell<lp::mpq>&);
 
+template void static_matrix<small_rational, small_rational>::init_row_columns(unsigned int, unsigned int);
+template void static_matrix<small_rational, small_rational>::init_vector_of_row_offsets();
+template void static_matrix<small_rational, small_rational>::clear();
+template void static_matrix<small_rational, small_rational>::add_new_element(unsigned int, unsigned int, small_rational const&);
+template void static_matrix<small_rational, small_rational>::remove_element(vector<row_cell<small_rational>, true, unsigned int>&, row_cell<small_rational>&);
+template small_rational static_matrix<small_rational, small_rational>::get_elem(unsigned int, unsigned int) const;
+template bool static_matrix<small_rational, small_rational>::pivot_row_to_row_given_cell(unsigned int, column_cell&, unsigned int);
+
 }
 
@@ -18,6 +18,9 @@ Author:
 #include <stack>
 namespace lp {
 
+inline void addmul(double& r, double a, double b) { r += a*b; }
+inline void addmul(mpq& r, mpq const& a, mpq const& b) { r.addmul(a, b); }
+
 template <typename T>
 class row_cell {
     unsigned m_j;         // points to the column
@@ -66,6 +69,9 @@ class static_matrix
         dim(unsigned m, unsigned n) :m_m(m), m_n(n) {}
     };
     std::stack<dim> m_stack;
+    // the stamp of the last change of each row, see csr_matrix
+    vector<uint64_t> m_row_stamps;
+    uint64_t         m_stamp { 0 };
 public:
     vector<int> m_vector_of_row_offsets;
     indexed_vector<T> m_work_vector;
@@ -102,6 +108,17 @@ public:
     column_cell & get_column_cell(const row_cell<T> &rc) {
         return m_columns[rc.var()][rc.offset()];
     }
+
+    // has to be called after the cells of the row are changed in place
+    void row_changed(unsigned i) {
+        if (i >= m_row_stamps.size())
+            m_row_stamps.resize(i + 1, 0);
+        m_row_stamps[i] = ++m_stamp;
+    }
+
+    uint64_t row_stamp(unsigned i) const {
+        return i < m_row_stamps.size() ? m_row_stamps[i] : 0;
+    }
     
     void init_row_columns(unsigned m, unsigned n);
 
@@ -146,6 +163,7 @@ public:
         for (auto & t : m_columns[column]) {
             auto & r = m_rows[t.var()][t.offset()];
             r.coeff() *= alpha;
+            row_changed(t.var());
         }
     }
     
@@ -273,12 +291,14 @@ public:
         for (auto & t : m_rows[row]) {
             t.coeff() *= alpha;
         }
+        row_changed(row);
     }
 
     void divide_row(unsigned row, T const & alpha) {
         for (auto & t : m_rows[row]) {
             t.coeff() /= alpha;
         }
+        row_changed(row);
     }
     
     T dot_product_with_column(const vector<T> & y, unsigned j) const {
@@ -292,6 +312,45 @@ public:
 
     // pivot row i to row ii
     bool pivot_row_to_row_given_cell(unsigned i, column_cell& c, unsigned);
+
+    // pivot to row ii the cells of piv_row, the pivot row or a copy of it
+    template <typename R>
+    bool pivot_row_cells_to_row_given_cell(R const & piv_row, column_cell& c, unsigned pivot_col) {
+        unsigned ii = c.var();
+        lp_assert(ii < row_count());
+        T alpha = -get_val(c);
+        lp_assert(!is_zero(alpha));
+        auto & rowii = m_rows[ii];
+        row_changed(ii);
+        remove_element(rowii, rowii[c.offset()]);
+        scan_row_ii_to_offset_vector(rowii);
+        unsigned prev_size_ii = rowii.size();
+        // run over the pivot row and update row ii
+        for (const auto & iv : piv_row) {
+            unsigned j = iv.var();
+            if (j == pivot_col) continue;
+            lp_assert(!is_zero(iv.coeff()));
+            int j_offs = m_vector_of_row_offsets[j];
+            if (j_offs == -1) { // it is a new element
+                T alv = alpha * iv.coeff();
+                add_new_element(ii, j, alv);
+            }
+            else {
+                addmul(rowii[j_offs].coeff(), iv.coeff(), alpha);
+            }
+        }
+        // clean the work vector
+        for (unsigned k = 0; k < prev_size_ii; k++) {
+            m_vector_of_row_offsets[rowii[k].var()] = -1;
+        }
+
+        // remove zeroes
+        for (unsigned k = rowii.size(); k-- > 0;  ) {
+            if (is_zero(rowii[k].coeff()))
+                remove_element(rowii, rowii[k]);
+        }
+        return !rowii.empty();
+    }
     void scan_row_ii_to_offset_vector(const row_strip<T> & rvals);
 
     void transpose_rows(unsigned i, unsigned ii) {
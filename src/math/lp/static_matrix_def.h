@@ -26,9 +26,6 @@ Revision History:
 namespace lp {
 // each assignment for this matrix should be issued only once!!!
 
-inline void addmul(double& r, double a, double b) { r += a*b; }
-inline void addmul(mpq& r, mpq const& a, mpq const& b) { r.addmul(a, b); }
-
 template <typename T, typename X>
 void  static_matrix<T, X>::init_row_columns(unsigned m, unsigned n) {
     lp_assert(m_rows.size() == 0 && m_columns.size() == 0);
@@ -48,39 +45,8 @@ template <typename T, typename X> void static_matrix<T, X>::scan_row_ii_to_offse
 
 
 template <typename T, typename X> bool static_matrix<T, X>::pivot_row_to_row_given_cell(unsigned i, column_cell & c, unsigned pivot_col) {
-    unsigned ii = c.var();
-    lp_assert(i < row_count() && ii < column_count() && i != ii);
-    T alpha = -get_val(c);
-    lp_assert(!is_zero(alpha));
-    auto & rowii = m_rows[ii];
-    remove_element(rowii, rowii[c.offset()]);
-    scan_row_ii_to_offset_vector(rowii);
-    unsigned prev_size_ii = rowii.size();
-    // run over the pivot row and update row ii
-    for (const auto & iv : m_rows[i]) {
-        unsigned j = iv.var();
-        if (j == pivot_col) continue;
-        lp_assert(!is_zero(iv.coeff()));
-        int j_offs = m_vector_of_row_offsets[j];
-        if (j_offs == -1) { // it is a new element
-            T alv = alpha * iv.coeff();
-            add_new_element(ii, j, alv);
-        }
-        else {
-            addmul(rowii[j_offs].coeff(), iv.coeff(), alpha);
-        }
-    }
-    // clean the work vector
-    for (unsigned k = 0; k < prev_size_ii; k++) {
-        m_vector_of_row_offsets[rowii[k].var()] = -1;
-    }
-
-    // remove zeroes
-    for (unsigned k = rowii.size(); k-- > 0;  ) {
-        if (is_zero(rowii[k].coeff()))
-            remove_element(rowii, rowii[k]);
-    }
-    return !rowii.empty();
+    lp_assert(i < row_count() && i != c.var());
+    return pivot_row_cells_to_row_given_cell(m_rows[i], c, pivot_col);
 }
 
 
@@ -159,6 +125,7 @@ template <typename T, typename X> void static_matrix<T, X>::set(unsigned row, un
     lp_assert(row < row_count() && col < column_count());
     auto & r = m_rows[row];
     unsigned offs_in_cols = m_columns[col].size();
+    row_changed(row);
     m_columns[col].push_back(make_column_cell(row, r.size()));
     r.push_back(make_row_cell(col, offs_in_cols, val));
 }
@@ -370,6 +337,7 @@ void static_matrix<T, X>::remove_element(vector<row_cell<T>> & row_vals, row_cel
     auto & column_vals = m_columns[row_el_iv.var()];
     column_cell& cs = m_columns[row_el_iv.var()][column_offset];
     unsigned row_offset = cs.offset();
+    row_changed(cs.var());
     if (column_offset != column_vals.size() - 1) {
         auto & cc = column_vals[column_offset] = column_vals.back(); // copy from the tail
         m_rows[cc.var()][cc.offset()].offset() = column_offset;
@@ -390,6 +358,7 @@ void static_matrix<T, X>::add_new_element(unsigned row, unsigned col, const T& v
     auto & col_vals = m_columns[col];
     unsigned row_el_offs = row_vals.size();
     unsigned col_el_offs = col_vals.size();
+    row_changed(row);
     row_vals.push_back(row_cell<T>(col, col_el_offs, val));
     col_vals.push_back(column_cell(row, row_el_offs));
 }
@@ -20,6 +20,16 @@ Revision History:
 #undef max
 #undef min
 #include "sat/sat_solver.h"
+#include <fstream>
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
 
 template<typename Buffer>
 static bool is_whitespace(Buffer & in) {
@@ -144,6 +154,220 @@ bool parse_dimacs(std::istream & in, std::ostream& err, sat::solver & solver) {
     return parse_dimacs_core(_in, err, solver);
 }
 
+namespace dimacs {
+
+    /**
+       \brief read-only contents of a file. 
+       The file is memory mapped where supported and read into memory otherwise.
+    */
+    class mapped_file {
+        char const*   m_data { nullptr };
+        size_t        m_size { 0 };
+        bool          m_mapped { false };
+        svector<char> m_buffer;
+    public:
+        ~mapped_file() {
+#ifndef _WINDOWS
+            if (m_mapped)
+                munmap(const_cast<char*>(m_data), m_size);
+#endif
+        }
+
+        bool open(char const * file_name) {
+#ifndef _WINDOWS
+            int fd = ::open(file_name, O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    madvise(data, st.st_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<char const*>(data);
+                    m_size = st.st_size;
+                    m_mapped = true;
+                }
+            }
+            close(fd);
+            if (m_mapped)
+                return true;
+#endif
+            std::ifstream in(file_name, std::ios::binary);
+            if (in.bad() || in.fail())
+                return false;
+            char buffer[1 << 16];
+            while (in) {
+                in.read(buffer, sizeof(buffer));
+                for (std::streamsize i = 0; i < in.gcount(); ++i)
+                    m_buffer.push_back(buffer[i]);
+            }
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+            return true;
+        }
+
+        char const* begin() const { return m_data; }
+        char const* end() const { return m_data + m_size; }
+        size_t size() const { return m_size; }
+    };
+
+    /**
+       \brief part of a DIMACS file that starts at the beginning of a line.
+       m_lits contains the parsed clauses, each terminated by null_literal.
+       The first and last clause may continue in the neighboring parts.
+    */
+    struct chunk {
+        char const*         m_begin { nullptr };
+        char const*         m_end { nullptr };
+        sat::literal_vector m_lits;
+        unsigned            m_start { 0 };            // first literal that is not moved to the previous part
+        unsigned            m_max_var { 0 };
+        unsigned            m_lines { 0 };
+        unsigned            m_error_line { UINT_MAX };
+        int                 m_error_char { 0 };
+
+        void parse() {
+            char const* p = m_begin;
+            bool in_clause = false;
+            while (p < m_end) {
+                char c = *p;
+                if (c == '\n') {
+                    ++m_lines;
+                    ++p;
+                    continue;
+                }
+                if ((c >= 9 && c <= 13) || c == 32) {
+                    ++p;
+                    continue;
+                }
+                if (!in_clause && (c == 'c' || c == 'p')) {
+                    while (p < m_end && *p != '\n')
+                        ++p;
+                    continue;
+                }
+                bool neg = false;
+                if (c == '-') {
+                    neg = true;
+                    ++p;
+                }
+                else if (c == '+') 
+                    ++p;
+                if (p == m_end || *p < '0' || *p > '9') {
+                    m_error_line = m_lines;
+                    m_error_char = p == m_end ? EOF : *p;
+                    return;
+                }
+                unsigned val = 0;
+                for (; p < m_end && *p >= '0' && *p <= '9'; ++p) 
+                    val = val*10 + (*p - '0');
+                if (val == 0) {
+                    m_lits.push_back(sat::null_literal);
+                    in_clause = false;
+                }
+                else {
+                    m_lits.push_back(sat::literal(val, neg));
+                    m_max_var = std::max(m_max_var, val);
+                    in_clause = true;
+                }
+            }
+        }
+    };
+}
+
+bool parse_dimacs_file(char const * file_name, std::ostream& err, sat::solver & solver, unsigned num_threads) {
+    dimacs::mapped_file file;
+    if (!file.open(file_name)) {
+        err << "(error \"failed to open file '" << file_name << "'\")\n";
+        return false;
+    }
+#ifdef SINGLE_THREAD
+    num_threads = 1;
+#else
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+#endif
+    // parts of less than 1MB are not worth a thread.
+    num_threads = std::max(1u, std::min(num_threads, static_cast<unsigned>(file.size() >> 20) + 1));
+
+    vector<dimacs::chunk> chunks(num_threads);
+    char const* p = file.begin();
+    for (unsigned i = 0; i < num_threads; ++i) {
+        char const* q = i + 1 == num_threads ? file.end() : std::max(p, file.begin() + (file.size() * (i + 1)) / num_threads);
+        while (q < file.end() && q > file.begin() && q[-1] != '\n')
+            ++q;
+        chunks[i].m_begin = p;
+        chunks[i].m_end = q;
+        p = q;
+    }
+
+#ifndef SINGLE_THREAD
+    if (num_threads > 1) {
+        vector<std::thread> threads;
+        for (unsigned i = 0; i < num_threads; ++i) 
+            threads.push_back(std::thread([&, i]() { chunks[i].parse(); }));
+        for (auto& th : threads)
+            th.join();
+    }
+    else
+#endif
+        chunks[0].parse();
+
+    // line numbers in error messages start at 1.
+    unsigned line = 1;
+    for (auto const& c : chunks) {
+        if (c.m_error_line != UINT_MAX) {
+            int ch = c.m_error_char;
+            if (20 <= ch && ch < 128) 
+                err << "(error, \"unexpected char: " << ((char)ch) << " line: " << line + c.m_error_line << "\")\n";
+            else
+                err << "(error, \"unexpected char: " << ch << " line: " << line + c.m_error_line << "\")\n";
+            return false;
+        }
+        line += c.m_lines;
+    }
+
+    // move clauses that cross part boundaries to the part where they start.
+    unsigned open = UINT_MAX; 
+    unsigned max_var = 0;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        dimacs::chunk& c = chunks[i];
+        max_var = std::max(max_var, c.m_max_var);
+        if (open != UINT_MAX) {
+            unsigned j = 0, sz = c.m_lits.size();
+            while (j < sz && c.m_lits[j] != sat::null_literal)
+                ++j;
+            j = std::min(j + 1, sz);
+            for (unsigned k = 0; k < j; ++k)
+                chunks[open].m_lits.push_back(c.m_lits[k]);
+            c.m_start = j;
+            if (chunks[open].m_lits.back() == sat::null_literal)
+                open = UINT_MAX;
+        }
+        if (c.m_start < c.m_lits.size() && c.m_lits.back() != sat::null_literal)
+            open = i;
+    }
+    if (open != UINT_MAX) {
+        if (file.size() > 0 && file.end()[-1] == '\n')
+            --line;
+        err << "(error, \"unexpected char: " << EOF << " line: " << line << "\")\n";
+        return false;
+    }
+
+    while (max_var >= solver.num_vars())
+        solver.mk_var();
+    for (dimacs::chunk& c : chunks) {
+        unsigned i = c.m_start, sz = c.m_lits.size();
+        while (i < sz) {
+            unsigned j = i;
+            while (c.m_lits[j] != sat::null_literal)
+                ++j;
+            solver.mk_clause(j - i, c.m_lits.data() + i);
+            i = j + 1;
+        }
+    }
+    return true;
+}
+
 
 namespace dimacs {
 
@@ -227,6 +451,8 @@ namespace dimacs {
     }
 
     bool drat_parser::next() {
+        if (m_binary)
+            return next_binary();
         int theory_id;
         try {
         loop:
@@ -284,4 +510,46 @@ namespace dimacs {
             return false;
         }
     }
+
+    /**
+       \brief parse a record in binary DRAT format.
+       A record is 'a' (added clause) or 'd' (deleted clause) followed by 
+       the literals and a terminating 0. Each literal is the variable-length 
+       encoding of 2*var + sign using 7 bits per byte, least significant first.
+    */
+    bool drat_parser::next_binary() {
+        m_record.m_lits.reset();
+        switch (*in) {
+        case EOF:
+            return false;
+        case 'a':
+            m_record.m_status = sat::status::redundant();
+            break;
+        case 'd':
+            m_record.m_status = sat::status::deleted();
+            break;
+        default:
+            err << "(error, \"unexpected binary DRAT record " << *in << "\")\n";
+            return false;
+        }
+        ++in;
+        while (true) {
+            unsigned v = 0, shift = 0;
+            int ch;
+            do {
+                ch = *in;
+                if (ch == EOF || shift > 28) {
+                    err << "(error, \"truncated binary DRAT record\")\n";
+                    return false;
+                }
+                ++in;
+                v |= static_cast<unsigned>(ch & 127) << shift;
+                shift += 7;
+            }
+            while (ch & 128);
+            if (v == 0)
+                return true;
+            m_record.m_lits.push_back(sat::literal(v >> 1, (v & 1) != 0));
+        }
+    }
 }
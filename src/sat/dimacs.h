@@ -25,6 +25,13 @@ Revision History:
 
 bool parse_dimacs(std::istream & s, std::ostream& err, sat::solver & solver);
 
+/**
+   \brief parse the DIMACS file file_name with num_threads threads, 0 uses the number of cores.
+   The file is memory mapped and split at line boundaries. The parts are parsed concurrently
+   and the clauses are added to the solver in file order.
+*/
+bool parse_dimacs_file(char const * file_name, std::ostream& err, sat::solver & solver, unsigned num_threads = 0);
+
 namespace dimacs {
     struct lex_error {};
 
@@ -36,7 +43,7 @@ namespace dimacs {
         
     stream_buffer(std::istream & s):
         m_stream(s),
-            m_line(0) {
+            m_line(1) {
             m_val = m_stream.get();
         }
         
@@ -75,16 +82,18 @@ namespace dimacs {
         drat_record        m_record;
         std::function<int(char const*)> m_read_theory_id;
         svector<char>      m_buffer;
+        bool               m_binary;
 
         char const* parse_sexpr();
         char const* parse_identifier();
         char const* parse_quoted_symbol();
         int read_theory_id();
         bool next();
+        bool next_binary();
 
     public:
-        drat_parser(std::istream & _in, std::ostream& err):
-            in(_in), err(err)
+        drat_parser(std::istream & _in, std::ostream& err, bool binary = false):
+            in(_in), err(err), m_binary(binary)
         {}
 
         class iterator {
@@ -85,7 +85,7 @@ namespace sat {
         s.collect_bin_clauses(bc, false, false); // exclude roots.
         for (auto b : bc) {
             literal lits[2] = { b.first, b.second };
-            clause* cls = s.cls_allocator().mk_clause(2, lits, false);
+            clause* cls = s.alloc_clause(2, lits, false);
             ul.insert(*cls);
             m_bin_clauses.push_back(cls);
             register_clause(cls);
@@ -26,18 +26,19 @@ namespace sat {
     clause::clause(unsigned id, unsigned sz, literal const * lits, bool learned):
         m_id(id),
         m_size(sz),
-        m_capacity(sz),
+        m_strengthened(true),
         m_removed(false),
         m_learned(learned),
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_capacity(sz),
+        m_chunk(0),
         m_inact_rounds(0),
         m_glue(255),
         m_psm(255) {
+        SASSERT(sz <= MAX_SIZE);
         memcpy(m_lits, lits, sizeof(literal) * sz);
-        mark_strengthened();
-        SASSERT(check_approx());
     }
 
     var_approx_set clause::approx(unsigned num, literal const * lits) {
@@ -47,18 +48,6 @@ namespace sat {
         return r;
     }
 
-    void clause::update_approx() {
-        m_approx = approx(m_size, m_lits);
-    }
-
-    bool clause::check_approx() const {
-        var_approx_set curr = m_approx;
-        (void)curr;
-        const_cast<clause*>(this)->update_approx();
-        SASSERT(may_eq(curr, m_approx));
-        return true;
-    }
-
     bool clause::contains(literal l) const {
         for (literal l2 : *this) 
             if (l2 == l) 
@@ -115,23 +104,11 @@ namespace sat {
     }
 
     clause_offset clause::get_new_offset() const {
-        unsigned o1 = m_lits[0].index();
-#if defined(__LP64__) || defined(_WIN64)
-        if (sizeof(clause_offset) == 8) {
-            unsigned o2 = m_lits[1].index();
-            return (clause_offset)o1 + (((clause_offset)o2) << 32);
-        }        
-#endif
-        return (clause_offset)o1;
+        return m_lits[0].index();
     }
 
     void clause::set_new_offset(clause_offset offset) {
-        m_lits[0] = to_literal(static_cast<unsigned>(offset));
-#if defined(__LP64__) || defined(_WIN64)
-        if (sizeof(offset) == 8) {
-            m_lits[1] = to_literal(static_cast<unsigned>(offset >> 32));
-        }
-#endif
+        m_lits[0] = to_literal(offset);
     }
 
 
@@ -156,51 +133,116 @@ namespace sat {
         }
     }
 
+    static_assert(sizeof(clause) == 4 * sizeof(unsigned), "clause header is four 32 bit words");
+
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
+        m_chunk_used(0),
+        m_alloc_size(0),
+        m_reserved(0) {
+    }
+
+    clause_allocator::~clause_allocator() {
+        finalize();
     }
 
     void clause_allocator::finalize() {
-        m_allocator.reset();
+        for (chunk const& ch : m_chunks)
+            memory::deallocate(ch.m_data);
+        m_chunks.finalize();
+        for (auto& fl : m_free)
+            fl.finalize();
+        for (auto& fl : m_large_free)
+            fl.finalize();
+        m_chunk_used = 0;
+        m_alloc_size = 0;
+        m_reserved = 0;
+    }
+
+    /**
+       \brief allocate a fresh chunk that has room for at least the given number of words.
+       Chunks double in size up to MAX_CHUNK_WORDS. Larger clauses get a chunk of their own.
+     */
+    clause_offset clause_allocator::mk_chunk(unsigned words) {
+        if (m_chunks.size() == MAX_CHUNKS)
+            throw default_exception("clause arena exhausted");
+        unsigned sz = m_chunks.empty() ? MIN_CHUNK_WORDS : std::min(2 * m_chunks.back().m_size, MAX_CHUNK_WORDS);
+        sz = std::max(sz, words);
+        unsigned idx = m_chunks.size();
+        m_chunks.push_back({ static_cast<unsigned*>(memory::allocate(sz * sizeof(unsigned))), sz });
+        m_reserved += sz * sizeof(unsigned);
+        m_chunk_used = words;
+        return idx << OFFSET_BITS;
     }
 
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-        SASSERT(cls_off == reinterpret_cast<clause_offset>(reinterpret_cast<clause*>(cls_off)));
-        return reinterpret_cast<clause *>(cls_off);
+    clause_offset clause_allocator::allocate(unsigned words, unsigned& capacity) {
+        if (words > MAX_CHUNK_WORDS)
+            throw default_exception("clause too large");
+        clause_offset off;
+        unsigned block = words;
+        unsigned k = words < NUM_FREE ? 0 : log2(words - 1) + 1;
+        if (words < NUM_FREE && !m_free[words].empty()) {
+            off = m_free[words].back();
+            m_free[words].pop_back();
+        }
+        else if (words >= NUM_FREE && k < NUM_LARGE_FREE && !m_large_free[k].empty()) {
+            off = m_large_free[k].back();
+            m_large_free[k].pop_back();
+            // the size of a free block is stored in its first word.
+            block = *reinterpret_cast<unsigned*>(get_clause(off));
+            SASSERT(block >= words);
+        }
+        else if (m_chunks.empty() || m_chunk_used + words > m_chunks.back().m_size) {
+            off = mk_chunk(words);
+        }
+        else {
+            off = ((m_chunks.size() - 1) << OFFSET_BITS) | m_chunk_used;
+            m_chunk_used += words;
+        }
+        m_alloc_size += block * sizeof(unsigned);
+        capacity = static_cast<unsigned>((block * sizeof(unsigned) - sizeof(clause)) / sizeof(literal));
+        return off;
     }
 
-    clause_offset clause_allocator::get_offset(clause const * cls) const {
-        SASSERT(cls == reinterpret_cast<clause *>(reinterpret_cast<size_t>(cls)));
-        return reinterpret_cast<size_t>(cls);
+    void clause_allocator::deallocate(clause * cls) {
+        unsigned words = num_words(cls->m_capacity);
+        clause_offset off = get_offset(cls);
+        cls->~clause();
+        m_alloc_size -= words * sizeof(unsigned);
+        *reinterpret_cast<unsigned*>(cls) = words;
+        if (words < NUM_FREE)
+            m_free[words].push_back(off);
+        else
+            m_large_free[log2(words)].push_back(off);
     }
 
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
-        size_t size = clause::get_obj_size(num_lits);
-        void * mem = m_allocator.allocate(size);
-        clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
+        unsigned capacity;
+        clause_offset off = allocate(num_words(num_lits), capacity);
+        clause * cls = new (get_clause(off)) clause(m_id_gen.mk(), num_lits, lits, learned);
+        cls->m_capacity = capacity;
+        cls->m_chunk = off >> OFFSET_BITS;
         TRACE("sat_clause", tout << "alloc: " << cls->id() << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
         return cls;
     }
 
     clause * clause_allocator::copy_clause(clause const& other) {
-        size_t size = clause::get_obj_size(other.size());
-        void * mem = m_allocator.allocate(size);
-        clause * cls = new (mem) clause(m_id_gen.mk(), other.size(), other.m_lits, other.is_learned());
+        unsigned capacity;
+        clause_offset off = allocate(num_words(other.size()), capacity);
+        clause * cls = new (get_clause(off)) clause(m_id_gen.mk(), other.size(), other.m_lits, other.is_learned());
+        cls->m_capacity = capacity;
+        cls->m_chunk = off >> OFFSET_BITS;
         cls->m_reinit_stack = other.on_reinit_stack();
         cls->m_glue   = other.glue();
         cls->m_psm    = other.psm();
         cls->m_frozen = other.frozen();
-        cls->m_approx = other.approx();
         return cls;
     }
 
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat_clause", tout << "delete: " << cls->id() << " " << *cls << "\n";);
         m_id_gen.recycle(cls->id());
-        size_t size = clause::get_obj_size(cls->m_capacity);
-        cls->~clause();
-        m_allocator.deallocate(size, cls);
+        deallocate(cls);
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
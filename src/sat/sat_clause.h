@@ -22,7 +22,6 @@ Revision History:
 #include "util/id_gen.h"
 #include "util/map.h"
 #include "sat/sat_types.h"
-#include "sat/sat_allocator.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4200)
@@ -40,16 +39,22 @@ namespace sat {
     class clause {
         friend class clause_allocator;
         friend class tmp_clause;
+    public:
+        static constexpr unsigned SIZE_BITS  = 26;
+        static constexpr unsigned CHUNK_BITS = 32 - SIZE_BITS;
+        static constexpr unsigned MAX_SIZE   = (1u << SIZE_BITS) - 1;
+    private:
+        // the header takes 16 bytes.
         unsigned           m_id;
-        unsigned           m_size;
-        unsigned           m_capacity;
-        var_approx_set     m_approx;
+        unsigned           m_size:SIZE_BITS;
         unsigned           m_strengthened:1;
         unsigned           m_removed:1;
         unsigned           m_learned:1;
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_capacity:SIZE_BITS;
+        unsigned           m_chunk:CHUNK_BITS;  // arena chunk that holds the clause, see clause_allocator
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
@@ -69,14 +74,12 @@ namespace sat {
         void shrink(unsigned num_lits);
         void restore(unsigned num_lits);
         bool strengthened() const { return m_strengthened; }
-        void mark_strengthened() { m_strengthened = true; update_approx(); }
+        void mark_strengthened() { m_strengthened = true; }
         void unmark_strengthened() { m_strengthened = false; }
         void elim(literal l);
         bool was_removed() const { return m_removed; }
         void set_removed(bool f) { m_removed = f; }
-        var_approx_set approx() const { return m_approx; }
-        void update_approx();
-        bool check_approx() const; // for debugging
+        var_approx_set approx() const { return approx(m_size, m_lits); }
         literal * begin() { return m_lits; }
         literal * end() { return m_lits + m_size; }
         literal const * begin() const { return m_lits; }
@@ -133,17 +136,56 @@ namespace sat {
     };
 
     /**
-       \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       \brief Arena allocator for clauses. It allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+
+       Clauses are bump allocated in chunks of 32 bit words. The high bits of a
+       clause offset select the chunk and the low bits the word within the chunk.
+       Each clause records its chunk, so the offset of a clause is found without a search.
+       Memory of deleted clauses is recycled through free lists. The solver
+       compacts the arena by copying the live clauses into a fresh allocator
+       (see solver::defrag_clauses).
     */
     class clause_allocator {
-        sat_allocator    m_allocator;
-        id_gen           m_id_gen;
+        static constexpr unsigned OFFSET_BITS      = clause::SIZE_BITS;
+        static constexpr unsigned OFFSET_MASK      = (1u << OFFSET_BITS) - 1;
+        static constexpr unsigned MAX_CHUNKS       = 1u << clause::CHUNK_BITS;
+        static constexpr unsigned MIN_CHUNK_WORDS  = 1u << 14;
+        static constexpr unsigned MAX_CHUNK_WORDS  = 1u << OFFSET_BITS;
+        static constexpr unsigned NUM_FREE         = 64;  // exact free lists for blocks of less than NUM_FREE words
+        static constexpr unsigned NUM_LARGE_FREE   = 32;  // free lists for larger blocks, indexed by log2 of the size
+
+        struct chunk {
+            unsigned * m_data;
+            unsigned   m_size;  // in words
+        };
+        svector<chunk>        m_chunks;
+        unsigned              m_chunk_used;   // words used in the last chunk
+        size_t                m_alloc_size;   // bytes used by live clauses
+        size_t                m_reserved;     // bytes reserved by chunks
+        svector<clause_offset> m_free[NUM_FREE];
+        svector<clause_offset> m_large_free[NUM_LARGE_FREE];
+        id_gen                m_id_gen;
+
+        static unsigned num_words(unsigned num_lits) { return static_cast<unsigned>(clause::get_obj_size(num_lits) / sizeof(unsigned)); }
+        clause_offset allocate(unsigned words, unsigned& capacity);
+        clause_offset mk_chunk(unsigned words);
+        void deallocate(clause * cls);
     public:
         clause_allocator();
+        ~clause_allocator();
         void          finalize();
-        size_t        get_allocation_size() const { return m_allocator.get_allocation_size(); }
-        clause *      get_clause(clause_offset cls_off) const;
-        clause_offset get_offset(clause const * ptr) const;
+        size_t        get_allocation_size() const { return m_alloc_size; }
+        size_t        get_reserved_size() const { return m_reserved; }
+        clause *      get_clause(clause_offset cls_off) const {
+            SASSERT((cls_off >> OFFSET_BITS) < m_chunks.size());
+            return reinterpret_cast<clause *>(m_chunks[cls_off >> OFFSET_BITS].m_data + (cls_off & OFFSET_MASK));
+        }
+        clause_offset get_offset(clause const * cls) const {
+            chunk const& ch = m_chunks[cls->m_chunk];
+            clause_offset off = (cls->m_chunk << OFFSET_BITS) | static_cast<unsigned>(reinterpret_cast<unsigned const*>(cls) - ch.m_data);
+            SASSERT(get_clause(off) == cls);
+            return off;
+        }
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         clause *      copy_clause(clause const& other);
         void          del_clause(clause * cls);
@@ -65,6 +65,7 @@ namespace sat {
                     TRACE("cleanup_bug", tout << "keeping: " << ~to_literal(l_idx) << " " << it2->get_literal() << "\n";);
                     break;
                 case watched::CLAUSE:
+                case watched::TERNARY:
                     // skip
                     break;
                 case watched::EXT_CONSTRAINT:
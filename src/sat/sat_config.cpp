@@ -94,6 +94,11 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_threads     = p.threads();
+        m_par_max_glue    = p.par_max_glue();
+        m_par_max_size    = p.par_max_size();
+        m_par_buffer_size = p.par_buffer_size();
+        m_cube_and_conquer = p.cube_and_conquer();
+        m_cube_and_conquer_conflicts = std::max(1u, p.cube_and_conquer_conflicts());
         m_ddfw_search     = p.ddfw_search();
         m_ddfw_threads    = p.ddfw_threads();
         m_prob_search     = p.prob_search();
@@ -104,6 +109,7 @@ namespace sat {
         else
             m_local_search_mode = local_search_mode::wsat;
         m_local_search_dbg_flips = p.local_search_dbg_flips();
+        m_local_search_simd = p.local_search_simd();
         //m_binspr            = p.binspr();
         m_binspr            = false;     // prevent adventurous users from trying feature that isn't ready
         m_anf_simplify      = p.anf();
@@ -197,6 +203,7 @@ namespace sat {
         m_drat_check_unsat  = p.drat_check_unsat();
         m_drat_check_sat  = p.drat_check_sat();
         m_drat_file       = p.drat_file();
+        m_profile_file    = p.profile_file();
         m_smt_proof_check = p.smt_proof_check();
         m_smt_proof_check_rup = p.smt_proof_check_rup();
         m_drat_disable = p.drat_disable();
@@ -209,6 +216,8 @@ namespace sat {
              m_smt_proof_check ||
              m_drat_check_sat);
         m_drat_binary     = p.drat_binary();
+        m_drat_async      = p.drat_async();
+        m_drat_lrat       = p.drat_lrat();
         m_drat_activity   = p.drat_activity();
         m_dyn_sub_res     = p.dyn_sub_res();
 
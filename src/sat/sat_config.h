@@ -111,6 +111,11 @@ namespace sat {
         bool               m_enable_pre_simplify;
         unsigned           m_max_conflicts;
         unsigned           m_num_threads;
+        unsigned           m_par_max_glue;
+        unsigned           m_par_max_size;
+        unsigned           m_par_buffer_size;
+        bool               m_cube_and_conquer;
+        unsigned           m_cube_and_conquer_conflicts;
         bool               m_ddfw_search;
         unsigned           m_ddfw_threads;
         bool               m_prob_search;
@@ -118,6 +123,7 @@ namespace sat {
         bool               m_local_search;
         local_search_mode  m_local_search_mode;
         bool               m_local_search_dbg_flips;
+        bool               m_local_search_simd;
         bool               m_binspr;
         bool               m_cut_simplify;
         unsigned           m_cut_delay;
@@ -177,7 +183,10 @@ namespace sat {
         bool               m_drat;
         bool               m_drat_disable;
         bool               m_drat_binary;
+        bool               m_drat_async;
+        bool               m_drat_lrat;
         symbol             m_drat_file;
+        symbol             m_profile_file;
         bool               m_smt_proof_check;
         bool               m_smt_proof_check_rup;
         bool               m_drat_check_unsat;
@@ -0,0 +1,412 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_cube_and_conquer.cpp
+
+Abstract:
+
+    Work-stealing cube and conquer for the SAT solver.
+
+--*/
+#include "sat/sat_cube_and_conquer.h"
+#include "sat/sat_solver.h"
+#include "sat/sat_lookahead.h"
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
+
+namespace sat {
+
+    void cube_and_conquer::cube_deque::push(cube&& c) {
+        lock_guard lock(m_mux);
+        m_cubes.push_back(std::move(c));
+    }
+
+    bool cube_and_conquer::cube_deque::pop_back(cube& c) {
+        lock_guard lock(m_mux);
+        if (m_head == m_cubes.size())
+            return false;
+        c = std::move(m_cubes.back());
+        m_cubes.pop_back();
+        if (m_head == m_cubes.size()) {
+            m_cubes.reset();
+            m_head = 0;
+        }
+        return true;
+    }
+
+    bool cube_and_conquer::cube_deque::pop_front(cube& c) {
+        lock_guard lock(m_mux);
+        if (m_head == m_cubes.size())
+            return false;
+        c = std::move(m_cubes[m_head++]);
+        if (m_head == m_cubes.size()) {
+            m_cubes.reset();
+            m_head = 0;
+        }
+        return true;
+    }
+
+    cube_and_conquer::cube_and_conquer(solver& s):
+        m_solver(s),
+        m_par(s),
+        m_num_threads(std::max(2u, s.get_config().m_num_threads)),
+        m_max_conflicts(s.get_config().m_max_conflicts) {
+    }
+
+    solver& cube_and_conquer::get_solver(unsigned i) {
+        return i + 1 == m_num_threads ? m_solver : m_par.get_solver(i);
+    }
+
+    unsigned cube_and_conquer::budget(cube const& c) const {
+        return m_solver.get_config().m_cube_and_conquer_conflicts;
+    }
+
+    /**
+       \brief take the conflicts for solving c from what is left of sat.max_conflicts.
+       Returns 0 when sat.max_conflicts is used up.
+     */
+    unsigned cube_and_conquer::reserve(cube const& c) {
+        lock_guard lock(m_mux);
+        unsigned left = m_max_conflicts > m_conflicts ? m_max_conflicts - m_conflicts : 0;
+        unsigned b = std::min(budget(c), left);
+        m_conflicts += b;
+        return b;
+    }
+
+    /**
+       \brief replace the reserved conflicts by the conflicts used.
+       The solver stops one conflict after its budget.
+     */
+    void cube_and_conquer::settle(unsigned reserved, unsigned used) {
+        lock_guard lock(m_mux);
+        m_conflicts = m_conflicts - reserved + used;
+    }
+
+    bool cube_and_conquer::is_done() {
+        lock_guard lock(m_mux);
+        return m_done;
+    }
+
+    /**
+       \brief retrieve the next cube for thread id.
+       Take the most recent cube of the thread's own deque, otherwise steal
+       the oldest cube from another thread. Wait while other threads are
+       still working on cubes that may be split.
+     */
+    bool cube_and_conquer::next_cube(unsigned id, random_gen& rand, cube& c) {
+        while (true) {
+            unsigned num_pushed;
+            {
+                lock_guard lock(m_mux);
+                if (m_done)
+                    return false;
+                num_pushed = m_num_pushed;
+            }
+            if (m_deques[id]->pop_back(c))
+                return true;
+            unsigned offset = rand();
+            for (unsigned i = 0; i < m_num_threads; ++i) {
+                unsigned victim = (i + offset) % m_num_threads;
+                if (victim != id && m_deques[victim]->pop_front(c)) {
+                    ++m_stats[id].m_steals;
+                    return true;
+                }
+            }
+#ifndef SINGLE_THREAD
+            // cubes pushed after num_pushed was read are not missed.
+            std::unique_lock<std::mutex> lock(m_mux);
+            m_cond.wait(lock, [&]() { return m_done || m_num_pushed != num_pushed; });
+#endif
+        }
+    }
+
+    void cube_and_conquer::push(unsigned id, cube&& c) {
+        m_deques[id]->push(std::move(c));
+        {
+            lock_guard lock(m_mux);
+            ++m_num_pushed;
+        }
+#ifndef SINGLE_THREAD
+        m_cond.notify_all();
+#endif
+    }
+
+    void cube_and_conquer::set_result(unsigned id, lbool r) {
+        {
+            lock_guard lock(m_mux);
+            if (m_done)
+                return;
+            m_done = true;
+            m_result = r;
+            m_finished_id = id;
+        }
+#ifndef SINGLE_THREAD
+        m_cond.notify_all();
+#endif
+        cancel(id);
+    }
+
+    /**
+       \brief stop the other threads. The main solver is stopped through its
+       resource limit, which also stops the solvers of the other threads.
+     */
+    void cube_and_conquer::cancel(unsigned id) {
+        for (unsigned j = 0; j + 1 < m_num_threads; ++j)
+            if (j != id)
+                m_par.cancel_solver(j);
+        if (id + 1 != m_num_threads)
+            m_solver.rlimit().cancel();
+    }
+
+    /**
+       \brief the cube c was refuted by solver s.
+       The negation of the core is a valid lemma. If the core only uses
+       assumptions, the problem is unsatisfiable under the assumptions.
+       Otherwise the assumptions in the core contribute to the final core.
+     */
+    void cube_and_conquer::refuted(unsigned id, solver& s, cube const& c) {
+        ++m_stats[id].m_refuted;
+        literal_vector const& core = s.get_core();
+        bool uses_cube = false;
+        for (literal l : core) 
+            uses_cube |= c.m_lits.contains(l);
+        if (!uses_cube) {
+            {
+                lock_guard lock(m_mux);
+                m_core.reset();
+                m_core.append(core);
+            }
+            set_result(id, l_false);
+            return;
+        }
+        s.pop_to_base_level();
+        literal_vector lemma;
+        for (literal l : core)
+            lemma.push_back(~l);
+        s.mk_clause(lemma.size(), lemma.data(), sat::status::redundant());
+        bool all_refuted = false;
+        {
+            lock_guard lock(m_mux);
+            for (literal l : core)
+                if (!c.m_lits.contains(l) && !m_core.contains(l))
+                    m_core.push_back(l);
+            SASSERT(m_num_open > 0);
+            all_refuted = 0 == --m_num_open;
+        }
+        if (all_refuted)
+            set_result(id, l_false);
+    }
+
+    /**
+       \brief split cube c that exceeded its conflict budget on the literal selected 
+       by lookahead under the cube and the assumptions. The lookahead solver copies 
+       the clauses of s, including the clauses learned while solving the cube.
+       If there is no literal to split on, the cube is solved again with a new 
+       budget and the clauses learned so far.
+     */
+    void cube_and_conquer::split(unsigned id, solver& s, cube& c) {
+        s.pop_to_base_level();
+        literal l = null_literal;
+        if (c.m_splits != UINT_MAX) {
+            literal_vector asms(m_assumptions);
+            asms.append(c.m_lits);
+            lookahead lh(s);
+            l = lh.select_lookahead(asms, bool_var_vector());
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat.cube-and-conquer :thread " << id << " :split " << c.m_lits.size() << " :on " << l << ")\n";);
+        if (l == null_literal) {
+            c.m_splits = UINT_MAX;
+            push(id, std::move(c));
+            return;
+        }
+        ++m_stats[id].m_splits;
+        {
+            lock_guard lock(m_mux);
+            ++m_num_open;
+        }
+        cube c2;
+        c2.m_lits.append(c.m_lits);
+        c2.m_lits.push_back(~l);
+        c2.m_splits = c.m_splits + 1;
+        c.m_lits.push_back(l);
+        c.m_splits++;
+        push(id, std::move(c2));
+        push(id, std::move(c));
+    }
+
+    /**
+       \brief split the empty cube using lookahead until there are at least
+       two cubes per thread and distribute the cubes round-robin.
+     */
+    void cube_and_conquer::init_cubes() {
+        vector<cube> cubes;
+        cubes.push_back(cube());
+        unsigned head = 0;
+        while (head < cubes.size() && cubes.size() - head < 2 * m_num_threads) {
+            cube c = cubes[head++];
+            literal_vector asms(m_assumptions);
+            asms.append(c.m_lits);
+            lookahead lh(m_solver);
+            literal l = lh.select_lookahead(asms, bool_var_vector());
+            if (l == null_literal) {
+                c.m_splits = UINT_MAX;
+                cubes.push_back(c);
+                break;
+            }
+            cube c2 = c;
+            c.m_lits.push_back(l);
+            c2.m_lits.push_back(~l);
+            cubes.push_back(c);
+            cubes.push_back(c2);
+        }
+        m_num_open = cubes.size() - head;
+        for (unsigned i = head; i < cubes.size(); ++i)
+            m_deques[(i - head) % m_num_threads]->push(std::move(cubes[i]));
+    }
+
+    void cube_and_conquer::run(unsigned id) {
+        solver& s = get_solver(id);
+        random_gen rand(id + 1);
+        cube c;
+        try {
+            while (next_cube(id, rand, c)) {
+                ++m_stats[id].m_cubes;
+                s.pop_to_base_level();
+                s.exchange_par();
+                literal_vector asms(m_assumptions);
+                asms.append(c.m_lits);
+                unsigned b = reserve(c);
+                if (b == 0) {
+                    // sat.max_conflicts is used up
+                    set_result(id, l_undef);
+                    return;
+                }
+                lbool r;
+                unsigned num_conflicts = s.m_stats.m_conflict;
+                {
+                    flet<unsigned> _max_conflicts(s.m_config.m_max_conflicts, b);
+                    r = s.check(asms.size(), asms.data());
+                }
+                settle(b, s.m_stats.m_conflict - num_conflicts);
+                if (is_done())
+                    break;
+                switch (r) {
+                case l_true:
+                    set_result(id, l_true);
+                    break;
+                case l_false:
+                    refuted(id, s, c);
+                    break;
+                default:
+                    if (!s.rlimit().inc() || b < budget(c)) {
+                        // the solver was canceled or used up sat.max_conflicts.
+                        set_result(id, l_undef);
+                        return;
+                    }
+                    split(id, s, c);
+                    break;
+                }
+            }
+        }
+        catch (z3_error & err) {
+            {
+                lock_guard lock(m_mux);
+                m_error_code = err.error_code();
+                m_has_exception = true;
+            }
+            set_result(id, l_undef);
+        }
+        catch (z3_exception & ex) {
+            {
+                lock_guard lock(m_mux);
+                m_ex_msg = ex.msg();
+                m_has_exception = true;
+            }
+            set_result(id, l_undef);
+        }
+    }
+
+#ifdef SINGLE_THREAD
+    lbool cube_and_conquer::operator()(unsigned num_lits, literal const* lits) {
+        return l_undef;
+    }
+#else
+    lbool cube_and_conquer::operator()(unsigned num_lits, literal const* lits) {
+        solver& s = m_solver;
+        m_assumptions.append(num_lits, lits);
+        m_par.reserve(m_num_threads, s.get_config().m_par_buffer_size);
+        m_par.init_solvers(s, m_num_threads - 1);
+        for (unsigned i = 0; i < m_num_threads; ++i)
+            m_deques.push_back(alloc(cube_deque));
+        m_stats.resize(m_num_threads);
+        // cubes move between the threads, so no thread may eliminate a variable
+        // that another thread uses in a cube.
+        bool_vector external(s.m_external);
+        for (unsigned i = 0; i < m_num_threads; ++i) {
+            solver& t = get_solver(i);
+            for (bool_var v = 0; v < t.num_vars(); ++v)
+                t.set_external(v);
+        }
+        try {
+            init_cubes();
+        }
+        catch (...) {
+            s.set_par(nullptr, 0);
+            for (bool_var v = 0; v < external.size(); ++v)
+                s.m_external[v] = external[v];
+            throw;
+        }
+
+        bool canceled = !s.rlimit().inc();
+        vector<std::thread> threads(m_num_threads);
+        for (unsigned i = 0; i < m_num_threads; ++i)
+            threads[i] = std::thread([&, i]() { run(i); });
+        for (auto & th : threads)
+            th.join();
+
+        if (!canceled)
+            s.rlimit().reset_cancel();
+
+        lbool result = m_result;
+        unsigned main_id = m_num_threads - 1;
+        if (result == l_true && m_finished_id != static_cast<int>(main_id))
+            s.set_model(get_solver(m_finished_id).get_model(), true);
+        if (result == l_false) {
+            s.m_core.reset();
+            s.m_core.append(m_core);
+        }
+        collect_statistics(s.m_aux_stats);
+        s.set_par(nullptr, 0);
+        for (bool_var v = 0; v < external.size(); ++v)
+            s.m_external[v] = external[v];
+        if (result == l_undef && m_has_exception) {
+            if (m_ex_msg.empty())
+                throw z3_error(m_error_code);
+            throw default_exception(std::move(m_ex_msg));
+        }
+        return result;
+    }
+#endif
+
+    void cube_and_conquer::collect_statistics(statistics& st) const {
+        stats total;
+        for (unsigned i = 0; i < m_stats.size(); ++i) {
+            stats const& s = m_stats[i];
+            IF_VERBOSE(1, verbose_stream() << "(sat.cube-and-conquer :thread " << i
+                       << " :cubes " << s.m_cubes << " :refuted " << s.m_refuted
+                       << " :splits " << s.m_splits << " :steals " << s.m_steals << ")\n";);
+            total.m_cubes += s.m_cubes;
+            total.m_refuted += s.m_refuted;
+            total.m_splits += s.m_splits;
+            total.m_steals += s.m_steals;
+        }
+        st.update("sat cc cubes", total.m_cubes);
+        st.update("sat cc refuted", total.m_refuted);
+        st.update("sat cc splits", total.m_splits);
+        st.update("sat cc steals", total.m_steals);
+        st.update("sat cc conflicts", m_conflicts);
+    }
+};
@@ -0,0 +1,106 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_cube_and_conquer.h
+
+Abstract:
+
+    Work-stealing cube and conquer for the SAT solver.
+
+    Each thread owns a deque of cubes. It solves cubes from the back of
+    its own deque under a conflict budget and steals from the front of
+    the deques of other threads when its own deque runs dry.
+    The initial cubes are created with lookahead. Cubes that exceed
+    their budget are split on the literal that lookahead selects under
+    the cube, and the two sub-cubes are pushed back on the deque of the
+    thread. sat.max_conflicts bounds the conflicts of all cubes together.
+    Idle threads wait until a cube is pushed or the search ends.
+    Units and learned clauses are exchanged through sat::parallel.
+
+--*/
+#pragma once
+
+#include "sat/sat_types.h"
+#include "sat/sat_parallel.h"
+#include "util/mutex.h"
+#include "util/statistics.h"
+#ifndef SINGLE_THREAD
+#include <condition_variable>
+#endif
+
+namespace sat {
+
+    class solver;
+
+    class cube_and_conquer {
+
+        struct cube {
+            literal_vector m_lits;
+            unsigned       m_splits { 0 };   // UINT_MAX if lookahead finds no literal to split on
+        };
+
+        // cubes owned by a worker. The owner works at the back,
+        // thieves take the (shallower) cubes at the front.
+        struct cube_deque {
+            mutex          m_mux;
+            vector<cube>   m_cubes;
+            unsigned       m_head { 0 };
+            void push(cube&& c);
+            bool pop_back(cube& c);
+            bool pop_front(cube& c);
+        };
+
+        struct stats {
+            unsigned m_cubes { 0 };
+            unsigned m_refuted { 0 };
+            unsigned m_splits { 0 };
+            unsigned m_steals { 0 };
+        };
+
+        solver&                       m_solver;
+        parallel                      m_par;
+        unsigned                      m_num_threads;
+        scoped_ptr_vector<cube_deque> m_deques;
+        svector<stats>                m_stats;
+        literal_vector                m_assumptions;
+        unsigned                      m_max_conflicts;
+        mutex                         m_mux;         // guards the fields below
+#ifndef SINGLE_THREAD
+        std::condition_variable       m_cond;        // signaled when a cube is pushed or the search ends
+#endif
+        unsigned                      m_num_pushed { 0 };
+        unsigned                      m_conflicts { 0 };   // conflicts reserved for or used by cubes
+        bool                          m_done { false };
+        unsigned                      m_num_open { 0 };
+        lbool                         m_result { l_undef };
+        int                           m_finished_id { -1 };
+        literal_vector                m_core;
+        std::string                   m_ex_msg;
+        unsigned                      m_error_code { 0 };
+        bool                          m_has_exception { false };
+
+        solver& get_solver(unsigned i);
+        bool is_done();
+        bool next_cube(unsigned id, random_gen& rand, cube& c);
+        void push(unsigned id, cube&& c);
+        void split(unsigned id, solver& s, cube& c);
+        void refuted(unsigned id, solver& s, cube const& c);
+        void set_result(unsigned id, lbool r);
+        void cancel(unsigned id);
+        void init_cubes();
+        void run(unsigned id);
+        unsigned budget(cube const& c) const;
+        unsigned reserve(cube const& c);
+        void settle(unsigned reserved, unsigned used);
+
+    public:
+
+        cube_and_conquer(solver& s);
+
+        lbool operator()(unsigned num_lits, literal const* lits);
+
+        void collect_statistics(statistics& st) const;
+    };
+};
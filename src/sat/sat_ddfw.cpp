@@ -29,24 +29,37 @@
 #include "sat/sat_ddfw.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_params.hpp"
+#include "sat/sat_simd.h"
+#ifndef SINGLE_THREAD
+#include <thread>
+#endif
 
 namespace sat {
 
     ddfw::~ddfw() {
-        for (auto& ci : m_clauses) {
-            m_alloc.del_clause(ci.m_clause);
+        if (m_master && m_master != this)
+            return; // the clauses are owned by the master
+        for (clause* cls : m_clauses) {
+            m_alloc.del_clause(cls);
         }
     }
 
 
     lbool ddfw::check(unsigned sz, literal const* assumptions, parallel* p) {
         init(sz, assumptions);
+        if (m_config.m_num_threads > 1 && !p)
+            return check_mt();
         flet<parallel*> _p(m_par, p);
+        return search();
+    }
+
+    lbool ddfw::search() {
         while (m_limit.inc() && m_min_sz > 0) {
             if (should_reinit_weights()) do_reinit_weights();
             else if (do_flip()) ;
             else if (should_restart()) do_restart();
             else if (should_parallel_sync()) do_parallel_sync();
+            else if (should_sync_weights()) do_sync_weights();
             else shift_weights();                       
         }
         return m_min_sz == 0 ? l_true : l_undef;
@@ -86,6 +99,11 @@ namespace sat {
     }
 
     bool_var ddfw::pick_var() {
+        if (m_master) {
+            bool_var v = pick_block_var();
+            if (v != null_bool_var)
+                return v;
+        }
         double sum_pos = 0;
         unsigned n = 1;
         bool_var v0 = null_bool_var;
@@ -129,7 +147,10 @@ namespace sat {
     void ddfw::add(unsigned n, literal const* c) {        
         clause* cls = m_alloc.mk_clause(n, c, false);
         unsigned idx = m_clauses.size();
-        m_clauses.push_back(clause_info(cls, m_config.m_init_clause_weight));
+        m_clauses.push_back(cls);
+        m_weights.push_back(m_config.m_init_clause_weight);
+        m_trues.push_back(0);
+        m_num_trues.push_back(0);
         for (literal lit : *cls) {
             m_use_list.reserve(2*(lit.var()+1));
             m_vars.reserve(lit.var()+1);
@@ -138,10 +159,13 @@ namespace sat {
     }
 
     void ddfw::add(solver const& s) {
-        for (auto& ci : m_clauses) {
-            m_alloc.del_clause(ci.m_clause);
+        for (clause* cls : m_clauses) {
+            m_alloc.del_clause(cls);
         }
         m_clauses.reset(); 
+        m_weights.reset();
+        m_trues.reset();
+        m_num_trues.reset();
         m_use_list.reset();
         m_num_non_binary_clauses = 0;
 
@@ -179,12 +203,16 @@ namespace sat {
         m_assumptions.reset();
         m_assumptions.append(sz, assumptions);
         add_assumptions();
+        flatten_use_list();
+        init_search();
+    }
+
+    void ddfw::init_search() {
         for (unsigned v = 0; v < num_vars(); ++v) {
             literal lit(v, false), nlit(v, true);
             value(v) = (m_rand() % 2) == 0; // m_use_list[lit.index()].size() >= m_use_list[nlit.index()].size();
         }
         init_clause_data();
-        flatten_use_list();
 
         m_reinit_count = 0;
         m_reinit_next = m_config.m_reinit_base;
@@ -195,6 +223,9 @@ namespace sat {
         m_parsync_count = 0;
         m_parsync_next = m_config.m_parsync_base;
 
+        m_sync_count = 0;
+        m_sync_next = m_config.m_weight_sync_base;
+
         m_min_sz = m_unsat.size();
         m_flips = 0;
         m_last_flips = 0;
@@ -224,6 +255,8 @@ namespace sat {
             m_flat_use_list.append(ul);
         }
         m_use_list_index.push_back(m_flat_use_list.size());
+        m_use_data = m_flat_use_list.data();
+        m_use_index = m_use_list_index.data();
     }
 
 
@@ -232,76 +265,161 @@ namespace sat {
         literal lit = literal(v, !value(v));
         literal nlit = ~lit;
         SASSERT(is_true(lit));
-        for (unsigned cls_idx : use_list(*this, lit)) {
-            clause_info& ci = m_clauses[cls_idx];
-            ci.del(lit);
-            unsigned w = ci.m_weight;
-            // cls becomes false: flip any variable in clause to receive reward w
-            switch (ci.m_num_trues) {
-            case 0: {
-                m_unsat.insert(cls_idx);
-                clause const& c = get_clause(cls_idx);
-                for (literal l : c) {
-                    inc_reward(l, w);
-                    inc_make(l);
-                }
-                inc_reward(lit, w);
-                break;
-                }
-            case 1:
-                dec_reward(to_literal(ci.m_trues), w);
-                break;
-            default:
-                break;
+        use_list ul(*this, lit);
+        unsigned const* it = ul.begin(), * end = ul.end();
+#ifdef SAT_AVX2
+        if (m_config.m_simd)
+            it = del_trues_simd(lit, it, end);
+#endif
+        for (; it != end; ++it) {
+            unsigned cls_idx = *it;
+            del_true(cls_idx, lit);
+            if (m_num_trues[cls_idx] <= 1)
+                make_false(lit, cls_idx);
+        }
+        use_list nul(*this, nlit);
+        it = nul.begin(), end = nul.end();
+#ifdef SAT_AVX2
+        if (m_config.m_simd)
+            it = add_trues_simd(nlit, it, end);
+#endif
+        for (; it != end; ++it) {
+            unsigned cls_idx = *it;
+            if (m_num_trues[cls_idx] <= 1)
+                make_true(nlit, cls_idx);
+            add_true(cls_idx, nlit);
+        }
+        value(v) = !value(v);
+    }
+
+    /**
+       \brief update rewards after lit became false in cls_idx, 
+       and the clause has at most one true literal left.
+     */
+    void ddfw::make_false(literal lit, unsigned cls_idx) {
+        unsigned w = m_weights[cls_idx];
+        // cls becomes false: flip any variable in clause to receive reward w
+        if (m_num_trues[cls_idx] == 0) {
+            m_unsat.insert(cls_idx);
+            for (literal l : get_clause(cls_idx)) {
+                inc_reward(l, w);
+                inc_make(l);
+            }
+            inc_reward(lit, w);
+        }
+        else {
+            SASSERT(m_num_trues[cls_idx] == 1);
+            dec_reward(to_literal(m_trues[cls_idx]), w);
+        }
+    }
+
+    /**
+       \brief update rewards before lit becomes true in cls_idx, 
+       where the clause has at most one true literal.
+     */
+    void ddfw::make_true(literal lit, unsigned cls_idx) {
+        unsigned w = m_weights[cls_idx];
+        if (m_num_trues[cls_idx] == 0) {
+            m_unsat.remove(cls_idx);
+            for (literal l : get_clause(cls_idx)) {
+                dec_reward(l, w);
+                dec_make(l);
             }
+            dec_reward(lit, w);
         }
-        for (unsigned cls_idx : use_list(*this, nlit)) {
-            clause_info& ci = m_clauses[cls_idx];             
-            unsigned w = ci.m_weight;
+        else {
             // the clause used to have a single true (pivot) literal, now it has two.
             // Then the previous pivot is no longer penalized for flipping.
-            switch (ci.m_num_trues) {
-            case 0: {
-                m_unsat.remove(cls_idx);   
-                clause const& c = get_clause(cls_idx);
-                for (literal l : c) {
-                    dec_reward(l, w);
-                    dec_make(l);
-                }
-                dec_reward(nlit, w);
-                break;
+            SASSERT(m_num_trues[cls_idx] == 1);
+            inc_reward(to_literal(m_trues[cls_idx]), w);
+        }
+    }
+
+#ifdef SAT_AVX2
+    /**
+       \brief decrement the true literal counts of the clauses in [it, end) 8 at a time.
+       The counts are gathered and compared in AVX2 registers, only the clauses that 
+       end up with at most one true literal are processed further.
+       Clauses occur at most once in a use list, so the stores do not overlap.
+       Returns the position of the remaining tail that is handled by the scalar loop.
+     */
+    SAT_AVX2_TARGET unsigned const* ddfw::del_trues_simd(literal lit, unsigned const* it, unsigned const* end) {
+        int const* num_trues = reinterpret_cast<int const*>(m_num_trues.data());
+        __m256i const one = _mm256_set1_epi32(1);
+        __m256i const two = _mm256_set1_epi32(2);
+        alignas(32) unsigned counts[8];
+        for (; end - it >= 8; it += 8) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(it));
+            __m256i n = _mm256_sub_epi32(_mm256_i32gather_epi32(num_trues, idx, 4), one);
+            unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(two, n)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(counts), n);
+            for (unsigned k = 0; k < 8; ++k) {
+                SASSERT(m_num_trues[it[k]] > 0);
+                m_num_trues[it[k]] = counts[k];
+                m_trues[it[k]] -= lit.index();
             }
-            case 1:
-                inc_reward(to_literal(ci.m_trues), w);
-                break;
-            default:
-                break;
+            for (unsigned k = 0; mask; ++k, mask >>= 1)
+                if (mask & 1)
+                    make_false(lit, it[k]);
+        }
+        return it;
+    }
+
+    /**
+       \brief increment the true literal counts of the clauses in [it, end) 8 at a time.
+       Rewards are updated before the counts, for clauses that had at most one true literal.
+     */
+    SAT_AVX2_TARGET unsigned const* ddfw::add_trues_simd(literal lit, unsigned const* it, unsigned const* end) {
+        int const* num_trues = reinterpret_cast<int const*>(m_num_trues.data());
+        __m256i const one = _mm256_set1_epi32(1);
+        __m256i const two = _mm256_set1_epi32(2);
+        alignas(32) unsigned counts[8];
+        for (; end - it >= 8; it += 8) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(it));
+            __m256i n = _mm256_i32gather_epi32(num_trues, idx, 4);
+            unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(two, n)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(counts), _mm256_add_epi32(n, one));
+            for (unsigned k = 0; mask; ++k, mask >>= 1)
+                if (mask & 1)
+                    make_true(lit, it[k]);
+            for (unsigned k = 0; k < 8; ++k) {
+                m_num_trues[it[k]] = counts[k];
+                m_trues[it[k]] += lit.index();
             }
-            ci.add(nlit);
         }
-        value(v) = !value(v);
+        return it;
+    }
+#else
+    unsigned const* ddfw::del_trues_simd(literal lit, unsigned const* it, unsigned const* end) {
+        return it;
+    }
+
+    unsigned const* ddfw::add_trues_simd(literal lit, unsigned const* it, unsigned const* end) {
+        return it;
     }
+#endif
 
     bool ddfw::should_reinit_weights() {
         return m_flips >= m_reinit_next;
     }
 
     void ddfw::do_reinit_weights() {
-        log();
+        if (m_thread_id == 0)
+            log();
 
+        unsigned sz = m_weights.size();
+        unsigned* weights = m_weights.data();
+        unsigned const* num_trues = m_num_trues.data();
         if (m_reinit_count % 2 == 0) { 
-            for (auto& ci : m_clauses) {
-                ci.m_weight += 1;                
+            for (unsigned i = 0; i < sz; ++i) {
+                weights[i] += 1;                
             }
         }
         else {
-            for (auto& ci : m_clauses) {
-                if (ci.is_true()) {
-                    ci.m_weight = m_config.m_init_clause_weight;
-                }
-                else {
-                    ci.m_weight = m_config.m_init_clause_weight + 1;
-                }                
+            // branch free, so that the loop is vectorized
+            unsigned w = m_config.m_init_clause_weight;
+            for (unsigned i = 0; i < sz; ++i) {
+                weights[i] = w + (num_trues[i] == 0);
             }
         }
         init_clause_data();   
@@ -318,25 +436,24 @@ namespace sat {
         m_unsat.reset();
         unsigned sz = m_clauses.size();
         for (unsigned i = 0; i < sz; ++i) {
-            auto& ci = m_clauses[i];
             clause const& c = get_clause(i);
-            ci.m_trues = 0;
-            ci.m_num_trues = 0;
+            m_trues[i] = 0;
+            m_num_trues[i] = 0;
             for (literal lit : c) {
                 if (is_true(lit)) {
-                    ci.add(lit);
+                    add_true(i, lit);
                 }
             }
-            switch (ci.m_num_trues) {
+            switch (m_num_trues[i]) {
             case 0:
                 for (literal lit : c) {
-                    inc_reward(lit, ci.m_weight);
+                    inc_reward(lit, m_weights[i]);
                     inc_make(lit);
                 }
                 m_unsat.insert(i);
                 break;
             case 1:
-                dec_reward(to_literal(ci.m_trues), ci.m_weight);
+                dec_reward(to_literal(m_trues[i]), m_weights[i]);
                 break;
             default:
                 break;
@@ -403,6 +520,159 @@ namespace sat {
         m_parsync_next /= 2;
     }
 
+    /**
+       \brief initialize a worker thread of multi-threaded search.
+       The worker shares the clauses and use lists of the master and
+       starts from its own random assignment.
+     */
+    void ddfw::init_worker(ddfw& master, unsigned id) {
+        m_master = &master;
+        m_thread_id = id;
+        m_config = master.m_config;
+        m_clauses = master.m_clauses;
+        m_weights = master.m_weights;
+        m_trues.resize(m_clauses.size(), 0);
+        m_num_trues.resize(m_clauses.size(), 0);
+        m_vars.resize(master.num_vars());
+        m_num_non_binary_clauses = master.m_num_non_binary_clauses;
+        m_use_data = master.m_use_data;
+        m_use_index = master.m_use_index;
+        init_search();
+        set_block(0);
+    }
+
+    /**
+       \brief the variables are partitioned into one block per thread.
+       The block of a thread rotates with every weight exchange.
+     */
+    void ddfw::set_block(unsigned epoch) {
+        uint64_t n = m_config.m_num_threads;
+        uint64_t b = (m_thread_id + epoch) % n;
+        m_block_lo = static_cast<bool_var>(b * num_vars() / n);
+        m_block_hi = static_cast<bool_var>((b + 1) * num_vars() / n);
+    }
+
+    /**
+       \brief pick a variable with positive reward from the block of the thread.
+     */
+    bool_var ddfw::pick_block_var() {
+        double sum_pos = 0;
+        for (bool_var v : m_unsat_vars) 
+            if (m_block_lo <= v && v < m_block_hi && reward(v) > 0) 
+                sum_pos += score(reward(v));
+        if (sum_pos == 0)
+            return null_bool_var;
+        double lim_pos = ((double) m_rand() / (1.0 + m_rand.max_value())) * sum_pos;
+        for (bool_var v : m_unsat_vars) {
+            if (m_block_lo <= v && v < m_block_hi && reward(v) > 0) {
+                lim_pos -= score(reward(v));
+                if (lim_pos <= 0)
+                    return v;
+            }
+        }
+        return null_bool_var;
+    }
+
+    bool ddfw::should_sync_weights() {
+        return m_master != nullptr && m_flips >= m_sync_next;
+    }
+
+    /**
+       \brief blend the clause weights of the thread with the weights shared by all threads.
+     */
+    void ddfw::do_sync_weights() {
+        {
+            lock_guard lock(m_master->m_mux);
+            unsigned_vector& shared = m_master->m_shared_weights;
+            unsigned sz = m_weights.size();
+            unsigned* weights = m_weights.data();
+            unsigned* shared_weights = shared.data();
+            for (unsigned i = 0; i < sz; ++i) {
+                unsigned w = (shared_weights[i] + weights[i] + 1) / 2;
+                shared_weights[i] = w;
+                weights[i] = w;
+            }
+        }
+        init_clause_data();
+        ++m_sync_count;
+        m_sync_next = m_flips + m_config.m_weight_sync_base;
+        set_block(m_sync_count);
+    }
+
+    void ddfw::set_winner() {
+        {
+            lock_guard lock(m_master->m_mux);
+            if (m_master->m_winner != -1)
+                return;
+            m_master->m_winner = m_thread_id;
+        }
+        m_master->m_limit.cancel();
+    }
+
+#ifdef SINGLE_THREAD
+    lbool ddfw::check_mt() {
+        return search();
+    }
+#else
+    lbool ddfw::check_mt() {
+        unsigned n = m_config.m_num_threads;
+        m_master = this;
+        m_winner = -1;
+        m_shared_weights.reset();
+        m_shared_weights.append(m_weights);
+        set_block(0);
+        scoped_ptr_vector<ddfw> workers;
+        for (unsigned i = 1; i < n; ++i) {
+            ddfw* w = alloc(ddfw);
+            w->set_seed(m_rand() + i);
+            w->init_worker(*this, i);
+            m_limit.push_child(&w->m_limit);
+            workers.push_back(w);
+        }
+        std::string ex_msg;
+        auto run = [&](ddfw& d) {
+            try {
+                if (d.search() == l_true)
+                    d.set_winner();
+            }
+            catch (z3_exception& ex) {
+                {
+                    lock_guard lock(m_mux);
+                    ex_msg = ex.msg();
+                }
+                m_limit.cancel();
+            }
+        };
+        vector<std::thread> threads;
+        for (ddfw* w : workers) 
+            threads.push_back(std::thread([&, w]() { run(*w); }));
+        run(*this);
+        for (auto& th : threads)
+            th.join();
+        for (unsigned i = 1; i < n; ++i)
+            m_limit.pop_child();
+
+        for (unsigned i = 0; i < n; ++i) {
+            ddfw const& d = i == 0 ? *this : *workers[i - 1];
+            IF_VERBOSE(1, verbose_stream() << "(sat.ddfw :thread " << i << " :flips " << d.m_flips 
+                       << " :min-unsat " << d.m_min_sz << " :syncs " << d.m_sync_count << ")\n");
+        }
+        lbool r = l_undef;
+        if (m_winner != -1) {
+            m_limit.reset_cancel();
+            if (m_winner != 0) {
+                m_model = workers[m_winner - 1]->m_model;
+                m_min_sz = 0;
+            }
+            r = l_true;
+        }
+        m_master = nullptr;
+        if (r == l_undef && !ex_msg.empty())
+            throw default_exception(std::move(ex_msg));
+        return r;
+    }
+#endif
+
     void ddfw::save_best_values() {
         if (m_unsat.empty()) {
             m_model.reserve(num_vars());
@@ -450,11 +720,12 @@ namespace sat {
        3. select multiple clauses instead of just one per clause in unsat.
      */
 
-    bool ddfw::select_clause(unsigned max_weight, unsigned max_trues, clause_info const& cn, unsigned& n) {
-        if (cn.m_num_trues == 0 || cn.m_weight < max_weight) {
+    bool ddfw::select_clause(unsigned max_weight, unsigned max_trues, unsigned cn_idx, unsigned& n) {
+        unsigned w = m_weights[cn_idx];
+        if (m_num_trues[cn_idx] == 0 || w < max_weight) {
             return false;
         }
-        if (cn.m_weight > max_weight) {
+        if (w > max_weight) {
             n = 2;
             return true;
         } 
@@ -469,11 +740,10 @@ namespace sat {
         unsigned n = 1;
         for (literal lit : c) {
             for (unsigned cn_idx : use_list(*this, lit)) {
-                auto& cn = m_clauses[cn_idx];
-                if (select_clause(max_weight, max_trues, cn, n)) {
+                if (select_clause(max_weight, max_trues, cn_idx, n)) {
                     cl = cn_idx;
-                    max_weight = cn.m_weight;
-                    max_trues = cn.m_num_trues;
+                    max_weight = m_weights[cn_idx];
+                    max_trues = m_num_trues[cn_idx];
                 }
             }
         }
@@ -483,29 +753,26 @@ namespace sat {
     void ddfw::shift_weights() {
         ++m_shifts;
         for (unsigned cf_idx : m_unsat) {
-            auto& cf = m_clauses[cf_idx];
-            SASSERT(!cf.is_true());
+            SASSERT(!is_true(cf_idx));
             unsigned cn_idx = select_max_same_sign(cf_idx);
             while (cn_idx == UINT_MAX) {
                 unsigned idx = (m_rand() * m_rand()) % m_clauses.size();
-                auto & cn = m_clauses[idx];
-                if (cn.is_true() && cn.m_weight >= 2) {
+                if (is_true(idx) && m_weights[idx] >= 2) {
                     cn_idx = idx;
                 }
             }
-            auto & cn = m_clauses[cn_idx];
-            SASSERT(cn.is_true());
-            unsigned wn = cn.m_weight;
+            SASSERT(is_true(cn_idx));
+            unsigned wn = m_weights[cn_idx];
             SASSERT(wn >= 2);
             unsigned inc = (wn > 2) ? 2 : 1; 
             SASSERT(wn - inc >= 1);            
-            cf.m_weight += inc;
-            cn.m_weight -= inc;
+            m_weights[cf_idx] += inc;
+            m_weights[cn_idx] -= inc;
             for (literal lit : get_clause(cf_idx)) {
                 inc_reward(lit, inc);
             }
-            if (cn.m_num_trues == 1) {
-                inc_reward(to_literal(cn.m_trues), inc);
+            if (m_num_trues[cn_idx] == 1) {
+                inc_reward(to_literal(m_trues[cn_idx]), inc);
             }
         }
         // DEBUG_CODE(invariant(););
@@ -515,8 +782,7 @@ namespace sat {
         unsigned num_cls = m_clauses.size();
         for (unsigned i = 0; i < num_cls; ++i) {
             out << get_clause(i) << " ";
-            auto const& ci = m_clauses[i];
-            out << ci.m_num_trues << " " << ci.m_weight << "\n";
+            out << m_num_trues[i] << " " << m_weights[i] << "\n";
         }
         for (unsigned v = 0; v < num_vars(); ++v) {
             out << v << ": " << reward(v) << "\n";
@@ -545,25 +811,23 @@ namespace sat {
         for (unsigned v = 0; v < num_vars(); ++v) {
             int v_reward = 0;
             literal lit(v, !value(v));
-            for (unsigned j : m_use_list[lit.index()]) {
-                clause_info const& ci = m_clauses[j];
-                if (ci.m_num_trues == 1) {
-                    SASSERT(lit == to_literal(ci.m_trues));
-                    v_reward -= ci.m_weight;
+            for (unsigned j : use_list(*this, lit)) {
+                if (m_num_trues[j] == 1) {
+                    SASSERT(lit == to_literal(m_trues[j]));
+                    v_reward -= m_weights[j];
                 }
             }
-            for (unsigned j : m_use_list[(~lit).index()]) {
-                clause_info const& ci = m_clauses[j];
-                if (ci.m_num_trues == 0) {
-                    v_reward += ci.m_weight;
+            for (unsigned j : use_list(*this, ~lit)) {
+                if (m_num_trues[j] == 0) {
+                    v_reward += m_weights[j];
                 }                
             }
             IF_VERBOSE(0, if (v_reward != reward(v)) verbose_stream() << v << " " << v_reward << " " << reward(v) << "\n");
             SASSERT(reward(v) == v_reward);
         }
         DEBUG_CODE(
-            for (auto const& ci : m_clauses) {
-                SASSERT(ci.m_weight > 0);
+            for (unsigned w : m_weights) {
+                SASSERT(w > 0);
             }
             for (unsigned i = 0; i < m_clauses.size(); ++i) {
                 bool found = false;
@@ -586,6 +850,16 @@ namespace sat {
         m_config.m_use_reward_zero_pct = p.ddfw_use_reward_pct();
         m_config.m_reinit_base = p.ddfw_reinit_base();
         m_config.m_restart_base = p.ddfw_restart_base();        
+        m_config.m_num_threads = p.threads();
+        m_config.m_weight_sync_base = std::max(1u, p.ddfw_weight_sync());
+        m_config.m_simd = p.ddfw_simd() && has_avx2();
+    }
+
+    void ddfw::collect_statistics(statistics& st) const {
+        st.update("sat ddfw flips", static_cast<double>(m_flips));
+        st.update("sat ddfw shifts", static_cast<double>(m_shifts));
+        st.update("sat ddfw restarts", m_restart_count);
+        st.update("sat ddfw reinits", m_reinit_count);
     }
     
 }
@@ -24,6 +24,7 @@
 #include "util/rlimit.h"
 #include "util/params.h"
 #include "util/ema.h"
+#include "util/mutex.h"
 #include "sat/sat_clause.h"
 #include "sat/sat_types.h"
 
@@ -33,17 +34,6 @@ namespace sat {
 
     class ddfw : public i_local_search {
 
-        struct clause_info {
-            clause_info(clause* cl, unsigned init_weight): m_weight(init_weight), m_trues(0), m_num_trues(0), m_clause(cl) {}
-            unsigned m_weight;       // weight of clause
-            unsigned m_trues;        // set of literals that are true
-            unsigned m_num_trues;    // size of true set
-            clause*  m_clause;
-            bool is_true() const { return m_num_trues > 0; }
-            void add(literal lit) { ++m_num_trues; m_trues += lit.index(); }
-            void del(literal lit) { SASSERT(m_num_trues > 0); --m_num_trues; m_trues -= lit.index(); }
-        };
-
         struct config {
             config() { reset(); }
             unsigned m_use_reward_zero_pct;
@@ -52,6 +42,9 @@ namespace sat {
             unsigned m_restart_base;
             unsigned m_reinit_base;
             unsigned m_parsync_base;
+            unsigned m_num_threads;
+            unsigned m_weight_sync_base;
+            bool     m_simd;
             double   m_itau;
             void reset() {
                 m_init_clause_weight = 8;
@@ -60,6 +53,9 @@ namespace sat {
                 m_restart_base = 100333;
                 m_reinit_base = 10000;
                 m_parsync_base = 333333;
+                m_num_threads = 1;
+                m_weight_sync_base = 100000;
+                m_simd = false;  // set by updt_params when the CPU supports AVX2
                 m_itau = 0.5;
             }
         };
@@ -76,7 +72,13 @@ namespace sat {
         config           m_config;
         reslimit         m_limit;
         clause_allocator m_alloc;
-        svector<clause_info> m_clauses;
+        // clause data is kept as a structure of arrays indexed by clause.
+        // Flips only touch the true literal counts and weights, which are
+        // stored contiguously so that they can be gathered 8 at a time.
+        ptr_vector<clause>   m_clauses;     // clause index -> clause
+        unsigned_vector      m_weights;     // weight of clause
+        unsigned_vector      m_trues;       // sum of indices of true literals, identifies the literal when there is one
+        unsigned_vector      m_num_trues;   // number of true literals
         literal_vector       m_assumptions;        
         svector<var_info>    m_vars;        // var -> info
         svector<double>      m_probs;       // var -> probability of flipping
@@ -100,14 +102,29 @@ namespace sat {
 
         parallel*        m_par;
 
+        // multi-threaded search.
+        // The threads share the clauses and use lists of the master.
+        // Each thread prefers to flip variables in its own block of variables
+        // and the threads periodically blend their clause weights.
+        ddfw*            m_master { nullptr };
+        unsigned         m_thread_id { 0 };
+        bool_var         m_block_lo { 0 }, m_block_hi { 0 };
+        unsigned         m_sync_count { 0 };
+        uint64_t         m_sync_next { 0 };
+        unsigned const*  m_use_data { nullptr };
+        unsigned const*  m_use_index { nullptr };
+        mutex            m_mux;             // master only: guards the fields below
+        unsigned_vector  m_shared_weights;
+        int              m_winner { -1 };
+
         class use_list {
-            ddfw& p;
+            ddfw const& p;
             unsigned i;
         public:
-            use_list(ddfw& p, literal lit):
+            use_list(ddfw const& p, literal lit):
                 p(p), i(lit.index()) {}
-            unsigned const* begin() { return p.m_flat_use_list.data() + p.m_use_list_index[i]; }
-            unsigned const* end() { return p.m_flat_use_list.data() + p.m_use_list_index[i + 1]; }
+            unsigned const* begin() { return p.m_use_data + p.m_use_index[i]; }
+            unsigned const* end() { return p.m_use_data + p.m_use_index[i + 1]; }
         };
 
         void flatten_use_list(); 
@@ -134,11 +151,15 @@ namespace sat {
 
         inline bool is_true(literal lit) const { return value(lit.var()) != lit.sign(); }
 
-        inline clause const& get_clause(unsigned idx) const { return *m_clauses[idx].m_clause; }
+        inline clause const& get_clause(unsigned idx) const { return *m_clauses[idx]; }
+
+        inline unsigned get_weight(unsigned idx) const { return m_weights[idx]; }
 
-        inline unsigned get_weight(unsigned idx) const { return m_clauses[idx].m_weight; }
+        inline bool is_true(unsigned idx) const { return m_num_trues[idx] > 0; }
 
-        inline bool is_true(unsigned idx) const { return m_clauses[idx].is_true(); }
+        inline void add_true(unsigned idx, literal lit) { ++m_num_trues[idx]; m_trues[idx] += lit.index(); }
+
+        inline void del_true(unsigned idx, literal lit) { SASSERT(m_num_trues[idx] > 0); --m_num_trues[idx]; m_trues[idx] -= lit.index(); }
 
         void update_reward_avg(bool_var v) { m_vars[v].m_reward_avg.update(reward(v)); }
 
@@ -162,6 +183,10 @@ namespace sat {
         bool do_flip();
         bool_var pick_var();       
         void flip(bool_var v);
+        void make_false(literal lit, unsigned cls_idx);
+        void make_true(literal lit, unsigned cls_idx);
+        unsigned const* del_trues_simd(literal lit, unsigned const* it, unsigned const* end);
+        unsigned const* add_trues_simd(literal lit, unsigned const* it, unsigned const* end);
         void save_best_values();
 
         // shift activity
@@ -170,7 +195,7 @@ namespace sat {
         // reinitialize weights activity
         bool should_reinit_weights();        
         void do_reinit_weights();
-        inline bool select_clause(unsigned max_weight, unsigned max_trues, clause_info const& cn, unsigned& n);
+        inline bool select_clause(unsigned max_weight, unsigned max_trues, unsigned cn_idx, unsigned& n);
 
         // restart activity
         bool should_restart();
@@ -181,10 +206,22 @@ namespace sat {
         bool should_parallel_sync();
         void do_parallel_sync();
 
+        // multi-threaded search
+        lbool search();
+        lbool check_mt();
+        void init_worker(ddfw& master, unsigned id);
+        void set_block(unsigned epoch);
+        bool_var pick_block_var();
+        bool should_sync_weights();
+        void do_sync_weights();
+        void set_winner();
+
         void log();
 
         void init(unsigned sz, literal const* assumptions);
 
+        void init_search();
+
         void init_clause_data();
 
         void invariant();
@@ -217,7 +254,7 @@ namespace sat {
         unsigned num_non_binary_clauses() const override { return m_num_non_binary_clauses; }
         void reinit(solver& s) override;
 
-        void collect_statistics(statistics& st) const override {} 
+        void collect_statistics(statistics& st) const override;
 
         double get_priority(bool_var v) const override { return m_probs[v]; }
     };
@@ -30,9 +30,15 @@ namespace sat {
         s(s)
     {
         if (s.get_config().m_drat && s.get_config().m_drat_file.is_non_empty_string()) {
-            auto mode = s.get_config().m_drat_binary ? (std::ios_base::binary | std::ios_base::out | std::ios_base::trunc) : std::ios_base::out;
-            m_out = alloc(std::ofstream, s.get_config().m_drat_file.str(), mode);
-            if (s.get_config().m_drat_binary) 
+            bool binary = s.get_config().m_drat_binary;
+            m_writer = alloc(drat_writer, s.get_config().m_drat_file.str().c_str(), binary, s.get_config().m_drat_async);
+            m_out = alloc(std::ostream, m_writer);
+            if (s.get_config().m_drat_lrat) {
+                m_lrat = true;
+                m_lrat_binary = binary;
+                std::swap(m_out, m_lrat_out);
+            }
+            else if (binary) 
                 std::swap(m_out, m_bout);            
         }
     }
@@ -40,17 +46,22 @@ namespace sat {
     drat::~drat() {
         if (m_out) m_out->flush();
         if (m_bout) m_bout->flush();
+        if (m_lrat_out) m_lrat_out->flush();
         dealloc(m_out);
         dealloc(m_bout);
+        dealloc(m_lrat_out);
+        dealloc(m_writer);
         for (auto & [c, st] : m_proof) 
             m_alloc.del_clause(&c);            
         m_proof.reset();
         m_out = nullptr;
         m_bout = nullptr;
+        m_lrat_out = nullptr;
     }
 
     void drat::updt_config() {            
-        m_check_unsat = s.get_config().m_drat_check_unsat;
+        // the LRAT clauses share the watches of the checker
+        m_check_unsat = s.get_config().m_drat_check_unsat && !m_lrat;
         m_check_sat   = s.get_config().m_drat_check_sat;
         m_check       = m_check_unsat || m_check_sat;
         m_activity    = s.get_config().m_drat_activity;
@@ -220,8 +231,10 @@ namespace sat {
             m_watches[(~l1).index()].push_back(idx);
             m_watches[(~l2).index()].push_back(idx);
 
-            if (value(l1) == l_false && value(l2) == l_false) 
-                m_inconsistent = true;            
+            if (value(l1) == l_false && value(l2) == l_false) {
+                m_inconsistent = true;
+                m_conflict = &c;
+            }
             else if (value(l1) == l_false) 
                 assign_propagate(l2, &c);            
             else if (value(l2) == l_false) 
@@ -293,7 +306,7 @@ namespace sat {
     }
 
     void drat::declare(literal l) {
-        if (!m_check)
+        if (!m_check && !m_lrat)
             return;
         unsigned n = static_cast<unsigned>(l.var());
         while (m_assignment.size() <= n) {
@@ -549,18 +562,21 @@ namespace sat {
         switch (old_value) {
         case l_false:
             m_inconsistent = true;
+            m_conflict = c;
+            m_conflict_lit = l;
             break;
         case l_true:
             break;
         case l_undef:
             m_assignment.setx(l.var(), new_value, l_undef);
+            m_unit_pos.setx(l.var(), m_units.size(), 0);
             m_units.push_back({l, c});
             break;
         }
     }
 
     void drat::assign_propagate(literal l, clause* c) {
-        if (!m_check_unsat)
+        if (!m_check_unsat && !m_lrat)
             return;
         unsigned num_units = m_units.size();
         assign(l, c);
@@ -603,6 +619,7 @@ namespace sat {
                 }
                 else if (value(wc.m_l1) == l_false) {
                     m_inconsistent = true;
+                    m_conflict = &c;
                     goto end_process_watch;
                 }
                 else {
@@ -628,6 +645,7 @@ namespace sat {
         ++m_stats.m_num_add;
         if (m_out) (*m_out) << "0\n";
         if (m_bout) bdump(0, nullptr, status::redundant());
+        if (m_lrat) lrat_add(0, nullptr, status::redundant());
         if (m_check_unsat) {
             verify(0, nullptr);
             SASSERT(m_inconsistent);
@@ -640,6 +658,7 @@ namespace sat {
         if (m_out) dump(1, &l, st);
         if (m_bout) bdump(1, &l, st);
         if (m_check) append(l, st);
+        if (m_lrat) lrat_add(1, &l, st);
         if (m_clause_eh) m_clause_eh->on_clause(1, &l, st);
     }
     void drat::add(literal l1, literal l2, status st) {
@@ -651,6 +670,7 @@ namespace sat {
         if (m_out) dump(2, ls, st);
         if (m_bout) bdump(2, ls, st);
         if (m_check) append(l1, l2, st);
+        if (m_lrat) lrat_add(2, ls, st);
         if (m_clause_eh) m_clause_eh->on_clause(2, ls, st);
     }
     void drat::add(clause& c, status st) {
@@ -661,6 +681,7 @@ namespace sat {
         if (m_out) dump(c.size(), c.begin(), st);
         if (m_bout) bdump(c.size(), c.begin(), st);
         if (m_check) append(mk_clause(c), st);
+        if (m_lrat) lrat_add(c.size(), c.begin(), st);
         if (m_clause_eh) m_clause_eh->on_clause(c.size(), c.begin(), st);
     }
     
@@ -682,6 +703,10 @@ namespace sat {
         }
         if (m_out)
             dump(sz, lits, st);
+        if (m_bout)
+            bdump(sz, lits, st);
+        if (m_lrat)
+            lrat_add(sz, lits, st);
 
         if (m_clause_eh)
             m_clause_eh->on_clause(sz, lits, st);
@@ -704,6 +729,8 @@ namespace sat {
             }
             }
         }
+        if (m_lrat)
+            lrat_add(c.size(), c.data(), status::redundant());
         if (m_clause_eh)
             m_clause_eh->on_clause(c.size(), c.data(), status::redundant());
     }
@@ -713,6 +740,7 @@ namespace sat {
         if (m_out) dump(1, &l, status::deleted());
         if (m_bout) bdump(1, &l, status::deleted());
         if (m_check) append(l, status::deleted());
+        if (m_lrat) lrat_add(1, &l, status::deleted());
         if (m_clause_eh) m_clause_eh->on_clause(1, &l, status::deleted());
     }
 
@@ -722,6 +750,7 @@ namespace sat {
         if (m_out) dump(2, ls, status::deleted());
         if (m_bout) bdump(2, ls, status::deleted());
         if (m_check) append(l1, l2, status::deleted());
+        if (m_lrat) lrat_add(2, ls, status::deleted());
         if (m_clause_eh) m_clause_eh->on_clause(2, ls, status::deleted());
     }
 
@@ -741,6 +770,7 @@ namespace sat {
         if (m_out) dump(c.size(), c.begin(), status::deleted());
         if (m_bout) bdump(c.size(), c.begin(), status::deleted());
         if (m_check) append(mk_clause(c), status::deleted());     
+        if (m_lrat) lrat_add(c.size(), c.begin(), status::deleted());
         if (m_clause_eh) m_clause_eh->on_clause(c.size(), c.begin(), status::deleted());   
     }
 
@@ -757,9 +787,282 @@ namespace sat {
         if (m_out) dump(c.size(), c.begin(), status::deleted());
         if (m_bout) bdump(c.size(), c.begin(), status::deleted());
         if (m_check) append(mk_clause(c.size(), c.begin(), true), status::deleted());        
+        if (m_lrat) lrat_add(c.size(), c.data(), status::deleted());
         if (m_clause_eh) m_clause_eh->on_clause(c.size(), c.begin(), status::deleted());
     }
 
+    /**
+       \brief number an input clause before the solver simplifies it.
+       Tautologies take an id, as they do in the DIMACS file, but are not kept.
+     */
+    void drat::add_input(unsigned sz, literal const* c) {
+        if (!m_lrat || !m_lrat_inputs)
+            return;
+        literal_vector lits(sz, c);
+        std::sort(lits.begin(), lits.end());
+        unsigned j = 0;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            if (j > 0 && lits[j - 1] == lits[i])
+                continue;
+            if (j > 0 && lits[j - 1] == ~lits[i]) {
+                ++m_lrat_id;
+                m_lrat_clauses.setx(m_lrat_id, nullptr, nullptr);
+                m_lrat_watch.setx(m_lrat_id, UINT_MAX, UINT_MAX);
+                return;
+            }
+            lits[j++] = lits[i];
+        }
+        lits.shrink(j);
+        lrat_insert(lits.size(), lits.data(), false);
+    }
+
+    unsigned drat::lrat_hash(unsigned n, literal const* lits) const {
+        // independent of the order of the literals
+        unsigned h = n;
+        for (unsigned i = 0; i < n; ++i)
+            h += hash_u(lits[i].index());
+        return h;
+    }
+
+    /**
+       \brief the id of a clause that is not deleted and has the literals lits.
+       The solver deletes clauses by their literals, and it may delete a copy
+       of a clause that is ordered differently.
+     */
+    unsigned drat::lrat_find(unsigned n, literal const* lits, bool remove) {
+        auto* e = m_lrat_table.find_core(lrat_hash(n, lits));
+        if (!e)
+            return 0;
+        ptr_vector<clause>& cs = e->get_data().m_value;
+        for (unsigned i = 0; i < cs.size(); ++i) {
+            unsigned id = m_lrat_ids[cs[i]->id()];
+            if (!m_lrat_clauses[id]) {
+                cs[i--] = cs.back();
+                cs.pop_back();
+                continue;
+            }
+            if (!match(n, lits, *cs[i]))
+                continue;
+            if (remove) {
+                cs[i] = cs.back();
+                cs.pop_back();
+            }
+            return id;
+        }
+        return 0;
+    }
+
+    unsigned drat::lrat_insert(unsigned n, literal const* lits, bool is_learned) {
+        clause& c = mk_clause(n, lits, is_learned);
+        m_proof.push_back({c, is_learned ? status::redundant() : status::asserted()});
+        unsigned id = ++m_lrat_id;
+        m_lrat_ids.setx(c.id(), id, 0);
+        m_lrat_clauses.setx(id, &c, nullptr);
+        m_lrat_watch.setx(id, UINT_MAX, UINT_MAX);
+        m_lrat_table.insert_if_not_there(lrat_hash(n, lits), ptr_vector<clause>()).push_back(&c);
+        for (literal lit : c)
+            declare(lit);
+        if (m_inconsistent)
+            return id;
+        unsigned num_watch = 0;
+        literal l1, l2;
+        for (unsigned i = 0; i < n && num_watch < 2; ++i) {
+            if (value(c[i]) != l_false) {
+                if (num_watch++ == 0)
+                    l1 = c[i];
+                else
+                    l2 = c[i];
+            }
+        }
+        switch (num_watch) {
+        case 0:
+            m_inconsistent = true;
+            m_conflict = &c;
+            break;
+        case 1:
+            assign_propagate(l1, &c);
+            break;
+        default:
+            m_lrat_watch[id] = m_watched_clauses.size();
+            m_watches[(~l1).index()].push_back(m_watched_clauses.size());
+            m_watches[(~l2).index()].push_back(m_watched_clauses.size());
+            m_watched_clauses.push_back(watched_clause(&c, l1, l2));
+            break;
+        }
+        return id;
+    }
+
+    void drat::lrat_add(unsigned n, literal const* lits, status st) {
+        if (st.is_deleted()) {
+            lrat_del(n, lits);
+            return;
+        }
+        if (!st.is_redundant()) {
+            // the input clause was numbered by add_input
+            if (lrat_find(n, lits, false) != 0)
+                return;
+            // an input clause without its literals that are false at the base level
+            // is a copy of the input clause for the solver
+            clause* orig = m_lrat_inputs ? m_lrat_clauses.get(m_lrat_id, nullptr) : nullptr;
+            bool is_copy = orig != nullptr;
+            for (unsigned i = 0; is_copy && i < n; ++i)
+                is_copy = orig->contains(lits[i]);
+            if (is_copy) {
+                clause& c = mk_clause(n, lits, false);
+                m_proof.push_back({c, status::asserted()});
+                m_lrat_ids.setx(c.id(), m_lrat_id, 0);
+                m_lrat_table.insert_if_not_there(lrat_hash(n, lits), ptr_vector<clause>()).push_back(&c);
+                return;
+            }
+        }
+        for (unsigned i = 0; i < n; ++i)
+            declare(lits[i]);
+        if (!lrat_rup(n, lits)) {
+            ++m_stats.m_num_lrat_unchecked;
+            m_hints.reset();
+        }
+        m_lrat_inputs = false;
+        unsigned id = lrat_insert(n, lits, true);
+        lrat_dump_add(id, n, lits);
+    }
+
+    void drat::lrat_del(unsigned n, literal const* lits) {
+        unsigned id = lrat_find(n, lits, false);
+        // a reason of a unit at the base level is kept, 
+        // since the hints of later lemmas refer to it
+        if (id == 0 || lrat_is_reason(id))
+            return;
+        lrat_find(n, lits, true);
+        clause& c = *m_lrat_clauses[id];
+        unsigned idx = m_lrat_watch[id];
+        if (idx != UINT_MAX) {
+            del_watch(c, m_watched_clauses[idx].m_l1);
+            del_watch(c, m_watched_clauses[idx].m_l2);
+        }
+        m_lrat_clauses[id] = nullptr;
+        m_lrat_inputs = false;
+        lrat_dump_del(id);
+    }
+
+    bool drat::lrat_is_reason(unsigned id) const {
+        clause* c = m_lrat_clauses[id];
+        if (m_inconsistent && m_conflict == c)
+            return true;
+        for (literal lit : *c) 
+            if (value(lit) == l_true && m_units[m_unit_pos[lit.var()]].second == c)
+                return true;
+        return false;
+    }
+
+    /**
+       \brief check that lits follows by unit propagation from its negation,
+       and collect the ids of the clauses used by the propagation in m_hints.
+     */
+    bool drat::lrat_rup(unsigned n, literal const* lits) {
+        m_hints.reset();
+        if (m_inconsistent) {
+            lrat_hints();
+            return true;
+        }
+        // the checker assigns the negation of the lemma before it uses the hints,
+        // so no hint may propagate a literal of the lemma.
+        unsigned num_units = m_units.size();
+        for (unsigned i = 0; !m_inconsistent && i < n; ++i)
+            assign(~lits[i], nullptr);
+        for (unsigned i = num_units; !m_inconsistent && i < m_units.size(); ++i)
+            propagate(m_units[i].first);
+        bool ok = m_inconsistent;
+        if (ok)
+            lrat_hints();
+        for (unsigned i = num_units; i < m_units.size(); ++i)
+            m_assignment[m_units[i].first.var()] = l_undef;
+        m_units.shrink(num_units);
+        m_inconsistent = false;
+        m_conflict = nullptr;
+        return ok;
+    }
+
+    /**
+       \brief the reasons of the literals that the conflict depends on, in the 
+       order they were propagated, followed by the conflict clause.
+     */
+    void drat::lrat_hints() {
+        m_mark.reserve(m_assignment.size(), false);
+        unsigned num_marked = 0;
+        auto mark = [&](bool_var v) {
+            if (!m_mark[v]) {
+                m_mark[v] = true;
+                ++num_marked;
+            }
+        };
+        if (m_conflict) {
+            for (literal lit : *m_conflict)
+                mark(lit.var());
+        }
+        else
+            mark(m_conflict_lit.var());
+        for (unsigned i = m_units.size(); num_marked > 0 && i-- > 0; ) {
+            auto const& [lit, c] = m_units[i];
+            if (!m_mark[lit.var()])
+                continue;
+            m_mark[lit.var()] = false;
+            --num_marked;
+            if (!c)
+                continue;
+            m_hints.push_back(m_lrat_ids[c->id()]);
+            for (literal l : *c)
+                if (l.var() != lit.var())
+                    mark(l.var());
+        }
+        SASSERT(num_marked == 0);
+        m_hints.reverse();
+        if (m_conflict)
+            m_hints.push_back(m_lrat_ids[m_conflict->id()]);
+    }
+
+    void drat::lrat_write(unsigned n) {
+        do {
+            unsigned char ch = n & 127;
+            n >>= 7;
+            if (n) ch |= 128;
+            m_lrat_out->put(ch);
+        }
+        while (n);
+    }
+
+    void drat::lrat_dump_add(unsigned id, unsigned n, literal const* lits) {
+        std::ostream& out = *m_lrat_out;
+        if (m_lrat_binary) {
+            out.put('a');
+            lrat_write(2 * id);
+            for (unsigned i = 0; i < n; ++i)
+                lrat_write(2 * lits[i].var() + lits[i].sign());
+            out.put(0);
+            for (unsigned h : m_hints)
+                lrat_write(2 * h);
+            out.put(0);
+            return;
+        }
+        out << id;
+        for (unsigned i = 0; i < n; ++i)
+            out << (lits[i].sign() ? " -" : " ") << lits[i].var();
+        out << " 0";
+        for (unsigned h : m_hints)
+            out << " " << h;
+        out << " 0\n";
+    }
+
+    void drat::lrat_dump_del(unsigned id) {
+        std::ostream& out = *m_lrat_out;
+        if (m_lrat_binary) {
+            out.put('d');
+            lrat_write(2 * id);
+            out.put(0);
+            return;
+        }
+        out << m_lrat_id << " d " << id << " 0\n";
+    }
+
     void drat::check_model(model const& m) {
     }
 
@@ -768,6 +1071,8 @@ namespace sat {
         st.update("num-drat", m_stats.m_num_drat);
         st.update("num-add", m_stats.m_num_add);
         st.update("num-del", m_stats.m_num_del);
+        if (m_lrat)
+            st.update("lrat-lemmas-without-hints", m_stats.m_num_lrat_unchecked);
     }
 
 
@@ -21,7 +21,9 @@ Notes:
 --*/
 #pragma once
 
+#include "util/map.h"
 #include "sat_types.h"
+#include "sat/sat_drat_writer.h"
 
 namespace sat {
     class justification;
@@ -38,6 +40,7 @@ namespace sat {
             unsigned m_num_drat = 0;
             unsigned m_num_add = 0;
             unsigned m_num_del = 0;
+            unsigned m_num_lrat_unchecked = 0;
         };
         struct watched_clause {
             clause* m_clause;
@@ -50,6 +53,7 @@ namespace sat {
         typedef svector<unsigned> watch;
         solver& s;
         clause_allocator        m_alloc;
+        drat_writer*            m_writer = nullptr;
         std::ostream*           m_out = nullptr;
         std::ostream*           m_bout = nullptr;
         svector<std::pair<clause&, status>> m_proof;
@@ -63,6 +67,24 @@ namespace sat {
         bool                    m_activity = false;
         stats                   m_stats;
 
+        // LRAT proofs give every clause an id. The input clauses are numbered
+        // in the order they are given to the solver, as the clauses of a DIMACS
+        // file, and every lemma lists the clauses that derive it by unit propagation.
+        bool                    m_lrat = false;
+        bool                    m_lrat_binary = false;
+        bool                    m_lrat_inputs = true;   // no lemma or deletion was written yet
+        std::ostream*           m_lrat_out = nullptr;
+        unsigned                m_lrat_id = 0;          // id of the last clause
+        unsigned_vector         m_lrat_ids;             // clause::id() -> LRAT id
+        ptr_vector<clause>      m_lrat_clauses;         // LRAT id -> clause, nullptr once deleted
+        unsigned_vector         m_lrat_watch;           // LRAT id -> index in m_watched_clauses
+        u_map<ptr_vector<clause>> m_lrat_table;         // hash of literal set -> clauses with these literals
+        unsigned_vector         m_unit_pos;             // variable -> position in m_units
+        unsigned_vector         m_hints;
+        bool_vector             m_mark;
+        clause*                 m_conflict = nullptr;   // falsified clause, nullptr if an assumption is falsified
+        literal                 m_conflict_lit;
+
 
         void dump_activity();
         void dump(unsigned n, literal const* c, status st);
@@ -93,6 +115,18 @@ namespace sat {
         clause& mk_clause(clause& c);
         clause& mk_clause(unsigned n, literal const* lits, bool is_learned);
 
+        unsigned lrat_hash(unsigned n, literal const* lits) const;
+        unsigned lrat_find(unsigned n, literal const* lits, bool remove);
+        unsigned lrat_insert(unsigned n, literal const* lits, bool is_learned);
+        void lrat_add(unsigned n, literal const* lits, status st);
+        void lrat_del(unsigned n, literal const* lits);
+        bool lrat_is_reason(unsigned id) const;
+        bool lrat_rup(unsigned n, literal const* lits);
+        void lrat_hints();
+        void lrat_dump_add(unsigned id, unsigned n, literal const* lits);
+        void lrat_dump_del(unsigned id);
+        void lrat_write(unsigned n);
+
 
     public:
 
@@ -108,6 +142,7 @@ namespace sat {
         void add(literal_vector const& c, status st);
         void add(literal_vector const& c); // add learned clause
         void add(unsigned sz, literal const* lits, status st);
+        void add_input(unsigned sz, literal const* lits);
 
         void set_clause_eh(clause_eh& clause_eh) { m_clause_eh = &clause_eh; }
 
@@ -0,0 +1,116 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat_writer.cpp
+
+Abstract:
+
+    Double buffered output for DRAT proofs.
+
+--*/
+#include "sat/sat_drat_writer.h"
+
+namespace sat {
+
+    drat_writer::drat_writer(char const* file_name, bool binary, bool async):
+        m_out(file_name, binary ? (std::ios_base::binary | std::ios_base::out | std::ios_base::trunc) : std::ios_base::out),
+        m_async(async) {
+        m_front.resize(BUFFER_SIZE);
+        reset_put_area();
+#ifdef SINGLE_THREAD
+        m_async = false;
+#else
+        if (m_async) {
+            m_back.resize(BUFFER_SIZE);
+            m_thread = std::thread([this]() { run(); });
+        }
+#endif
+    }
+
+    drat_writer::~drat_writer() {
+        flush();
+#ifndef SINGLE_THREAD
+        if (m_async) {
+            {
+                std::lock_guard<std::mutex> lock(m_mux);
+                m_done = true;
+            }
+            m_cond.notify_all();
+            m_thread.join();
+        }
+#endif
+    }
+
+#ifndef SINGLE_THREAD
+    void drat_writer::run() {
+        std::unique_lock<std::mutex> lock(m_mux);
+        while (true) {
+            m_cond.wait(lock, [&]() { return m_has_back || m_done; });
+            if (!m_has_back)
+                return;
+            lock.unlock();
+            m_out.write(m_back.data(), m_back_size);
+            lock.lock();
+            m_has_back = false;
+            m_cond.notify_all();
+        }
+    }
+#endif
+
+    /**
+       \brief pass the front buffer to the writer thread, or write it directly 
+       in synchronous mode. The solver only waits if the writer thread is still 
+       busy with the previous buffer.
+    */
+    void drat_writer::hand_over() {
+        size_t n = pptr() - pbase();
+        if (n == 0)
+            return;
+#ifndef SINGLE_THREAD
+        if (m_async) {
+            {
+                std::unique_lock<std::mutex> lock(m_mux);
+                m_cond.wait(lock, [&]() { return !m_has_back; });
+                m_front.swap(m_back);
+                m_back_size = n;
+                m_has_back = true;
+            }
+            m_cond.notify_all();
+            reset_put_area();
+            return;
+        }
+#endif
+        m_out.write(pbase(), n);
+        reset_put_area();
+    }
+
+    void drat_writer::flush() {
+        hand_over();
+#ifndef SINGLE_THREAD
+        if (m_async) {
+            std::unique_lock<std::mutex> lock(m_mux);
+            m_cond.wait(lock, [&]() { return !m_has_back; });
+        }
+#endif
+        m_out.flush();
+    }
+
+    /**
+       \brief called by the stream only when the put area is full.
+    */
+    drat_writer::int_type drat_writer::overflow(int_type ch) {
+        hand_over();
+        if (ch != traits_type::eof()) {
+            *pptr() = static_cast<char>(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int drat_writer::sync() {
+        flush();
+        return 0;
+    }
+}
@@ -0,0 +1,60 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat_writer.h
+
+Abstract:
+
+    Double buffered output for DRAT proofs.
+
+    The solver appends proof records to a front buffer, which
+    is the put area of the stream buffer. When the front buffer
+    is full it is swapped with the back buffer, which a writer
+    thread copies to the proof file while the solver continues
+    with the next conflict.
+
+--*/
+#pragma once
+
+#include "util/vector.h"
+#include <fstream>
+#include <streambuf>
+#ifndef SINGLE_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace sat {
+
+    class drat_writer : public std::streambuf {
+        static const unsigned BUFFER_SIZE = 1 << 20;
+        std::ofstream           m_out;
+        svector<char>           m_front;       // filled by the solver
+        bool                    m_async;
+#ifndef SINGLE_THREAD
+        svector<char>           m_back;        // written by the writer thread
+        size_t                  m_back_size { 0 };
+        std::mutex              m_mux;
+        std::condition_variable m_cond;
+        std::thread             m_thread;
+        bool                    m_has_back { false };
+        bool                    m_done { false };
+        void run();
+#endif
+        void hand_over();
+        void reset_put_area() { setp(m_front.data(), m_front.data() + m_front.size()); }
+
+    protected:
+        int_type overflow(int_type ch) override;
+        int sync() override;
+
+    public:
+        drat_writer(char const* file_name, bool binary, bool async);
+        ~drat_writer() override;
+        bool is_open() const { return m_out.is_open(); }
+        void flush();
+    };
+}
@@ -199,9 +199,7 @@ namespace sat {
                 SASSERT(*it == &c);
                 if (j < sz) {
                     c.shrink(j);
-                }
-                else {
-                    c.update_approx();
+                    m_solver.clause_lits_removed(sz - j);
                 }
                 if (m_solver.m_config.m_drat) {
                     m_solver.m_drat.add(c, status::redundant());
@@ -93,6 +93,7 @@ namespace sat{
         simp.save_clauses(mc_entry, simp.m_pos_cls);
         simp.save_clauses(mc_entry, simp.m_neg_cls);
         s.m_eliminated[v] = true;
+        ++s.m_num_eliminated;
         ++s.m_stats.m_elim_var_bdd;
         simp.remove_bin_clauses(pos_l);
         simp.remove_bin_clauses(neg_l);
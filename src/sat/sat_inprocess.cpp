@@ -0,0 +1,135 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.cpp
+
+Abstract:
+
+    Scheduler for the inprocessing techniques of the SAT solver.
+
+--*/
+#include "sat/sat_inprocess.h"
+#include "sat/sat_params.hpp"
+#include "util/trace.h"
+#include <algorithm>
+
+namespace sat {
+
+    // statistics keys are not copied, so they are kept as literals.
+    struct technique_keys {
+        char const* m_name;
+        char const* m_calls;
+        char const* m_skipped;
+        char const* m_time;
+        char const* m_removed;
+        char const* m_efficiency;
+    };
+
+#define TECHNIQUE_KEYS(NAME) { NAME, "sat inprocess " NAME " calls", "sat inprocess " NAME " skipped", \
+            "sat inprocess " NAME " time", "sat inprocess " NAME " removed", "sat inprocess " NAME " efficiency" }
+
+    static technique_keys const g_keys[inprocess::num_techniques] = {
+        TECHNIQUE_KEYS("cleaner"),
+        TECHNIQUE_KEYS("scc"),
+        TECHNIQUE_KEYS("simplifier"),
+        TECHNIQUE_KEYS("simplifier-learned"),
+        TECHNIQUE_KEYS("probing"),
+        TECHNIQUE_KEYS("asymm-branch"),
+        TECHNIQUE_KEYS("lookahead"),
+        TECHNIQUE_KEYS("binspr"),
+        TECHNIQUE_KEYS("anf"),
+        TECHNIQUE_KEYS("cut"),
+    };
+
+    char const* inprocess::name(technique t) {
+        return g_keys[t].m_name;
+    }
+
+    void inprocess::updt_params(params_ref const& _p) {
+        sat_params p(_p);
+        m_adaptive = p.inprocess_adaptive();
+        m_max_delay = p.inprocess_max_delay();
+        m_min_ratio = p.inprocess_min_ratio();
+    }
+
+    double inprocess::average_efficiency() const {
+        double sum = 0;
+        unsigned n = 0;
+        for (record const& r : m_records) {
+            if (r.m_calls > 0) {
+                sum += r.m_efficiency;
+                ++n;
+            }
+        }
+        return n == 0 ? 0 : sum / n;
+    }
+
+    bool inprocess::should_run(technique t) {
+        record& r = m_records[t];
+        if (!m_adaptive || r.m_wait == 0)
+            return true;
+        --r.m_wait;
+        ++r.m_skipped;
+        return false;
+    }
+
+    void inprocess::start(technique t, uint64_t size) {
+        m_current = t;
+        m_size = size;
+        m_watch.reset();
+        m_watch.start();
+    }
+
+    /**
+       \brief a call is productive if it reduced the clause database and its 
+       smoothed efficiency is at least m_min_ratio of the average efficiency.
+       Unproductive calls double the delay, productive calls halve it.
+     */
+    void inprocess::stop(uint64_t size) {
+        if (m_current == num_techniques)
+            return;
+        m_watch.stop();
+        record& r = m_records[m_current];
+        double secs = m_watch.get_seconds();
+        uint64_t removed = size < m_size ? m_size - size : 0;
+        double eff = removed / std::max(secs, 0.001);
+        r.m_efficiency = r.m_calls == 0 ? eff : (r.m_efficiency + eff) / 2;
+        ++r.m_calls;
+        r.m_time += secs;
+        r.m_removed += removed;
+        bool productive = removed > 0 && r.m_efficiency >= m_min_ratio * average_efficiency();
+        if (productive)
+            r.m_delay /= 2;
+        else
+            r.m_delay = std::min(m_max_delay, 2 * r.m_delay + 1);
+        r.m_wait = r.m_delay;
+        IF_VERBOSE(3, verbose_stream() << "(sat.inprocess :" << name(m_current) << " :removed " << removed 
+                   << " :time " << secs << " :efficiency " << r.m_efficiency << " :delay " << r.m_delay << ")\n";);
+        m_current = num_techniques;
+    }
+
+    void inprocess::collect_statistics(statistics& st) const {
+        for (unsigned i = 0; i < num_techniques; ++i) {
+            record const& r = m_records[i];
+            if (r.m_calls == 0 && r.m_skipped == 0)
+                continue;
+            technique_keys const& k = g_keys[i];
+            st.update(k.m_calls, r.m_calls);
+            st.update(k.m_skipped, r.m_skipped);
+            st.update(k.m_time, r.m_time);
+            st.update(k.m_removed, static_cast<double>(r.m_removed));
+            st.update(k.m_efficiency, r.m_removed / std::max(r.m_time, 0.001));
+        }
+    }
+
+    void inprocess::reset_statistics() {
+        for (record& r : m_records) {
+            r.m_calls = 0;
+            r.m_skipped = 0;
+            r.m_time = 0;
+            r.m_removed = 0;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.h
+
+Abstract:
+
+    Scheduler for the inprocessing techniques of the SAT solver.
+
+    Each technique is timed and its effect is measured as the 
+    reduction of the size of the clause database (literals in 
+    clauses plus active variables, see solver::inprocess_size). The efficiency of a technique
+    is the reduction per second, smoothed over its calls.
+    A technique that removes nothing, or whose efficiency falls
+    far below the average efficiency of the techniques, is delayed
+    for an exponentially growing number of rounds, in the style of
+    Kissat. Productive techniques get their rounds back, so the time
+    spent on inprocessing shifts to the techniques that pay off.
+
+--*/
+#pragma once
+
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+#include "util/params.h"
+
+namespace sat {
+
+    class inprocess {
+    public:
+        enum technique {
+            cleaner_t,
+            scc_t,
+            simplifier_t,          // subsumption, blocked clauses, resolution: the whole simplifier
+            simplifier_learned_t,
+            probing_t,
+            asymm_branch_t,
+            lookahead_t,
+            binspr_t,
+            anf_t,
+            cut_t,
+            num_techniques
+        };
+
+    private:
+        struct record {
+            unsigned m_calls { 0 };
+            unsigned m_skipped { 0 };
+            unsigned m_delay { 0 };    // rounds to skip after an unproductive call
+            unsigned m_wait { 0 };     // rounds left until the next call
+            double   m_time { 0 };
+            uint64_t m_removed { 0 };
+            double   m_efficiency { 0 };
+        };
+
+        record    m_records[num_techniques];
+        bool      m_adaptive { false };
+        unsigned  m_max_delay { 8 };
+        double    m_min_ratio { 0.1 };
+        technique m_current { num_techniques };
+        uint64_t  m_size { 0 };
+        stopwatch m_watch;
+
+        double average_efficiency() const;
+
+    public:
+        static char const* name(technique t);
+
+        void updt_params(params_ref const& p);
+
+        /**
+           \brief check if technique t is scheduled for this round. 
+           Otherwise the remaining delay of t is decremented.
+         */
+        bool should_run(technique t);
+
+        /**
+           \brief record the time and the size reduction of technique t.
+           size is the size of the clause database before and after the call.
+         */
+        void start(technique t, uint64_t size);
+        void stop(uint64_t size);
+
+        void collect_statistics(statistics& st) const;
+        void reset_statistics();
+    };
+}
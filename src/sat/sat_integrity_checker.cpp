@@ -27,6 +27,13 @@ namespace sat {
         s(_s) {
     }
     
+    static bool is_ternary_watched(watch_list const & wlist, clause_offset cls_off) {
+        for (watched const& w : wlist) 
+            if (w.is_ternary_clause() && w.get_clause_offset() == cls_off)
+                return true;
+        return false;
+    }
+
     // for nary clauses
     static bool contains_watched(watch_list const & wlist, clause const & c, clause_offset cls_off) {
         for (watched const& w : wlist) {
@@ -37,6 +44,13 @@ namespace sat {
                     return true;
                 }
             }
+            else if (w.is_ternary_clause()) {
+                if (w.get_clause_offset() == cls_off) {
+                    VERIFY(c.contains(w.literal1()));
+                    VERIFY(c.contains(w.literal2()));
+                    return true;
+                }
+            }
         }
         UNREACHABLE();
         return false;
@@ -53,12 +67,24 @@ namespace sat {
             VERIFY(!s.was_eliminated(c[i].var()));
         }
 
-        SASSERT(c.check_approx());
-        
         if (c.frozen())
             return true;
 
-        {
+        if (c.size() == 3 && is_ternary_watched(s.get_wlist(~c[0]), s.get_offset(c))) {
+            // ternary clauses attached as such are watched on all literals.
+            // Clauses that were shrunk to three literals keep their two watches.
+            unsigned num_false = 0;
+            bool on_prop_stack = false;
+            for (literal l : c) {
+                num_false += s.value(l) == l_false;
+                for (unsigned i = s.m_qhead; i < s.m_trail.size() && !on_prop_stack; i++) 
+                    on_prop_stack = s.m_trail[i].var() == l.var();
+                VERIFY(contains_watched(s.get_wlist(~l), c, s.get_offset(c)));
+            }
+            // the clause is satisfied or it has at most one false literal.
+            VERIFY(on_prop_stack || num_false <= 1 || s.status(c) == l_true);
+        }
+        else {
             if (s.value(c[0]) == l_false || s.value(c[1]) == l_false) {
                 bool on_prop_stack = false;
                 for (unsigned i = s.m_qhead; i < s.m_trail.size(); i++) {
@@ -156,6 +182,7 @@ namespace sat {
                 VERIFY(find_binary_watch(s.get_wlist(~(w.get_literal())), l));
                 break;
             case watched::CLAUSE:
+            case watched::TERNARY:
                 VERIFY(!s.get_clause(w.get_clause_offset()).was_removed());
                 break;
             default:
@@ -20,6 +20,7 @@ Notes:
 #include "sat/sat_local_search.h"
 #include "sat/sat_solver.h"
 #include "sat/sat_params.hpp"
+#include "sat/sat_simd.h"
 #include "util/timer.h"
 
 namespace sat {
@@ -70,14 +71,12 @@ namespace sat {
             bool is_true = cur_solution(v);
             coeff_vector& truep = m_vars[v].m_watch[is_true];
             for (auto const& coeff : truep) {
-                unsigned c = coeff.m_constraint_id;
-                constraint& cn = m_constraints[c];
-                cn.m_slack -= coeff.m_coeff;
+                m_slack[coeff.m_constraint_id] -= coeff.m_coeff;
             }            
         }
         for (unsigned c = 0; c < num_constraints(); ++c) {
             // violate the at-most-k constraint
-            if (m_constraints[c].m_slack < 0)
+            if (m_slack[c] < 0)
                 unsat(c);
         }
     }
@@ -89,21 +88,21 @@ namespace sat {
             coeff_vector& truep = m_vars[v].m_watch[is_true];
             coeff_vector& falsep = m_vars[v].m_watch[!is_true];
             for (auto const& coeff : falsep) {
-                constraint& c = m_constraints[coeff.m_constraint_id];
+                int64_t slack = m_slack[coeff.m_constraint_id];
                 // will --slack
-                if (c.m_slack <= 0) {
+                if (slack <= 0) {
                     dec_slack_score(v);
-                    if (c.m_slack == 0)
+                    if (slack == 0)
                         dec_score(v);
                 }
             }
             for (auto const& coeff : truep) {
-                constraint& c = m_constraints[coeff.m_constraint_id];
+                int64_t slack = m_slack[coeff.m_constraint_id];
                 // will --true_terms_count[c]
                 // will ++slack
-                if (c.m_slack <= -1) {
+                if (slack <= -1) {
                     inc_slack_score(v);
-                    if (c.m_slack == -1)
+                    if (slack == -1)
                         inc_score(v);
                 }
             }
@@ -138,8 +137,8 @@ namespace sat {
             m_noise += (10000 - m_noise) * m_noise_delta;
         }
 
-        for (constraint & c : m_constraints) {
-            c.m_slack = c.m_k;
+        for (unsigned i = 0; i < num_constraints(); ++i) {
+            m_slack[i] = m_constraints[i].m_k;
         }
         
         // init unsat stack
@@ -268,7 +267,7 @@ namespace sat {
     }
 
     void local_search::verify_slack(constraint const& c) const {
-        VERIFY(constraint_value(c) + c.m_slack == c.m_k);
+        VERIFY(constraint_value(c) + m_slack[c.m_id] == c.m_k);
     }
 
     void local_search::verify_slack() const {
@@ -307,6 +306,7 @@ namespace sat {
         }
         unsigned id = m_constraints.size();
         m_constraints.push_back(constraint(k, id));
+        m_slack.push_back(0);
         for (unsigned i = 0; i < sz; ++i) {
             m_vars.reserve(c[i].var() + 1);
             literal t(~c[i]);            
@@ -325,6 +325,7 @@ namespace sat {
         m_is_pb = true;
         unsigned id = m_constraints.size();
         m_constraints.push_back(constraint(k, id));
+        m_slack.push_back(0);
         for (unsigned i = 0; i < sz; ++i) {
             m_vars.reserve(c[i].var() + 1);            
             literal t(c[i]);            
@@ -373,10 +374,12 @@ namespace sat {
         m_is_pb = false;
         m_vars.reset();
         m_constraints.reset();
+        m_slack.reset();
         m_units.reset();
         m_unsat_stack.reset();
         m_vars.reserve(s.num_vars());
         m_config.set_config(s.get_config());
+        m_config.m_simd = m_config.m_simd && has_avx2();
 
         if (m_config.phase_sticky()) {
             unsigned v = 0;
@@ -615,9 +618,10 @@ namespace sat {
                     v = l.var();                    
                     unsigned bsb = 0;
                     coeff_vector const& falsep = m_vars[v].m_watch[!cur_solution(v)];
-                    auto it = falsep.begin(), end = falsep.end();
-                    for (; it != end; ++it) {
-                        int64_t slack = constraint_slack(it->m_constraint_id);
+                    unsigned k = 0, sz = falsep.size();
+                    for (; k < sz; ++k) {
+                        pbcoeff pbc = falsep[k];
+                        int64_t slack = constraint_slack(pbc.m_constraint_id);
                         if (slack < 0) {
                             if (bsb == best_bsb) {
                                 break;
@@ -626,14 +630,14 @@ namespace sat {
                                 ++bsb;
                             }
                         }
-                        else if (slack < static_cast<int64_t>(it->m_coeff)) {
+                        else if (slack < static_cast<int64_t>(pbc.m_coeff)) {
                             bsb += num_unsat;
                             if (bsb > best_bsb) {
                                 break;
                             }
                         }
                     }
-                    if (it == end) {
+                    if (k == sz) {
                         if (bsb < best_bsb) {
                             best_bsb = bsb;
                             best_var = v;
@@ -701,23 +705,33 @@ namespace sat {
         coeff_vector const& truep = m_vars[flipvar].m_watch[flip_is_true];
         coeff_vector const& falsep = m_vars[flipvar].m_watch[!flip_is_true];
 
-        for (auto const& pbc : truep) {
+        unsigned i = 0, sz = truep.size();
+#ifdef SAT_AVX2
+        if (m_config.simd())
+            i = dec_slacks_simd(truep);
+#endif
+        for (; i < sz; ++i) {
+            pbcoeff pbc = truep[i];
             unsigned ci = pbc.m_constraint_id;
-            constraint& c = m_constraints[ci];
-            auto old_slack = c.m_slack;
-            c.m_slack -= pbc.m_coeff;
-            DEBUG_CODE(verify_slack(c););
-            if (c.m_slack < 0 && old_slack >= 0) { // from non-negative to negative: sat -> unsat
+            int64_t old_slack = m_slack[ci];
+            m_slack[ci] = old_slack - pbc.m_coeff;
+            DEBUG_CODE(verify_slack(m_constraints[ci]););
+            if (m_slack[ci] < 0 && old_slack >= 0) { // from non-negative to negative: sat -> unsat
                 unsat(ci);
             }
         }
-        for (auto const& pbc : falsep) {
+        i = 0, sz = falsep.size();
+#ifdef SAT_AVX2
+        if (m_config.simd())
+            i = inc_slacks_simd(falsep);
+#endif
+        for (; i < sz; ++i) {
+            pbcoeff pbc = falsep[i];
             unsigned ci = pbc.m_constraint_id;
-            constraint& c = m_constraints[ci];
-            auto old_slack = c.m_slack;
-            c.m_slack += pbc.m_coeff;
-            DEBUG_CODE(verify_slack(c););
-            if (c.m_slack >= 0 && old_slack < 0) { // from negative to non-negative: unsat -> sat
+            int64_t old_slack = m_slack[ci];
+            m_slack[ci] = old_slack + pbc.m_coeff;
+            DEBUG_CODE(verify_slack(m_constraints[ci]););
+            if (m_slack[ci] >= 0 && old_slack < 0) { // from negative to non-negative: unsat -> sat
                 sat(ci);
             }
         }
@@ -725,6 +739,77 @@ namespace sat {
         DEBUG_CODE(verify_unsat_stack(););
     }
 
+#ifdef SAT_AVX2
+    /**
+       \brief subtract the coefficients of a watch list from the slacks of its
+       constraints 4 at a time. The slacks are gathered in AVX2 registers and
+       only the constraints that become violated are processed further.
+       A constraint occurs at most once in a watch list, so the stores do not
+       overlap. Returns the position of the tail that is left to the scalar loop.
+     */
+    SAT_AVX2_TARGET unsigned local_search::dec_slacks_simd(coeff_vector const& watch) {
+        long long const* slack = reinterpret_cast<long long const*>(m_slack.data());
+        unsigned const* ids = watch.ids();
+        unsigned const* coeffs = watch.coeffs();
+        unsigned sz = watch.size(), i = 0;
+        alignas(32) int64_t slacks[4];
+        for (; i + 4 <= sz; i += 4) {
+            __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ids + i));
+            __m256i c = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(coeffs + i)));
+            __m256i old_slack = _mm256_i32gather_epi64(slack, idx, 8);
+            __m256i new_slack = _mm256_sub_epi64(old_slack, c);
+            // the sign bit of ~old_slack & new_slack is set when the slack becomes negative
+            unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(old_slack, new_slack)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(slacks), new_slack);
+            for (unsigned k = 0; k < 4; ++k) {
+                m_slack[ids[i + k]] = slacks[k];
+                DEBUG_CODE(verify_slack(m_constraints[ids[i + k]]););
+            }
+            for (unsigned k = 0; mask; ++k, mask >>= 1)
+                if (mask & 1)
+                    unsat(ids[i + k]);
+        }
+        return i;
+    }
+
+    /**
+       \brief add the coefficients of a watch list to the slacks of its
+       constraints 4 at a time, see dec_slacks_simd.
+     */
+    SAT_AVX2_TARGET unsigned local_search::inc_slacks_simd(coeff_vector const& watch) {
+        long long const* slack = reinterpret_cast<long long const*>(m_slack.data());
+        unsigned const* ids = watch.ids();
+        unsigned const* coeffs = watch.coeffs();
+        unsigned sz = watch.size(), i = 0;
+        alignas(32) int64_t slacks[4];
+        for (; i + 4 <= sz; i += 4) {
+            __m128i idx = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ids + i));
+            __m256i c = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<__m128i const*>(coeffs + i)));
+            __m256i old_slack = _mm256_i32gather_epi64(slack, idx, 8);
+            __m256i new_slack = _mm256_add_epi64(old_slack, c);
+            // the sign bit of old_slack & ~new_slack is set when the slack becomes non-negative
+            unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(new_slack, old_slack)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(slacks), new_slack);
+            for (unsigned k = 0; k < 4; ++k) {
+                m_slack[ids[i + k]] = slacks[k];
+                DEBUG_CODE(verify_slack(m_constraints[ids[i + k]]););
+            }
+            for (unsigned k = 0; mask; ++k, mask >>= 1)
+                if (mask & 1)
+                    sat(ids[i + k]);
+        }
+        return i;
+    }
+#else
+    unsigned local_search::dec_slacks_simd(coeff_vector const& watch) {
+        return 0;
+    }
+
+    unsigned local_search::inc_slacks_simd(coeff_vector const& watch) {
+        return 0;
+    }
+#endif
+
     void local_search::set_parameters()  {
         m_rand.set_seed(m_config.random_seed());
         m_best_known_value = m_config.best_known_value();
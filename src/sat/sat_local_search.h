@@ -35,6 +35,7 @@ namespace sat {
         local_search_mode m_mode;
         bool              m_phase_sticky;
         bool              m_dbg_flips;
+        bool              m_simd;
         double            m_itau;
 
         friend class local_search;
@@ -44,6 +45,7 @@ namespace sat {
             m_random_seed  = cfg.m_random_seed;
             m_phase_sticky = cfg.m_phase_sticky;
             m_dbg_flips    = cfg.m_local_search_dbg_flips;
+            m_simd         = cfg.m_local_search_simd;
         }
 
     public:
@@ -53,6 +55,7 @@ namespace sat {
             m_mode = local_search_mode::wsat;
             m_phase_sticky = false;
             m_dbg_flips = false;
+            m_simd = false;
             m_itau = 0.5;
         }
 
@@ -61,10 +64,12 @@ namespace sat {
         local_search_mode mode() const { return m_mode; }
         bool phase_sticky() const { return m_phase_sticky; }
         bool dbg_flips() const { return m_dbg_flips; }
+        bool simd() const { return m_simd; }
         double itau() const { return m_itau; }
         
         void set_random_seed(unsigned s) { m_random_seed = s;  }
         void set_best_known_value(unsigned v) { m_best_known_value = v; }
+        void set_simd(bool f) { m_simd = f; }
 
     };
 
@@ -77,7 +82,30 @@ namespace sat {
             pbcoeff(unsigned id, unsigned coeff):
                 m_constraint_id(id), m_coeff(coeff) {}
         };
-        typedef svector<pbcoeff> coeff_vector;
+
+        // the constraints of a literal and the coefficients of the literal in them,
+        // kept as two arrays so that a flip can update several slacks at a time
+        class coeff_vector {
+            unsigned_vector m_ids;
+            unsigned_vector m_coeffs;
+        public:
+            class iterator {
+                coeff_vector const* m_v;
+                unsigned            m_i;
+            public:
+                iterator(coeff_vector const* v, unsigned i): m_v(v), m_i(i) {}
+                pbcoeff operator*() const { return (*m_v)[m_i]; }
+                iterator& operator++() { ++m_i; return *this; }
+                bool operator!=(iterator const& other) const { return m_i != other.m_i; }
+            };
+            void push_back(pbcoeff const& c) { m_ids.push_back(c.m_constraint_id); m_coeffs.push_back(c.m_coeff); }
+            unsigned size() const { return m_ids.size(); }
+            pbcoeff operator[](unsigned i) const { return pbcoeff(m_ids[i], m_coeffs[i]); }
+            unsigned const* ids() const { return m_ids.data(); }
+            unsigned const* coeffs() const { return m_coeffs.data(); }
+            iterator begin() const { return iterator(this, 0); }
+            iterator end() const { return iterator(this, size()); }
+        };
 
 
         struct stats {
@@ -112,10 +140,9 @@ namespace sat {
         struct constraint {
             unsigned        m_id;
             unsigned        m_k;
-            int64_t         m_slack;
             unsigned        m_size;
             literal_vector  m_literals;
-            constraint(unsigned k, unsigned id) : m_id(id), m_k(k), m_slack(0), m_size(0) {}
+            constraint(unsigned k, unsigned id) : m_id(id), m_k(k), m_size(0) {}
             void push(literal l) { m_literals.push_back(l); ++m_size; }
             unsigned size() const { return m_size; }
             literal const& operator[](unsigned idx) const { return m_literals[idx]; }
@@ -131,6 +158,7 @@ namespace sat {
         bool_vector       m_best_phase;                // best value in round
         svector<bool_var>   m_units;                     // unit clauses
         vector<constraint>  m_constraints;               // all constraints
+        svector<int64_t>    m_slack;                     // constraint -> slack, kept apart from m_constraints for cache locality during flips
         literal_vector      m_assumptions;               // temporary assumptions
         literal_vector      m_prop_queue;                // propagation queue
         unsigned            m_num_non_binary_clauses;       
@@ -187,7 +215,7 @@ namespace sat {
 
         unsigned num_constraints() const { return m_constraints.size(); } // constraint index from 1 to num_constraint
 
-        int64_t constraint_slack(unsigned ci) const { return m_constraints[ci].m_slack; }
+        int64_t constraint_slack(unsigned ci) const { return m_slack[ci]; }
 
         void init();
         void reinit();
@@ -199,6 +227,10 @@ namespace sat {
         void pick_flip_lookahead();
         void pick_flip_walksat();
         void flip_walksat(bool_var v);
+
+        unsigned dec_slacks_simd(coeff_vector const& watch);
+
+        unsigned inc_slacks_simd(coeff_vector const& watch);
         bool propagate(literal lit);
         void add_propagation(literal lit);
         void walksat();
@@ -2233,6 +2233,30 @@ namespace sat {
     }
 
 
+    literal lookahead::select_lookahead(literal_vector const& assumptions, bool_var_vector const& vars) {
+        IF_VERBOSE(10, verbose_stream() << "(sat-select :assumptions " << assumptions.size() << " :vars " << vars.size() << ")\n";);
+        scoped_ext _sext(*this);
+        m_search_mode = lookahead_mode::searching;
+        scoped_level _sl(*this, c_fixed_truth);
+        init(true);
+        if (inconsistent()) 
+            return null_literal;
+        inc_istamp();
+        m_select_lookahead_vars.reset();
+        for (auto v : vars) 
+            m_select_lookahead_vars.insert(v);        
+        literal l = null_literal;
+        {
+            scoped_assumptions _sa(*this, assumptions);
+            if (!inconsistent())
+                l = choose();
+            if (inconsistent())
+                l = null_literal;
+        }
+        m_select_lookahead_vars.reset();
+        return l;
+    }
+
     void lookahead::display_lookahead_scores(std::ostream& out) {
         scoped_ext _scoped_ext(*this);
         m_select_lookahead_vars.reset();
@@ -601,6 +601,14 @@ namespace sat {
 
         lbool cube(bool_var_vector& vars, literal_vector& lits, unsigned backtrack_level);
 
+        /**
+           \brief select the best literal to split on under the given assumptions.
+           The candidates are restricted to vars, unless vars is empty.
+           Returns null_literal if the assumptions are inconsistent or there is
+           no literal left to split on.
+        */
+        literal select_lookahead(literal_vector const& assumptions, bool_var_vector const& vars);
+
         void update_cube_statistics(statistics& st);
 
         /**
@@ -22,75 +22,111 @@ Revision History:
 
 namespace sat {
 
-    void parallel::vector_pool::next(unsigned& index) {
-        SASSERT(index < m_size);
-        unsigned n = index + 2 + get_length(index);
-        if (n >= m_size) {
-            index = 0;
-        }
-        else {
-            index = n;
-        }
+    parallel::vector_ring::vector_ring(unsigned sz):
+        m_write_seq(0),
+        m_published(0) {
+        unsigned cap = 16;
+        while (cap < sz) 
+            cap *= 2;
+        m_mask = cap - 1;
+        m_data = alloc_vect<std::atomic<unsigned>>(cap);
+        for (unsigned i = 0; i < cap; ++i)
+            m_data[i].store(0, std::memory_order_relaxed);
     }
 
-    void parallel::vector_pool::reserve(unsigned num_threads, unsigned sz) {
-        m_vectors.reset();
-        m_vectors.resize(sz, 0);
-        m_heads.reset();
-        m_heads.resize(num_threads, 0);
-        m_at_end.reset();
-        m_at_end.resize(num_threads, true);
-        m_tail = 0;
-        m_size = sz;
+    parallel::vector_ring::~vector_ring() {
+        dealloc_vect(m_data, capacity());
     }
-    
-    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
-        SASSERT(m_tail < m_size);
-        unsigned capacity = n + 2;
-        m_vectors.reserve(m_size + capacity, 0);
-        IF_VERBOSE(3, verbose_stream() << owner << ": begin-add " << n << " tail: " << m_tail << " size: " << m_size << "\n";);
-        for (unsigned i = 0; i < m_heads.size(); ++i) {
-            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
-                next(m_heads[i]);
-            }
-            m_at_end[i] = false;
-        }
-        m_vectors[m_tail++] = owner;
-        m_vectors[m_tail++] = n;    
+
+    /**
+       \brief append a vector to the ring. Only the owning thread calls push.
+       The write sequence is advanced before the slots of the previous lap
+       are overwritten, so that readers copying those slots can detect it.
+     */
+    bool parallel::vector_ring::push(unsigned n, unsigned const* elems) {
+        if (n + 2 > capacity())
+            return false;
+        uint64_t tail = m_published.load(std::memory_order_relaxed);
+        uint64_t end = tail + n + 2;
+        m_write_seq.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        set(tail, n);
+        set(tail + 1, m_num_vectors++);
+        for (unsigned i = 0; i < n; ++i)
+            set(tail + 2 + i, elems[i]);
+        m_published.store(end, std::memory_order_release);
+        return true;
+    }
+
+    /**
+       \brief read the vector at position pos. 
+       Return l_undef if there are no new vectors, l_false if the reader was
+       overrun by the producer and l_true if out contains the vector with sequence number seq.
+     */
+    lbool parallel::vector_ring::read(uint64_t& pos, unsigned& seq, unsigned_vector& out) const {
+        uint64_t tail = m_published.load(std::memory_order_acquire);
+        if (pos == tail)
+            return l_undef;
+        if (tail - pos > capacity())
+            return l_false;
+        unsigned n = get(pos);
+        if (pos + n + 2 > tail)
+            return l_false;
+        seq = get(pos + 1);
+        out.reset();
+        for (unsigned i = 0; i < n; ++i)
+            out.push_back(get(pos + 2 + i));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // seqlock validation: the slots copied were not rewritten meanwhile
+        if (m_write_seq.load(std::memory_order_relaxed) > pos + capacity())
+            return l_false;
+        pos += n + 2;
+        return l_true;
     }
 
-    void parallel::vector_pool::add_vector_elem(unsigned e) {
-        m_vectors[m_tail++] = e;
+    parallel::unit_log::unit_log():
+        m_size(0) {
+        for (unsigned c = 0; c < max_chunks; ++c)
+            m_chunks[c].store(nullptr, std::memory_order_relaxed);
     }
 
-    void parallel::vector_pool::end_add_vector() {
-        if (m_tail >= m_size) {
-            m_tail = 0;
+    parallel::unit_log::~unit_log() {
+        for (unsigned c = 0; c < max_chunks; ++c) {
+            unsigned* chunk = m_chunks[c].load(std::memory_order_relaxed);
+            if (chunk)
+                dealloc_svect(chunk);
         }
     }
 
+    unsigned parallel::unit_log::operator[](unsigned i) const {
+        SASSERT(i < size());
+        unsigned c = chunk_of(i);
+        return m_chunks[c].load(std::memory_order_acquire)[i - chunk_start(c)];
+    }
 
-    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
-        unsigned head = m_heads[owner];      
-        unsigned iterations = 0;
-        while (head != m_tail || !m_at_end[owner]) {
-            ++iterations;
-            SASSERT(head < m_size && m_tail < m_size);            
-            bool is_self = owner == get_owner(head);
-            next(m_heads[owner]);
-            IF_VERBOSE(static_cast<unsigned>(iterations > m_size ? 0 : 3), verbose_stream() << owner << ": [" << head << ":" << m_heads[owner] << "] tail: " << m_tail << "\n";);
-            m_at_end[owner] = (m_heads[owner] == m_tail);
-            if (!is_self) {
-                n = get_length(head);
-                ptr = get_ptr(head);
-                return true;
-            }
-            head = m_heads[owner];
+    /**
+       \brief append a unit. Only the owning thread calls push_back.
+       The slot is written before the size that makes it visible is published.
+     */
+    void parallel::unit_log::push_back(unsigned e) {
+        unsigned i = m_size.load(std::memory_order_relaxed);
+        unsigned c = chunk_of(i);
+        VERIFY(c < max_chunks);
+        unsigned* chunk = m_chunks[c].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = alloc_svect(unsigned, base_size << c);
+            m_chunks[c].store(chunk, std::memory_order_release);
         }
-        return false;
+        chunk[i - chunk_start(c)] = e;
+        m_size.store(i + 1, std::memory_order_release);
     }
 
-    parallel::parallel(solver& s): m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
+    parallel::parallel(solver& s): 
+        m_max_glue(s.get_config().m_par_max_glue),
+        m_max_size(s.get_config().m_par_max_size),
+        m_num_clauses(0), 
+        m_consumer_ready(false), 
+        m_scoped_rlimit(s.rlimit()) {}
 
     parallel::~parallel() {
         for (unsigned i = 0; i < m_solvers.size(); ++i) {            
@@ -122,24 +158,38 @@ namespace sat {
         m_scoped_rlimit.push_child(&rl);            
     }
 
+    void parallel::reserve(unsigned num_owners, unsigned sz) {
+        m_rings.reset();
+        m_units.reset();
+        m_unit_seen.reset();
+        for (unsigned i = 0; i < num_owners; ++i) {
+            m_rings.push_back(alloc(vector_ring, sz));
+            m_units.push_back(alloc(unit_log));
+        }
+        m_unit_seen.resize(num_owners);
+        m_cursors.reset();
+        m_cursors.resize(num_owners * num_owners);
+    }
+
 
-    void parallel::exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out) {
+    void parallel::publish(solver& s, unsigned n, unsigned const* elems) {
+        if (m_rings[s.m_par_id]->push(n, elems))
+            ++s.m_stats.m_par_shared;
+    }
+
+    void parallel::share_units(solver& s, literal_vector const& units) {
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        {
-            lock_guard lock(m_mux);
-            if (limit < m_units.size()) {
-                // this might repeat some literals.
-                out.append(m_units.size() - limit, m_units.data() + limit);
-            }
-            for (unsigned i = 0; i < in.size(); ++i) {
-                literal lit = in[i];
-                if (!m_unit_set.contains(lit.index())) {
-                    m_unit_set.insert(lit.index());
-                    m_units.push_back(lit);
-                }
-            }
-            limit = m_units.size();
+        bool_vector& seen = m_unit_seen[s.m_par_id];
+        unit_log& log = *m_units[s.m_par_id];
+        for (literal lit : units) {
+            unsigned idx = lit.index();
+            if (idx < seen.size() && seen[idx])
+                continue;
+            seen.reserve(idx + 1, false);
+            seen[idx] = true;
+            log.push_back(idx);
+            ++s.m_stats.m_par_shared;
         }
     }
 
@@ -147,59 +197,88 @@ namespace sat {
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
         IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  l1 << " " << l2 << "\n";);
-        {
-            lock_guard lock(m_mux);
-            m_pool.begin_add_vector(s.m_par_id, 2);
-            m_pool.add_vector_elem(l1.index());
-            m_pool.add_vector_elem(l2.index());            
-            m_pool.end_add_vector();
-        }        
+        unsigned elems[2] = { l1.index(), l2.index() };
+        publish(s, 2, elems);
     }
 
     void parallel::share_clause(solver& s, clause const& c) {        
         if (s.get_config().m_num_threads == 1 || !enable_add(c) || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        unsigned n = c.size();
-        unsigned owner = s.m_par_id;
-        IF_VERBOSE(3, verbose_stream() << owner << ": share " <<  c << "\n";);
-        lock_guard lock(m_mux);
-        m_pool.begin_add_vector(owner, n);                
-        for (unsigned i = 0; i < n; ++i) {
-            m_pool.add_vector_elem(c[i].index());
-        }
-        m_pool.end_add_vector();        
+        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  c << "\n";);
+        s.m_par_elems.reset();
+        for (literal lit : c) 
+            s.m_par_elems.push_back(lit.index());
+        publish(s, c.size(), s.m_par_elems.data());
     }
 
     void parallel::get_clauses(solver& s) {
         if (s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        lock_guard lock(m_mux);
-        _get_clauses(s);        
-    }
-
-    void parallel::_get_clauses(solver& s) {
-        unsigned n;
-        unsigned const* ptr;
         unsigned owner = s.m_par_id;
-        while (m_pool.get_vector(owner, n, ptr)) {
-            m_lits.reset();
-            bool usable_clause = true;
-            for (unsigned i = 0; usable_clause && i < n; ++i) {
-                literal lit(to_literal(ptr[i]));                
-                m_lits.push_back(lit);
-                usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
-            }
-            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << m_lits << "\n";);
-            SASSERT(n >= 2);
-            if (usable_clause) {
-                s.mk_clause_core(m_lits.size(), m_lits.data(), sat::status::redundant());
+        unsigned num_owners = m_rings.size();
+        unsigned seq = 0;
+        unsigned_vector& elems = s.m_par_elems;
+        literal_vector lits;
+        for (unsigned i = 0; i < num_owners && !s.inconsistent(); ++i) {
+            if (i == owner) 
+                continue;
+            vector_ring const& ring = *m_rings[i];
+            cursor& cur = m_cursors[owner * num_owners + i];
+            get_units(s, i, cur);
+            lbool r;
+            while (!s.inconsistent() && l_undef != (r = ring.read(cur.m_pos, seq, elems))) {
+                if (r == l_false) {
+                    // lapped by the producer: resume at the most recently published vector.
+                    ++s.m_stats.m_par_lapped;
+                    cur.m_pos = ring.tail();
+                    cur.m_resync = true;
+                    continue;
+                }
+                if (cur.m_resync) 
+                    s.m_stats.m_par_dropped += seq - cur.m_seq;                
+                cur.m_resync = false;
+                cur.m_seq = seq + 1;
+                lits.reset();
+                bool usable_clause = true;
+                for (unsigned j = 0; usable_clause && j < elems.size(); ++j) {
+                    literal lit(to_literal(elems[j]));
+                    lits.push_back(lit);
+                    usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
+                }
+                if (!usable_clause) {
+                    ++s.m_stats.m_par_dropped;
+                    continue;
+                }
+                IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << lits << "\n";);
+                ++s.m_stats.m_par_imported;
+                s.mk_clause_core(lits.size(), lits.data(), sat::status::redundant());
             }
         }        
     }
 
+    void parallel::get_units(solver& s, unsigned producer, cursor& cur) {
+        unit_log const& log = *m_units[producer];
+        bool_vector& seen = m_unit_seen[s.m_par_id];
+        unsigned sz = log.size();
+        for (; cur.m_unit_pos < sz && !s.inconsistent(); ++cur.m_unit_pos) {
+            unsigned idx = log[cur.m_unit_pos];
+            literal lit = to_literal(idx);
+            if (lit.var() >= s.m_par_num_vars || s.was_eliminated(lit.var())) {
+                ++s.m_stats.m_par_dropped;
+                continue;
+            }
+            // the unit is not published again by s
+            seen.reserve(idx + 1, false);
+            seen[idx] = true;
+            ++s.m_stats.m_par_imported;
+            if (s.lvl(lit.var()) != 0 || s.value(lit) != l_true)
+                s.assign_unit(lit);
+        }
+    }
+
     bool parallel::enable_add(clause const& c) const {
         // plingeling, glucose heuristic:
-        return (c.size() <= 40 && c.glue() <= 8) || c.glue() <= 2;
+        return (c.size() <= m_max_size && c.glue() <= m_max_glue) || c.glue() <= 2;
     }
 
     void parallel::_from_solver(solver& s) {
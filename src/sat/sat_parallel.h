@@ -19,48 +19,83 @@ Revision History:
 #pragma once
 
 #include "sat/sat_types.h"
-#include "util/hashtable.h"
-#include "util/map.h"
 #include "util/rlimit.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/mutex.h"
+#include <atomic>
 
 namespace sat {
 
     class parallel {
 
-        // shared pool of learned clauses.
-        class vector_pool {
-            unsigned_vector m_vectors;
-            unsigned        m_size{ 0 };
-            unsigned        m_tail{ 0 };
-            unsigned_vector m_heads;
-            bool_vector   m_at_end;
-            void next(unsigned& index);
-            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
-            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
-            unsigned const* get_ptr(unsigned index) const { return m_vectors.data() + index + 2; }
+        // Ring buffer of learned clauses published by a single thread.
+        // The owner is the only producer; every other thread reads it without locks.
+        // The producer overwrites the slots of the previous lap as it wraps around.
+        // Reads are validated as in a seqlock: the producer announces the slots it is
+        // about to write before writing them, and a reader that copied a vector checks
+        // afterwards that none of its slots was announced, otherwise the copy is discarded.
+        // A reader that is lapped resynchronizes at the current tail and
+        // accounts for the vectors it missed. Clauses are hints, losing them is harmless.
+        class vector_ring {
+            unsigned                m_mask;
+            std::atomic<unsigned>*  m_data;
+            std::atomic<uint64_t>   m_write_seq;  // end of the slots the producer writes, the seqlock sequence
+            std::atomic<uint64_t>   m_published;  // slots visible to consumers
+            unsigned                m_num_vectors { 0 };
+            unsigned get(uint64_t i) const { return m_data[i & m_mask].load(std::memory_order_relaxed); }
+            void set(uint64_t i, unsigned e) { m_data[i & m_mask].store(e, std::memory_order_relaxed); }
         public:
-            void reserve(unsigned num_owners, unsigned sz);
-            void begin_add_vector(unsigned owner, unsigned n);
-            void end_add_vector();
-            void add_vector_elem(unsigned e);
-            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+            vector_ring(unsigned sz);
+            ~vector_ring();
+            unsigned capacity() const { return m_mask + 1; }
+            uint64_t tail() const { return m_published.load(std::memory_order_acquire); }
+            bool push(unsigned n, unsigned const* elems);
+            lbool read(uint64_t& pos, unsigned& seq, unsigned_vector& out) const;
+        };
+
+        // Append-only log of the units published by a single thread.
+        // Units are facts, so unlike clauses none may be lost: the log never overwrites
+        // a slot. It grows in chunks of doubling size that stay in place, and readers
+        // read every slot below the published size without locks.
+        class unit_log {
+            static const unsigned   base_size = 256;
+            static const unsigned   max_chunks = 24;
+            std::atomic<unsigned*>  m_chunks[max_chunks];
+            std::atomic<unsigned>   m_size;
+            static unsigned chunk_of(unsigned i) { return log2(i / base_size + 1); }
+            static unsigned chunk_start(unsigned c) { return base_size * ((1u << c) - 1); }
+        public:
+            unit_log();
+            ~unit_log();
+            unsigned size() const { return m_size.load(std::memory_order_acquire); }
+            unsigned operator[](unsigned i) const;
+            void push_back(unsigned e);
+        };
+
+        // read position of a consumer in a producer's ring and unit log.
+        struct cursor {
+            uint64_t m_pos { 0 };
+            unsigned m_seq { 0 };
+            bool     m_resync { false };
+            unsigned m_unit_pos { 0 };
         };
 
         bool enable_add(clause const& c) const;
-        void _get_clauses(solver& s);
+        void publish(solver& s, unsigned n, unsigned const* elems);
         void _from_solver(solver& s);
         bool _to_solver(solver& s);
         bool _from_solver(i_local_search& s);
         void _to_solver(i_local_search& s);
 
-        typedef hashtable<unsigned, u_hash, u_eq> index_set;
-        literal_vector m_units;
-        index_set      m_unit_set;
-        literal_vector m_lits;
-        vector_pool    m_pool;
-        mutex          m_mux;
+        void get_units(solver& s, unsigned producer, cursor& cur);
+
+        scoped_ptr_vector<vector_ring> m_rings;
+        scoped_ptr_vector<unit_log>    m_units;
+        vector<bool_vector>            m_unit_seen; // literals published or imported by each owner, only the owner accesses its own
+        svector<cursor>                m_cursors;   // consumer x producer
+        unsigned                       m_max_glue;
+        unsigned                       m_max_size;
+        mutex                          m_mux;       // guards exchange with local search
 
         // for exchange with local search:
         unsigned           m_num_clauses;
@@ -82,22 +117,22 @@ namespace sat {
 
         void push_child(reslimit& rl);
 
-        // reserve space
-        void reserve(unsigned num_owners, unsigned sz) { m_pool.reserve(num_owners, sz); }
+        // allocate one ring of sz elements and one unit log per owner
+        void reserve(unsigned num_owners, unsigned sz);
 
         solver& get_solver(unsigned i) { return *m_solvers[i]; }
 
         void cancel_solver(unsigned i) { m_limits[i].cancel(); }
 
-        // exchange unit literals
-        void exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out);
+        // publish unit literals that were neither published nor imported by s before
+        void share_units(solver& s, literal_vector const& units);
 
-        // add clause to shared clause pool
+        // add clause to the solver's ring
         void share_clause(solver& s, clause const& c);
 
         void share_clause(solver& s, literal l1, literal l2);
         
-        // receive clauses from shared clause pool
+        // receive units and clauses from the unit logs and rings of the other solvers
         void get_clauses(solver& s);
 
         // exchange from solver state to local search and back.
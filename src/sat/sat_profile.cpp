@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_profile.cpp
+
+Abstract:
+
+    Profiling counters for the propagation loop of the SAT solver.
+
+--*/
+#include "sat/sat_profile.h"
+#include "util/util.h"
+#include <algorithm>
+
+namespace sat {
+
+    unsigned propagation_profile::bucket(unsigned n) {
+        return n == 0 ? 0 : std::min(NUM_BUCKETS - 1, log2(n) + 1);
+    }
+
+    void propagation_profile::reset() {
+        m_propagations = 0;
+        m_watches = 0;
+        m_blocker_hits = 0;
+        m_blocker_misses = 0;
+        m_clause_visits = 0;
+        m_cycles = 0;
+        m_max_watches = 0;
+        m_max_clause_visits = 0;
+        for (unsigned i = 0; i < NUM_BUCKETS; ++i) {
+            m_watch_histogram[i] = 0;
+            m_visit_histogram[i] = 0;
+        }
+        m_heat.reset();
+    }
+
+    void propagation_profile::collect_statistics(statistics& st) const {
+        double props = static_cast<double>(std::max<uint64_t>(1, m_propagations));
+        st.update("sat prof propagations", static_cast<double>(m_propagations));
+        st.update("sat prof watches", static_cast<double>(m_watches));
+        st.update("sat prof watches per propagation", m_watches / props);
+        st.update("sat prof max watches", m_max_watches);
+        st.update("sat prof blocker hits", static_cast<double>(m_blocker_hits));
+        st.update("sat prof blocker misses", static_cast<double>(m_blocker_misses));
+        st.update("sat prof clause visits per propagation", m_clause_visits / props);
+        st.update("sat prof max clause visits", m_max_clause_visits);
+        st.update("sat prof cycles", static_cast<double>(m_cycles));
+        st.update("sat prof cycles per propagation", m_cycles / props);
+    }
+
+    std::ostream& propagation_profile::display_json(std::ostream& out, unsigned max_heat) const {
+        out << "{\n";
+        out << "  \"propagations\": " << m_propagations << ",\n";
+        out << "  \"watches\": " << m_watches << ",\n";
+        out << "  \"max_watches\": " << m_max_watches << ",\n";
+        out << "  \"blocker_hits\": " << m_blocker_hits << ",\n";
+        out << "  \"blocker_misses\": " << m_blocker_misses << ",\n";
+        out << "  \"clause_visits\": " << m_clause_visits << ",\n";
+        out << "  \"max_clause_visits\": " << m_max_clause_visits << ",\n";
+        out << "  \"cycles\": " << m_cycles << ",\n";
+        // bucket 0 counts zero, bucket i > 0 counts [2^(i-1), 2^i), the last bucket is open ended.
+        auto display_histogram = [&](char const* name, uint64_t const* h) {
+            out << "  \"" << name << "\": [";
+            for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+                out << (i > 0 ? ", " : "") << h[i];
+            out << "],\n";
+        };
+        display_histogram("watches_histogram", m_watch_histogram);
+        display_histogram("clause_visits_histogram", m_visit_histogram);
+        unsigned_vector vars;
+        for (unsigned v = 0; v < m_heat.size(); ++v)
+            if (m_heat[v] > 0)
+                vars.push_back(v);
+        std::sort(vars.begin(), vars.end(), [&](unsigned a, unsigned b) { return m_heat[a] > m_heat[b] || (m_heat[a] == m_heat[b] && a < b); });
+        vars.shrink(std::min(max_heat, vars.size()));
+        out << "  \"heat_period\": " << HEAT_PERIOD << ",\n";
+        out << "  \"heat\": [";
+        for (unsigned i = 0; i < vars.size(); ++i)
+            out << (i > 0 ? ", " : "") << "{\"var\": " << vars[i] << ", \"samples\": " << m_heat[vars[i]] << "}";
+        out << "]\n";
+        out << "}\n";
+        return out;
+    }
+};
@@ -0,0 +1,120 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_profile.h
+
+Abstract:
+
+    Profiling counters for the propagation loop of the SAT solver.
+
+    The counters are only maintained when Z3 is built with
+    Z3_ENABLE_SAT_PROFILE (which defines Z3_SAT_PROFILE).
+    Otherwise SAT_PROFILE_CODE expands to nothing and the
+    propagation loop is not instrumented.
+
+--*/
+#pragma once
+
+#include "util/vector.h"
+#include "util/statistics.h"
+#include <chrono>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#ifdef Z3_SAT_PROFILE
+#define SAT_PROFILE_CODE(CODE) { CODE } ((void) 0)
+#else
+#define SAT_PROFILE_CODE(CODE) ((void) 0)
+#endif
+
+namespace sat {
+
+    inline uint64_t cycle_counter() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        return __builtin_ia32_rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    class propagation_profile {
+        static const unsigned NUM_BUCKETS = 16;
+        static const unsigned HEAT_PERIOD = 64;  // the variable of every HEAT_PERIOD-th propagation is sampled
+        uint64_t        m_propagations { 0 };
+        uint64_t        m_watches { 0 };
+        uint64_t        m_blocker_hits { 0 };
+        uint64_t        m_blocker_misses { 0 };
+        uint64_t        m_clause_visits { 0 };
+        uint64_t        m_cycles { 0 };
+        unsigned        m_max_watches { 0 };
+        unsigned        m_max_clause_visits { 0 };
+        uint64_t        m_watch_histogram[NUM_BUCKETS];
+        uint64_t        m_visit_histogram[NUM_BUCKETS];
+        unsigned_vector m_heat;   // number of sampled propagations per variable
+
+        static unsigned bucket(unsigned n);
+
+    public:
+
+        /**
+           \brief measure a single call to propagate_literal.
+           clause_visits is the solver counter of clause dereferences.
+         */
+        class scoped_propagate {
+            propagation_profile& m_profile;
+            unsigned const&      m_clause_visits;
+            unsigned             m_visits_start;
+            uint64_t             m_start;
+        public:
+            scoped_propagate(propagation_profile& p, unsigned v, unsigned num_watches, unsigned const& clause_visits):
+                m_profile(p), m_clause_visits(clause_visits), m_visits_start(clause_visits) {
+                p.on_propagate(v, num_watches);
+                m_start = cycle_counter();
+            }
+            ~scoped_propagate() {
+                m_profile.on_done(cycle_counter() - m_start, m_clause_visits - m_visits_start);
+            }
+        };
+
+        propagation_profile() { reset(); }
+
+        void reset();
+
+        void on_propagate(unsigned v, unsigned num_watches) {
+            ++m_propagations;
+            m_watches += num_watches;
+            if (num_watches > m_max_watches)
+                m_max_watches = num_watches;
+            ++m_watch_histogram[bucket(num_watches)];
+            if (m_propagations % HEAT_PERIOD != 0)
+                return;
+            if (v >= m_heat.size())
+                m_heat.resize(v + 1, 0);
+            ++m_heat[v];
+        }
+
+        void on_done(uint64_t cycles, unsigned clause_visits) {
+            m_cycles += cycles;
+            m_clause_visits += clause_visits;
+            if (clause_visits > m_max_clause_visits)
+                m_max_clause_visits = clause_visits;
+            ++m_visit_histogram[bucket(clause_visits)];
+        }
+
+        void inc_blocker_hit() { ++m_blocker_hits; }
+        void inc_blocker_miss() { ++m_blocker_misses; }
+
+        void collect_statistics(statistics& st) const;
+
+        /**
+           \brief display the counters, the histograms of watch list lengths and clause visits
+           per propagation, and the max_heat hottest variables as a JSON object.
+         */
+        std::ostream& display_json(std::ostream& out, unsigned max_heat = 32) const;
+    };
+};
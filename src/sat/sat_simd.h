@@ -0,0 +1,41 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_simd.h
+
+Abstract:
+
+    Selection of the AVX2 loops of the local search solvers.
+
+    The AVX2 loops are compiled for AVX2 also when the rest of z3 is not,
+    with SAT_AVX2_TARGET, and they are only used when has_avx2() holds.
+
+--*/
+#pragma once
+
+#if defined(__AVX2__)
+#define SAT_AVX2
+#define SAT_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SAT_AVX2
+#define SAT_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#ifdef SAT_AVX2
+#include <immintrin.h>
+#endif
+
+namespace sat {
+
+    inline bool has_avx2() {
+#if defined(__AVX2__)
+        return true;
+#elif defined(SAT_AVX2)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+}
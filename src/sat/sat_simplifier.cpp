@@ -25,6 +25,11 @@ Revision History:
 #include "sat/sat_integrity_checker.h"
 #include "util/stopwatch.h"
 #include "util/trace.h"
+#include "util/mutex.h"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <thread>
+#endif
 
 namespace sat {
 
@@ -272,6 +277,7 @@ namespace sat {
             for (; it2 != end2; ++it2) {
                 switch (it2->get_kind()) {
                 case watched::CLAUSE:
+                case watched::TERNARY:
                     // consume
                     break;
                 default:
@@ -683,17 +689,18 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_elim_todo(l.var());
+        unsigned old_sz = c.size();
         if (s.m_config.m_drat && c.contains(l)) {
-            unsigned sz = c.size();
             c.elim(l);
             s.m_drat.add(c, status::redundant());
-            c.restore(sz);
+            c.restore(old_sz);
             s.m_drat.del(c);
-            c.shrink(sz-1);
+            c.shrink(old_sz-1);
         }
         else {
             c.elim(l);
         }
+        s.clause_lits_removed(old_sz - c.size());
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
         m_sub_counter -= occurs.size()/2;
@@ -1810,9 +1817,19 @@ namespace sat {
        Return false if the result is a tautology
     */
     bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r) {
-        CTRACE("resolve_bug", !c1.contains(l) || !c2.contains(~l), tout << c1 << "\n" << c2 << "\nl: " << l << "\n";);
         if (m_visited.size() <= 2*s.num_vars())
             m_visited.resize(2*s.num_vars(), false);
+        return resolve(c1, c2, l, r, m_visited, m_elim_counter);
+    }
+
+    /**
+       \brief Resolve clauses c1 and c2 using the scratch marks visited and
+       subtract the number of visited literals from counter.
+       It does not modify the simplifier, so it can be used by the worker threads
+       of parallel variable elimination.
+    */
+    bool simplifier::resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited, int & counter) const {
+        CTRACE("resolve_bug", !c1.contains(l) || !c2.contains(~l), tout << c1 << "\n" << c2 << "\nl: " << l << "\n";);
         if (c1.was_removed() && !c1.contains(l))
             return false;
         if (c2.was_removed() && !c2.contains(~l))
@@ -1820,13 +1837,13 @@ namespace sat {
         SASSERT(c1.contains(l));
         SASSERT(c2.contains(~l));
         bool res = true;
-        m_elim_counter -= c1.size() + c2.size();
+        counter -= c1.size() + c2.size();
         unsigned sz1 = c1.size();
         for (unsigned i = 0; i < sz1; ++i) {
             literal l1 = c1[i];
             if (l == l1)
                 continue;
-            m_visited[l1.index()] = true;
+            visited[l1.index()] = true;
             r.push_back(l1);
         }
 
@@ -1836,21 +1853,20 @@ namespace sat {
             literal l2 = c2[i];
             if (not_l == l2)
                 continue;
-            if ((~l2).index() >= m_visited.size()) {
-                //s.display(std::cout << l2 << " " << s.num_vars() << " " << m_visited.size() << "\n");
+            if ((~l2).index() >= visited.size()) {
                 UNREACHABLE();
             }
-            if (m_visited[(~l2).index()]) {
+            if (visited[(~l2).index()]) {
                 res = false;
                 break;
             }
-            if (!m_visited[l2.index()])
+            if (!visited[l2.index()])
                 r.push_back(l2);
         }
 
         for (unsigned i = 0; i < sz1; ++i) {
             literal l1 = c1[i];
-            m_visited[l1.index()] = false;
+            visited[l1.index()] = false;
         }
         return res;
     }
@@ -1865,6 +1881,44 @@ namespace sat {
         s.mk_bin_clause(l1, l2, false);
     }
 
+    /**
+       \brief Add the resolvent r of an eliminated variable.
+    */
+    void simplifier::add_resolvent(literal_vector & r) {
+        if (cleanup_clause(r)) 
+            return; // clause is already satisfied.
+        switch (r.size()) {
+        case 0:
+            s.set_conflict();
+            break;
+        case 1:
+            propagate_unit(r[0]);
+            break;
+        case 2:
+            s.m_stats.m_mk_bin_clause++;
+            add_non_learned_binary_clause(r[0], r[1]);
+            back_subsumption1(r[0], r[1], false);
+            break;
+        default: {
+            if (r.size() == 3)
+                s.m_stats.m_mk_ter_clause++;
+            else
+                s.m_stats.m_mk_clause++;
+            clause * new_c = s.alloc_clause(r.size(), r.data(), false);
+
+            if (s.m_config.m_drat) s.m_drat.add(*new_c, status::redundant());
+            s.m_clauses.push_back(new_c);
+
+            m_use_list.insert(*new_c);
+            if (m_sub_counter > 0)
+                back_subsumption1(*new_c);
+            else
+                back_subsumption0(*new_c);
+            break;
+        }
+        }
+    }
+
     /**
        \brief Eliminate the binary clauses watched by l, when l.var() is being eliminated
     */
@@ -1916,6 +1970,43 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Remove the clauses containing the eliminated variable v.
+    */
+    void simplifier::remove_occurrences(bool_var v) {
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        remove_bin_clauses(pos_l);
+        remove_bin_clauses(neg_l);
+        clause_use_list& pos_occs = m_use_list.get(pos_l);
+        clause_use_list& neg_occs = m_use_list.get(neg_l);
+        remove_clauses(pos_occs, pos_l);
+        remove_clauses(neg_occs, neg_l);
+        pos_occs.reset();
+        neg_occs.reset();
+    }
+
+    unsigned simplifier::count_lits(clause_use_list const & cs) const {
+        unsigned n = 0;
+        for (auto it = cs.mk_iterator(); !it.at_end(); it.next()) {
+            if (!it.curr().is_learned())
+                n += it.curr().size();
+        }
+        return n;
+    }
+
+    bool simplifier::exceeds_res_cutoff(unsigned num_pos, unsigned num_neg, unsigned before_lits) const {
+        if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
+            return true;
+        if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
+            s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
+            return true;
+        if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
+            s.m_clauses.size() <= m_res_cls_cutoff1)
+            return true;
+        return false;
+    }
+
     bool simplifier::try_eliminate(bool_var v) {
         if (value(v) != l_undef)
             return false;
@@ -1934,27 +2025,11 @@ namespace sat {
         if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
             return false;
 
-        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2;
-
-        for (auto it = pos_occs.mk_iterator(); !it.at_end(); it.next()) {
-            if (!it.curr().is_learned())
-                before_lits += it.curr().size();
-        }
-
-        for (auto it = neg_occs.mk_iterator(); !it.at_end(); it.next()) {
-            if (!it.curr().is_learned())
-                before_lits += it.curr().size();
-        }
+        unsigned before_lits = num_bin_pos*2 + num_bin_neg*2 + count_lits(pos_occs) + count_lits(neg_occs);
 
         TRACE("sat_simplifier", tout << v << " num_pos: " << num_pos << " neg_pos: " << num_neg << " before_lits: " << before_lits << "\n";);
 
-        if (num_pos >= m_res_occ_cutoff3 && num_neg >= m_res_occ_cutoff3 && before_lits > m_res_lit_cutoff3 && s.m_clauses.size() > m_res_cls_cutoff2)
-            return false;
-        if (num_pos >= m_res_occ_cutoff2 && num_neg >= m_res_occ_cutoff2 && before_lits > m_res_lit_cutoff2 &&
-            s.m_clauses.size() > m_res_cls_cutoff1 && s.m_clauses.size() <= m_res_cls_cutoff2)
-            return false;
-        if (num_pos >= m_res_occ_cutoff1 && num_neg >= m_res_occ_cutoff1 && before_lits > m_res_lit_cutoff1 &&
-            s.m_clauses.size() <= m_res_cls_cutoff1)
+        if (exceeds_res_cutoff(num_pos, num_neg, before_lits))
             return false;
 
         m_pos_cls.reset();
@@ -2008,55 +2083,253 @@ namespace sat {
                 if (!resolve(c1, c2, pos_l, m_new_cls))
                     continue;                
                 TRACE("sat_simplifier", tout << c1 << "\n" << c2 << "\n-->\n" << m_new_cls << "\n";);
-                if (cleanup_clause(m_new_cls)) {
-                    continue; // clause is already satisfied.
-                }
-                switch (m_new_cls.size()) {
-                case 0:
-                    s.set_conflict();
-                    break;
-                case 1:
-                    propagate_unit(m_new_cls[0]);
-                    break;
-                case 2:
-                    s.m_stats.m_mk_bin_clause++;
-                    add_non_learned_binary_clause(m_new_cls[0], m_new_cls[1]);
-                    back_subsumption1(m_new_cls[0], m_new_cls[1], false);
-                    break;
-                default:
-                    if (m_new_cls.size() == 3)
-                        s.m_stats.m_mk_ter_clause++;
-                    else
-                        s.m_stats.m_mk_clause++;
-                    clause * new_c = s.alloc_clause(m_new_cls.size(), m_new_cls.data(), false);
-
-                    if (s.m_config.m_drat) s.m_drat.add(*new_c, status::redundant());
-                    s.m_clauses.push_back(new_c);
-
-                    m_use_list.insert(*new_c);
-                    if (m_sub_counter > 0)
-                        back_subsumption1(*new_c);
-                    else
-                        back_subsumption0(*new_c);
-                    break;
-                }
+                add_resolvent(m_new_cls);
                 if (s.inconsistent())
                     return true;
             }
         }
-        remove_bin_clauses(pos_l);
-        remove_bin_clauses(neg_l);
-        {
-            clause_use_list& pos_occs = m_use_list.get(pos_l);
-            clause_use_list& neg_occs = m_use_list.get(neg_l);
-            remove_clauses(pos_occs, pos_l);
-            remove_clauses(neg_occs, neg_l);
-            pos_occs.reset();
-            neg_occs.reset();
+        remove_occurrences(v);
+        return true;
+    }
+
+    /**
+       \brief Result of trying to eliminate a variable on a worker thread.
+       The resolvents are stored consecutively, each one terminated by null_literal.
+    */
+    struct simplifier::elim_candidate {
+        bool_var              m_var { null_bool_var };
+        bool                  m_eliminate { false };
+        int                   m_counter { 0 };     // decrement of m_elim_counter
+        unsigned              m_num_bin_pos { 0 };
+        unsigned              m_num_bin_neg { 0 };
+        unsigned              m_num_pos { 0 };
+        unsigned              m_num_neg { 0 };
+        clause_wrapper_vector m_pos;
+        clause_wrapper_vector m_neg;
+        literal_vector        m_resolvents;
+
+        void reset(bool_var v) {
+            m_var = v;
+            m_eliminate = false;
+            m_counter = 0;
+            m_num_bin_pos = m_num_bin_neg = m_num_pos = m_num_neg = 0;
+            m_pos.reset();
+            m_neg.reset();
+            m_resolvents.reset();
+        }
+    };
+
+    /**
+       \brief Partition vars into batches such that the neighbourhoods of the 
+       variables in a batch, the variables that occur in clauses with them, are disjoint.
+       Eliminating a variable of a batch then does not touch clauses containing
+       another variable of the batch. The neighbourhood of each variable is computed 
+       once: level[w] is the last batch with a variable whose neighbourhood contains w,
+       and a variable goes to the batch after the last one it overlaps with. 
+       Overlapping variables are therefore committed in the order of vars.
+    */
+    void simplifier::select_elim_batches(bool_var_vector const & vars, vector<bool_var_vector> & batches) {
+        bool_var_vector nbs;
+        unsigned_vector level(s.num_vars(), 0u);
+        for (bool_var v : vars) {
+            nbs.reset();
+            nbs.push_back(v);
+            for (literal l : { literal(v, false), literal(v, true) }) {
+                clause_use_list const & cs = m_use_list.get(l);
+                for (auto it = cs.mk_iterator(); !it.at_end(); it.next()) 
+                    for (literal l2 : it.curr())
+                        nbs.push_back(l2.var());
+                for (watched const & w : get_wlist(~l))
+                    if (w.is_binary_clause())
+                        nbs.push_back(w.get_literal().var());
+            }
+            unsigned lvl = 0;
+            for (bool_var w : nbs) 
+                lvl = std::max(lvl, level[w]);
+            for (bool_var w : nbs) 
+                level[w] = lvl + 1;
+            if (lvl == batches.size())
+                batches.push_back(bool_var_vector());
+            batches[lvl].push_back(v);
+        }
+    }
+
+    /**
+       \brief Determine whether resolution eliminates e.m_var and compute the resolvents.
+       Only the clauses of e.m_var are read, so trials for variables with disjoint
+       neighbourhoods can run concurrently.
+    */
+    void simplifier::trial_eliminate(elim_candidate & e, svector<char> & visited) {
+        bool_var v = e.m_var;
+        if (value(v) != l_undef)
+            return;
+        literal pos_l(v, false);
+        literal neg_l(v, true);
+        e.m_num_bin_pos = num_nonlearned_bin(pos_l);
+        e.m_num_bin_neg = num_nonlearned_bin(neg_l);
+        clause_use_list const & pos_occs = m_use_list.get(pos_l);
+        clause_use_list const & neg_occs = m_use_list.get(neg_l);
+        e.m_num_pos = pos_occs.num_irredundant();
+        e.m_num_neg = neg_occs.num_irredundant();
+        unsigned num_pos = e.m_num_pos + e.m_num_bin_pos;
+        unsigned num_neg = e.m_num_neg + e.m_num_bin_neg;
+        if (num_pos >= m_res_occ_cutoff && num_neg >= m_res_occ_cutoff)
+            return;
+        unsigned before_lits = e.m_num_bin_pos*2 + e.m_num_bin_neg*2 + count_lits(pos_occs) + count_lits(neg_occs);
+        if (exceeds_res_cutoff(num_pos, num_neg, before_lits))
+            return;
+        collect_clauses(pos_l, e.m_pos);
+        collect_clauses(neg_l, e.m_neg);
+        unsigned before_clauses = num_pos + num_neg;
+        unsigned after_clauses = 0;
+        literal_vector r;
+        for (clause_wrapper const & c1 : e.m_pos) {
+            for (clause_wrapper const & c2 : e.m_neg) {
+                r.reset();
+                if (!resolve(c1, c2, pos_l, r, visited, e.m_counter))
+                    continue;
+                if (++after_clauses > before_clauses) 
+                    return;
+                e.m_resolvents.append(r);
+                e.m_resolvents.push_back(null_literal);
+            }
+        }
+        // charge the same costs as try_eliminate, which resolves the clauses twice.
+        int resolve_cost = e.m_counter;
+        e.m_counter += resolve_cost - 3 * static_cast<int>(num_pos * num_neg + before_lits);
+        e.m_eliminate = true;
+    }
+
+    void simplifier::trial_eliminate(vector<elim_candidate> & es, vector<svector<char>> & visited) {
+#ifndef SINGLE_THREAD
+        // small batches are not worth starting threads for.
+        unsigned num_threads = std::min(visited.size(), es.size() / 32);
+        if (num_threads > 1) {
+            std::atomic<unsigned> next(0);
+            std::string ex_msg;
+            mutex mux;
+            auto run = [&](unsigned id) {
+                try {
+                    for (unsigned i = next++; i < es.size(); i = next++) 
+                        trial_eliminate(es[i], visited[id]);
+                }
+                catch (z3_exception & ex) {
+                    lock_guard lock(mux);
+                    ex_msg = ex.msg();
+                    next = es.size();
+                }
+            };
+            vector<std::thread> threads;
+            for (unsigned id = 1; id < num_threads; ++id)
+                threads.push_back(std::thread([&, id]() { run(id); }));
+            run(0);
+            for (auto & th : threads)
+                th.join();
+            if (!ex_msg.empty())
+                throw default_exception(std::move(ex_msg));
+            return;
+        }
+#endif
+        for (elim_candidate & e : es)
+            trial_eliminate(e, visited[0]);
+    }
+
+    /**
+       \brief The clauses of e.m_var changed since the trial.
+    */
+    bool simplifier::is_stale(elim_candidate const & e) const {
+        literal pos_l(e.m_var, false);
+        literal neg_l(e.m_var, true);
+        if (value(e.m_var) != l_undef)
+            return true;
+        if (e.m_num_pos != m_use_list.get(pos_l).num_irredundant() || 
+            e.m_num_neg != m_use_list.get(neg_l).num_irredundant() ||
+            e.m_num_bin_pos != num_nonlearned_bin(pos_l) || 
+            e.m_num_bin_neg != num_nonlearned_bin(neg_l))
+            return true;
+        for (clause_wrapper const & c : e.m_pos)
+            if (c.was_removed())
+                return true;
+        for (clause_wrapper const & c : e.m_neg)
+            if (c.was_removed())
+                return true;
+        return false;
+    }
+
+    bool simplifier::commit_eliminate(elim_candidate & e) {
+        m_elim_counter += e.m_counter;
+        if (!e.m_eliminate)
+            return false;
+        bool_var v = e.m_var;
+        ++s.m_stats.m_elim_var_res;
+        VERIFY(!is_external(v));
+        model_converter::entry & mc_entry = s.m_mc.mk(model_converter::ELIM_VAR, v);
+        save_clauses(mc_entry, e.m_pos);
+        save_clauses(mc_entry, e.m_neg);
+        s.set_eliminated(v, true);
+        literal const* it = e.m_resolvents.begin(), *end = e.m_resolvents.end();
+        while (it != end) {
+            m_new_cls.reset();
+            for (; *it != null_literal; ++it)
+                m_new_cls.push_back(*it);
+            ++it;
+            add_resolvent(m_new_cls);
+            if (s.inconsistent())
+                return true;
         }
+        remove_occurrences(v);
         return true;
     }
 
+    /**
+       \brief Eliminate variables in batches with disjoint neighbourhoods.
+       The batches are selected once from the clauses before elimination. 
+       The trials of a batch run concurrently on m_res_threads threads, then the
+       eliminations are committed in the order of the batch. The batches only depend
+       on the clauses, so the model converter entries are the same for every
+       number of threads above one. Variables whose clauses changed after the trial, 
+       for example by resolvents or units of an earlier batch, are eliminated 
+       sequentially.
+    */
+    void simplifier::elim_vars_parallel(bool_var_vector const & vars, sat::elim_vars & elim_bdd) {
+        vector<bool_var_vector> batches;
+        select_elim_batches(vars, batches);
+        vector<svector<char>> visited(m_res_threads, svector<char>(2*s.num_vars(), false));
+        vector<elim_candidate> es;
+        for (bool_var_vector const & batch : batches) {
+            checkpoint();
+            es.resize(batch.size());
+            for (unsigned i = 0; i < batch.size(); ++i)
+                es[i].reset(batch[i]);
+            trial_eliminate(es, visited);
+            unsigned trail_sz = s.m_trail.size();
+            for (elim_candidate & e : es) {
+                checkpoint();
+                if (m_elim_counter < 0) 
+                    return;
+                bool_var v = e.m_var;
+                if (is_external(v) || was_eliminated(v)) {
+                    // skip
+                }
+                else if (trail_sz != s.m_trail.size() || is_stale(e)) {
+                    if (try_eliminate(v)) 
+                        m_num_elim_vars++;
+                    else if (elim_vars_bdd_enabled() && elim_bdd(v)) 
+                        m_num_elim_vars++;
+                }
+                else if (commit_eliminate(e)) {
+                    m_num_elim_vars++;
+                }
+                else if (elim_vars_bdd_enabled() && elim_bdd(v)) { 
+                    m_num_elim_vars++;
+                }
+                if (s.inconsistent())
+                    return;
+            }
+        }
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << " (sat-resolution :batches " << batches.size() << " :threads " << m_res_threads << ")\n";);
+    }
+
     struct simplifier::elim_var_report {
         simplifier & m_simplifier;
         stopwatch    m_watch;
@@ -2084,6 +2357,10 @@ namespace sat {
         bool_var_vector vars;
         order_vars_for_elim(vars);
         sat::elim_vars elim_bdd(*this);
+        if (m_res_threads > 1) {
+            elim_vars_parallel(vars, elim_bdd);
+            vars.reset();
+        }
         for (bool_var v : vars) {
             checkpoint();
             if (m_elim_counter < 0) 
@@ -2126,6 +2403,7 @@ namespace sat {
         m_res_lit_cutoff3         = p.resolution_lit_cutoff_range3();
         m_res_cls_cutoff1         = p.resolution_cls_cutoff1();
         m_res_cls_cutoff2         = p.resolution_cls_cutoff2();
+        m_res_threads             = std::max(1u, p.resolution_threads());
         m_subsumption             = p.subsumption();
         m_subsumption_limit       = p.subsumption_limit();
         m_elim_vars               = p.elim_vars();
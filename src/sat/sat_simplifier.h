@@ -37,6 +37,7 @@ namespace pb {
 
 namespace sat {
     class solver;
+    class elim_vars;
 
     class use_list {
         vector<clause_use_list> m_use_list;
@@ -99,6 +100,7 @@ namespace sat {
         unsigned               m_res_lit_cutoff3;
         unsigned               m_res_cls_cutoff1;
         unsigned               m_res_cls_cutoff2;
+        unsigned               m_res_threads;
 
         bool                   m_subsumption;
         unsigned               m_subsumption_limit;
@@ -199,13 +201,27 @@ namespace sat {
         clause_wrapper_vector m_neg_cls;
         literal_vector m_new_cls;
         bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r);
+        bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r, svector<char> & visited, int & counter) const;
         void save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs);
         void add_non_learned_binary_clause(literal l1, literal l2);
+        void add_resolvent(literal_vector & r);
         void remove_bin_clauses(literal l);
         void remove_clauses(clause_use_list const & cs, literal l);
+        void remove_occurrences(bool_var v);
+        unsigned count_lits(clause_use_list const & cs) const;
+        bool exceeds_res_cutoff(unsigned num_pos, unsigned num_neg, unsigned before_lits) const;
         bool try_eliminate(bool_var v);
         void elim_vars();
 
+        // parallel variable elimination
+        struct elim_candidate;
+        void select_elim_batches(bool_var_vector const & vars, vector<bool_var_vector> & batches);
+        void trial_eliminate(elim_candidate & e, svector<char> & visited);
+        void trial_eliminate(vector<elim_candidate> & es, vector<svector<char>> & visited);
+        bool is_stale(elim_candidate const & e) const;
+        bool commit_eliminate(elim_candidate & e);
+        void elim_vars_parallel(bool_var_vector const & vars, sat::elim_vars & elim_bdd);
+
         struct blocked_cls_report;
         struct subsumption_report;
         struct elim_var_report;
@@ -29,6 +29,7 @@ Revision History:
 #include "sat/sat_solver.h"
 #include "sat/sat_integrity_checker.h"
 #include "sat/sat_lookahead.h"
+#include "sat/sat_cube_and_conquer.h"
 #include "sat/sat_ddfw.h"
 #include "sat/sat_prob.h"
 #include "sat/sat_anf_simplifier.h"
@@ -126,6 +127,7 @@ namespace sat {
         m_justification.reset();
         m_decision.reset();
         m_eliminated.reset();
+        m_num_eliminated = 0;
         m_external.reset();
         m_var_scope.reset();
         m_activity.reset();
@@ -257,6 +259,8 @@ namespace sat {
         m_assignment[2*v+1] = l_undef;
         m_justification[v] = justification(UINT_MAX);
         m_decision[v] = dvar;
+        if (m_eliminated[v])
+            --m_num_eliminated;
         m_eliminated[v] = false;
         m_external[v] = ext;
         m_var_scope[v] = scope_lvl();
@@ -334,8 +338,11 @@ namespace sat {
             return;
         if (!f) 
             reset_var(v, m_external[v], m_decision[v]);
-        else if (f && m_ext)
-            m_ext->set_eliminated(v);
+        else {
+            if (m_ext)
+                m_ext->set_eliminated(v);
+            ++m_num_eliminated;
+        }
         m_eliminated[v] = f; 
     }
 
@@ -351,6 +358,9 @@ namespace sat {
                 }
         });
 
+        if (m_config.m_drat && !st.is_redundant() && st.is_sat())
+            m_drat.add_input(num_lits, lits);
+
         if (m_user_scope_literals.empty()) {
             return mk_clause_core(num_lits, lits, st);
         }
@@ -462,11 +472,17 @@ namespace sat {
         if (m_config.m_drat)
             m_drat.add(l1, l2, st);
         
+        // the unit is the resolvent with an existing binary clause, 
+        // a proof checker does not find it by unit propagation
         if (redundant && !m_trim && find_binary_watch(get_wlist(~l1), ~l2) && value(l1) == l_undef) {
+            if (m_config.m_drat)
+                m_drat.add(l1, true);
             assign_unit(l1);
             return;
         }
         if (redundant && !m_trim && find_binary_watch(get_wlist(~l2), ~l1) && value(l2) == l_undef) {
+            if (m_config.m_drat)
+                m_drat.add(l2, true);
             assign_unit(l2);
             return;
         }
@@ -595,12 +611,18 @@ namespace sat {
                 reinit |= !c.is_learned();
             }
         }
-        unsigned some_idx = c.size() >> 1;
-        literal block_lit = c[some_idx];
         VERIFY(!c.frozen());
         DEBUG_CODE(for (auto const& w : m_watches[(~c[0]).index()]) SASSERT(!w.is_clause() || w.get_clause_offset() != cls_off););
         DEBUG_CODE(for (auto const& w : m_watches[(~c[1]).index()]) SASSERT(!w.is_clause() || w.get_clause_offset() != cls_off););
         SASSERT(c[0] != c[1]);
+        if (c.size() == 3) {
+            m_watches[(~c[0]).index()].push_back(watched(c[1], c[2], cls_off));
+            m_watches[(~c[1]).index()].push_back(watched(c[0], c[2], cls_off));
+            m_watches[(~c[2]).index()].push_back(watched(c[0], c[1], cls_off));
+            return reinit;
+        }
+        unsigned some_idx = c.size() >> 1;
+        literal block_lit = c[some_idx];
         m_watches[(~c[0]).index()].push_back(watched(block_lit, cls_off));
         m_watches[(~c[1]).index()].push_back(watched(block_lit, cls_off));
         return reinit;
@@ -630,6 +652,7 @@ namespace sat {
         SASSERT(old_sz >= new_sz);
         if (old_sz != new_sz) {
             c.shrink(new_sz);
+            clause_lits_removed(old_sz - new_sz);
             for (literal l : c) {
                 m_touched[l.var()] = m_touch_index;
             }
@@ -663,7 +686,6 @@ namespace sat {
         m_defrag_threshold = 2;
         if (memory_pressure()) return;
         pop(scope_lvl());
-        IF_VERBOSE(2, verbose_stream() << "(sat-defrag)\n");
         clause_allocator& alloc = m_cls_allocator[!m_cls_allocator_idx];
         ptr_vector<clause> new_clauses, new_learned;
         for (clause* c : m_clauses) c->unmark_used();
@@ -678,7 +700,7 @@ namespace sat {
         for (literal lit : lits) {
             watch_list& wlist = m_watches[lit.index()];
             for (watched& w : wlist) {
-                if (w.is_clause()) {
+                if (w.is_clause() || w.is_ternary_clause()) {
                     clause& c1 = get_clause(w);
                     clause_offset offset;
                     if (c1.was_used()) {
@@ -686,6 +708,7 @@ namespace sat {
                     }
                     else {
                         clause* c2 = alloc.copy_clause(c1); 
+                        m_num_clause_lits += c2->size();
                         c1.mark_used();
                         if (c1.is_learned()) {
                             new_learned.push_back(c2);
@@ -693,33 +716,34 @@ namespace sat {
                         else {
                             new_clauses.push_back(c2);
                         }
-                        offset = get_offset(*c2);
+                        offset = alloc.get_offset(c2);
                         c1.set_new_offset(offset);
                     }
-                    w = watched(w.get_blocked_literal(), offset);
+                    w.set_clause_offset(offset);
                 }
             }
         }
 
-        // reallocate ternary clauses.
+        // reallocate clauses that are not watched (frozen clauses).
         for (clause* c : m_clauses) {
             if (!c->was_used()) {
-                SASSERT(c->size() == 3);
                 new_clauses.push_back(alloc.copy_clause(*c));
+                m_num_clause_lits += c->size();
             }
             dealloc_clause(c);
         }
 
         for (clause* c : m_learned) {
             if (!c->was_used()) {
-                SASSERT(c->size() == 3);
                 new_learned.push_back(alloc.copy_clause(*c));
+                m_num_clause_lits += c->size();
             }
             dealloc_clause(c);
         }
         m_clauses.swap(new_clauses);
         m_learned.swap(new_learned);
 
+        IF_VERBOSE(2, verbose_stream() << "(sat-defrag :bytes " << cls_allocator().get_reserved_size() << " -> " << alloc.get_reserved_size() << ")\n");
         cls_allocator().finalize();
         m_cls_allocator_idx = !m_cls_allocator_idx;
 
@@ -863,6 +887,8 @@ namespace sat {
         clause_offset cls_off = get_offset(c);
         erase_clause_watch(get_wlist(~c[0]), cls_off);
         erase_clause_watch(get_wlist(~c[1]), cls_off);
+        if (c.size() == 3)
+            erase_clause_watch(get_wlist(~c[2]), cls_off);
     }
 
     // -----------------------
@@ -1019,6 +1045,9 @@ namespace sat {
         SASSERT(value(l) == l_true);
         SASSERT(value(not_l) == l_false);
         watch_list& wlist = m_watches[l.index()];
+#ifdef Z3_SAT_PROFILE
+        propagation_profile::scoped_propagate _profile(m_profile, l.var(), wlist.size(), m_stats.m_clause_visits);
+#endif
         m_asymm_branch.dec(wlist.size());
         m_probing.dec(wlist.size());
         watch_list::iterator it = wlist.begin();
@@ -1052,10 +1081,13 @@ namespace sat {
                 if (value(it->get_blocked_literal()) == l_true) {
                     TRACE("propagate_clause_bug", tout << "blocked literal " << it->get_blocked_literal() << "\n";
                     tout << get_clause(it) << "\n";);
+                    SAT_PROFILE_CODE(m_profile.inc_blocker_hit(););
                     *it2 = *it;
                     it2++;
                     break;
                 }
+                SAT_PROFILE_CODE(m_profile.inc_blocker_miss(););
+                m_stats.m_clause_visits++;
                 clause_offset cls_off = it->get_clause_offset();
                 clause& c = get_clause(cls_off);
                 TRACE("propagate_clause_bug", tout << "processing... " << c << "\nwas_removed: " << c.was_removed() << "\n";);
@@ -1142,6 +1174,46 @@ namespace sat {
             end_clause_case:
                 break;
             }
+            case watched::TERNARY: {
+                l1 = it->literal1();
+                l2 = it->literal2();
+                lbool val1 = value(l1);
+                lbool val2 = value(l2);
+                if (val1 == l_true || val2 == l_true || (val1 == l_undef && val2 == l_undef)) {
+                    *it2 = *it;
+                    it2++;
+                    break;
+                }
+                m_stats.m_clause_visits++;
+                clause_offset cls_off = it->get_clause_offset();
+                clause& c = get_clause(cls_off);
+                if (c.was_removed() || c.size() != 3 || !c.contains(not_l) || !c.contains(l1) || !c.contains(l2)) {
+                    // the watch lists may be inconsistent, see the remark in the CLAUSE case.
+                    *it2 = *it;
+                    it2++;
+                    break;
+                }
+                if (val1 == l_false && val2 == l_false) {
+                    c.mark_used();
+                    CONFLICT_CLEANUP();
+                    set_conflict(justification(std::max(curr_level, std::max(lvl(l1), lvl(l2))), cls_off));
+                    return false;
+                }
+                *it2 = *it;
+                it2++;
+                if (val1 == l_false)
+                    std::swap(l1, l2);
+                // l1 is unassigned and l2 is false.
+                // The consequent is moved to the first position as for other clauses.
+                if (c[1] == l1)
+                    std::swap(c[0], c[1]);
+                else if (c[2] == l1)
+                    std::swap(c[0], c[2]);
+                m_stats.m_ter_propagate++;
+                c.mark_used();
+                assign_core(l1, justification(std::max(curr_level, lvl(l2)), cls_off));
+                break;
+            }
             case watched::EXT_CONSTRAINT:
                 SASSERT(m_ext);
                 keep = m_ext->propagated(l, it->get_ext_constraint_idx());
@@ -1243,9 +1315,18 @@ namespace sat {
         if ((m_config.m_num_threads > 1 || m_config.m_local_search_threads > 0 || 
              m_config.m_ddfw_threads > 0) && !m_par && !m_ext) {
             SASSERT(scope_lvl() == 0);
+            if (m_config.m_cube_and_conquer && m_config.m_num_threads > 1)
+                return check_cube_and_conquer(num_lits, lits);
             return check_par(num_lits, lits);
         }
         flet<bool> _searching(m_searching, true);
+        // the profile is also written when search is canceled or runs out of resources.
+        struct scoped_dump_profile {
+            solver& s;
+            scoped_dump_profile(solver& s): s(s) {}
+            ~scoped_dump_profile() { s.dump_profile(); }
+        };
+        scoped_dump_profile _dump_profile(*this);
         m_clone = nullptr;
         if (m_mc.empty() && gparams::get_ref().get_bool("model_validate", false)) {
             
@@ -1421,7 +1502,7 @@ namespace sat {
 #define IS_MAIN_SOLVER(i)  (i == main_solver_offset)
 
         sat::parallel par(*this);
-        par.reserve(num_threads, 1 << 12);
+        par.reserve(num_threads, m_config.m_par_buffer_size);
         par.init_solvers(*this, num_extra_solvers);
         for (unsigned i = 0; i < ls.size(); ++i) {
             par.push_child(ls[i]->rlimit());
@@ -1503,6 +1584,22 @@ namespace sat {
         for (auto & th : threads) {
             th.join();
         }
+
+        unsigned par_imported = 0, par_dropped = 0, par_lapped = 0;
+        for (int i = 0; i <= num_extra_solvers; ++i) {
+            stats const& st = IS_AUX_SOLVER(i) ? par.get_solver(i).m_stats : m_stats;
+            IF_VERBOSE(1, verbose_stream() << "(sat-parallel :thread " << i 
+                       << " :shared " << st.m_par_shared 
+                       << " :imported " << st.m_par_imported 
+                       << " :dropped " << st.m_par_dropped 
+                       << " :lapped " << st.m_par_lapped << ")\n";);
+            par_imported += st.m_par_imported;
+            par_dropped += st.m_par_dropped;
+            par_lapped += st.m_par_lapped;
+        }
+        m_aux_stats.update("sat par imported all threads", par_imported);
+        m_aux_stats.update("sat par dropped all threads", par_dropped);
+        m_aux_stats.update("sat par lapped all threads", par_lapped);
         
         if (IS_AUX_SOLVER(finished_id)) {
             m_stats = par.get_solver(finished_id).m_stats;
@@ -1534,17 +1631,23 @@ namespace sat {
     }
 #endif
 
+    lbool solver::check_cube_and_conquer(unsigned num_lits, literal const* lits) {
+        if (!rlimit().inc()) 
+            return l_undef;
+        cube_and_conquer cc(*this);
+        return cc(num_lits, lits);
+    }
+
     /*
       \brief import lemmas/units from parallel sat solvers.
      */
     void solver::exchange_par() {
-        if (m_par && at_base_lvl() && m_config.m_num_threads > 1) m_par->get_clauses(*this);
         if (m_par && at_base_lvl() && m_config.m_num_threads > 1) {
             // SASSERT(scope_lvl() == search_lvl());
             // TBD: import also dependencies of assumptions.
             unsigned sz = init_trail_size();
-            unsigned num_in = 0, num_out = 0;
-            literal_vector in, out;
+            unsigned num_out = 0, num_in = m_stats.m_par_imported;
+            literal_vector out;
             for (unsigned i = m_par_limit_out; i < sz; ++i) {
                 literal lit = m_trail[i];
                 if (lit.var() < m_par_num_vars) {
@@ -1553,15 +1656,9 @@ namespace sat {
                 }
             }
             m_par_limit_out = sz;
-            m_par->exchange(*this, out, m_par_limit_in, in);
-            for (unsigned i = 0; !inconsistent() && i < in.size(); ++i) {
-                literal lit = in[i];
-                SASSERT(lit.var() < m_par_num_vars);
-                if (lvl(lit.var()) != 0 || value(lit) != l_true) {
-                    ++num_in;
-                    assign_unit(lit);
-                }
-            }
+            m_par->share_units(*this, out);
+            m_par->get_clauses(*this);
+            num_in = m_stats.m_par_imported - num_in;
             if (num_in > 0 || num_out > 0) {
                 IF_VERBOSE(2, verbose_stream() << "(sat-sync out: " << num_out << " in: " << num_in << ")\n";);
             }
@@ -1571,7 +1668,6 @@ namespace sat {
     void solver::set_par(parallel* p, unsigned id) {
         m_par = p;
         m_par_num_vars = num_vars();
-        m_par_limit_in = 0;
         m_par_limit_out = 0;
         m_par_id = id; 
         m_par_syncing_clauses = false;
@@ -1920,6 +2016,48 @@ namespace sat {
     bool solver::should_simplify() const {
         return m_conflicts_since_init >= m_next_simplify && m_simplify_enabled;
     }
+    /**
+       \brief size of the clause database used to measure the effect of inprocessing:
+       the number of literals in the allocated clauses and the number of variables
+       that are neither assigned nor eliminated. Both are counts kept up to date as
+       clauses are allocated, shrunk and deleted and as variables are eliminated.
+       Binary clauses live in the watch lists only and are not counted, their removal
+       shows up in the variables that scc and elimination remove.
+       It is called at the base level, where the trail holds the assigned variables.
+    */
+    uint64_t solver::inprocess_size() const {
+        CASSERT("sat_inprocess_size", check_inprocess_size());
+        int64_t vars = static_cast<int64_t>(num_vars()) - m_num_eliminated - m_trail.size();
+        return static_cast<uint64_t>(std::max<int64_t>(0, m_num_clause_lits) + std::max<int64_t>(0, vars));
+    }
+
+    bool solver::check_inprocess_size() const {
+        int64_t lits = 0;
+        for (clause* c : m_clauses)
+            lits += c->size();
+        for (clause* c : m_learned)
+            lits += c->size();
+        unsigned num_elim = 0;
+        for (bool_var v = 0; v < num_vars(); ++v)
+            if (was_eliminated(v))
+                ++num_elim;
+        VERIFY(lits == m_num_clause_lits);
+        VERIFY(num_elim == m_num_eliminated);
+        return true;
+    }
+
+    /**
+       \brief run the inprocessing technique t if the scheduler selects it for this round.
+    */
+    template<typename F>
+    void solver::inprocess_step(inprocess::technique t, F const& f) {
+        if (!m_inprocess.should_run(t))
+            return;
+        m_inprocess.start(t, inprocess_size());
+        f();
+        m_inprocess.stop(inprocess_size());
+    }
+
     /**
        \brief Apply all simplifications.
     */
@@ -1949,22 +2087,22 @@ namespace sat {
         report _rprt(*this);
         SASSERT(at_base_lvl());
 
-        m_cleaner(m_config.m_force_cleanup);
+        inprocess_step(inprocess::cleaner_t, [&]() { m_cleaner(m_config.m_force_cleanup); });
         CASSERT("sat_simplify_bug", check_invariant());
 
-        m_scc();
+        inprocess_step(inprocess::scc_t, [&]() { m_scc(); });
         CASSERT("sat_simplify_bug", check_invariant());
 
         if (m_ext) {
             m_ext->pre_simplify();
         }
       
-        m_simplifier(false);
+        inprocess_step(inprocess::simplifier_t, [&]() { m_simplifier(false); });
 
         CASSERT("sat_simplify_bug", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
         if (!m_learned.empty()) {
-            m_simplifier(true);
+            inprocess_step(inprocess::simplifier_learned_t, [&]() { m_simplifier(true); });
             CASSERT("sat_missed_prop", check_missed_propagation());
             CASSERT("sat_simplify_bug", check_invariant());
         }
@@ -1978,15 +2116,17 @@ namespace sat {
             m_ext->simplify();
         }
 
-        m_probing();
+        inprocess_step(inprocess::probing_t, [&]() { m_probing(); });
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
-        m_asymm_branch(false);
+        inprocess_step(inprocess::asymm_branch_t, [&]() { m_asymm_branch(false); });
 
         if (m_config.m_lookahead_simplify && !m_ext) {
-            lookahead lh(*this);
-            lh.simplify(true);
-            lh.collect_statistics(m_aux_stats);
+            inprocess_step(inprocess::lookahead_t, [&]() {
+                lookahead lh(*this);
+                lh.simplify(true);
+                lh.collect_statistics(m_aux_stats);
+            });
         }
 
         reinit_assumptions();
@@ -2009,20 +2149,21 @@ namespace sat {
         }
 
         if (m_config.m_binspr && !inconsistent()) {
-            m_binspr();
+            inprocess_step(inprocess::binspr_t, [&]() { m_binspr(); });
         }
 
         if (m_config.m_anf_simplify && m_simplifications > m_config.m_anf_delay && !inconsistent()) {
-            anf_simplifier anf(*this);
-            anf_simplifier::config cfg;
-            cfg.m_enable_exlin = m_config.m_anf_exlin;
-            anf();
-            anf.collect_statistics(m_aux_stats);
-            // TBD: throttle anf_delay based on yield
+            inprocess_step(inprocess::anf_t, [&]() {
+                anf_simplifier anf(*this);
+                anf_simplifier::config cfg;
+                cfg.m_enable_exlin = m_config.m_anf_exlin;
+                anf();
+                anf.collect_statistics(m_aux_stats);
+            });
         }
         
         if (m_cut_simplifier && m_simplifications > m_config.m_cut_delay && !inconsistent()) {
-            (*m_cut_simplifier)();
+            inprocess_step(inprocess::cut_t, [&]() { (*m_cut_simplifier)(); });
         }
 
         if (m_config.m_inprocess_out.is_non_empty_string()) {
@@ -2187,6 +2328,15 @@ namespace sat {
             m_config.m_restart_margin * m_slow_glue_avg <= m_fast_glue_avg;
     }
 
+    void solver::dump_profile() {
+#ifdef Z3_SAT_PROFILE
+        if (!m_config.m_profile_file.is_non_empty_string())
+            return;
+        std::ofstream out(m_config.m_profile_file.str());
+        m_profile.display_json(out);
+#endif
+    }
+
     void solver::log_stats() {
         m_restart_logs++;
         
@@ -3502,6 +3652,9 @@ namespace sat {
         m_assignment.shrink(2*v);
         m_justification.shrink(v);
         m_decision.shrink(v);
+        for (bool_var w = v; w < m_eliminated.size(); ++w)
+            if (m_eliminated[w])
+                --m_num_eliminated;
         m_eliminated.shrink(v);
         m_external.shrink(v);
         m_var_scope.shrink(v);
@@ -3663,6 +3816,7 @@ namespace sat {
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
         m_scc.updt_params(p);
+        m_inprocess.updt_params(p);
         m_rand.set_seed(m_config.m_random_seed);
         m_step_size = m_config.m_step_size_init;
         m_drat.updt_config();
@@ -3692,9 +3846,13 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_inprocess.collect_statistics(st);
         if (m_ext) m_ext->collect_statistics(st);
         if (m_local_search) m_local_search->collect_statistics(st);
         if (m_cut_simplifier) m_cut_simplifier->collect_statistics(st);
+        SAT_PROFILE_CODE(m_profile.collect_statistics(st););
+        st.update("sat clause bytes", static_cast<double>(cls_allocator().get_allocation_size()));
+        st.update("sat clause arena bytes", static_cast<double>(cls_allocator().get_reserved_size()));
         st.copy(m_aux_stats);
     }
 
@@ -3704,7 +3862,9 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        m_inprocess.reset_statistics();
         m_aux_stats.reset();
+        SAT_PROFILE_CODE(m_profile.reset(););
     }
 
     // -----------------------
@@ -4666,6 +4826,7 @@ namespace sat {
         st.update("sat propagations 2ary", m_bin_propagate);
         st.update("sat propagations 3ary", m_ter_propagate);
         st.update("sat propagations nary", m_propagate);
+        st.update("sat clause visits", m_clause_visits);
         st.update("sat restarts", m_restart);
         st.update("sat minimized lits", m_minimized_lits);
         st.update("sat subs resolution dyn", m_dyn_sub_res);
@@ -4675,6 +4836,10 @@ namespace sat {
         st.update("sat elim bool vars bdd", m_elim_var_bdd);
         st.update("sat backjumps", m_backjumps);
         st.update("sat backtracks", m_backtracks);
+        st.update("sat par shared", m_par_shared);
+        st.update("sat par imported", m_par_imported);
+        st.update("sat par dropped", m_par_dropped);
+        st.update("sat par lapped", m_par_lapped);
     }
 
     void stats::reset() {
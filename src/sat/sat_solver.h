@@ -41,11 +41,13 @@ Revision History:
 #include "sat/sat_asymm_branch.h"
 #include "sat/sat_cut_simplifier.h"
 #include "sat/sat_probing.h"
+#include "sat/sat_inprocess.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_binspr.h"
 #include "sat/sat_drat.h"
 #include "sat/sat_parallel.h"
 #include "sat/sat_local_search.h"
+#include "sat/sat_profile.h"
 #include "sat/sat_solver_core.h"
 
 namespace pb {
@@ -66,6 +68,7 @@ namespace sat {
         unsigned m_propagate;
         unsigned m_bin_propagate;
         unsigned m_ter_propagate;
+        unsigned m_clause_visits;
         unsigned m_decision;
         unsigned m_restart;
         unsigned m_gc_clause;
@@ -79,6 +82,10 @@ namespace sat {
         unsigned m_units;
         unsigned m_backtracks;
         unsigned m_backjumps;
+        unsigned m_par_shared;
+        unsigned m_par_imported;
+        unsigned m_par_dropped;
+        unsigned m_par_lapped;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -115,6 +122,7 @@ namespace sat {
         bool                    m_is_probing { false };
         mus                     m_mus;           // MUS for minimal core extraction
         binspr                  m_binspr;
+        inprocess               m_inprocess;
         bool                    m_inconsistent;
         bool                    m_searching;
         // A conflict is usually a single justification. That is, a justification
@@ -133,6 +141,8 @@ namespace sat {
         bool_vector             m_mark;
         bool_vector             m_lit_mark;
         bool_vector             m_eliminated;
+        unsigned                m_num_eliminated { 0 };  // number of true entries of m_eliminated
+        int64_t                 m_num_clause_lits { 0 }; // literals of the allocated clauses, see inprocess_size()
         bool_vector             m_external;
         unsigned_vector         m_var_scope;
         unsigned_vector         m_touched;
@@ -196,8 +206,8 @@ namespace sat {
         literal_vector          m_core;             // unsat core
 
         unsigned                m_par_id;        
-        unsigned                m_par_limit_in;
         unsigned                m_par_limit_out;
+        unsigned_vector         m_par_elems;
         unsigned                m_par_num_vars;
         bool                    m_par_syncing_clauses;
 
@@ -205,6 +215,9 @@ namespace sat {
         class i_local_search*   m_local_search;
 
         statistics              m_aux_stats;        
+#ifdef Z3_SAT_PROFILE
+        propagation_profile     m_profile;
+#endif
 
         void del_clauses(clause_vector& clauses);
 
@@ -224,6 +237,7 @@ namespace sat {
         friend class anf_simplifier;
         friend class cut_simplifier;
         friend class parallel;
+        friend class cube_and_conquer;
         friend class lookahead;
         friend class local_search;
         friend class ddfw;
@@ -291,8 +305,10 @@ namespace sat {
 
         inline clause_allocator& cls_allocator() { return m_cls_allocator[m_cls_allocator_idx]; }
         inline clause_allocator const& cls_allocator() const { return m_cls_allocator[m_cls_allocator_idx]; }
-        inline clause * alloc_clause(unsigned num_lits, literal const * lits, bool learned) { return cls_allocator().mk_clause(num_lits, lits, learned); }
-        inline void dealloc_clause(clause* c) { cls_allocator().del_clause(c); }
+        inline clause * alloc_clause(unsigned num_lits, literal const * lits, bool learned) { m_num_clause_lits += num_lits; return cls_allocator().mk_clause(num_lits, lits, learned); }
+        inline void dealloc_clause(clause* c) { m_num_clause_lits -= c->size(); cls_allocator().del_clause(c); }
+        // an allocated clause lost n literals for good
+        inline void clause_lits_removed(unsigned n) { m_num_clause_lits -= n; }
         struct cmp_activity;
         void defrag_clauses();
         bool should_defrag();
@@ -569,6 +585,10 @@ namespace sat {
         bool is_assumption(literal l) const;
         bool should_simplify() const;
         void do_simplify();
+        uint64_t inprocess_size() const;
+        bool check_inprocess_size() const;
+        template<typename F>
+        void inprocess_step(inprocess::technique t, F const& f);
         void mk_model();
         bool check_model(model const & m) const;
         void do_restart(bool to_base);
@@ -577,6 +597,7 @@ namespace sat {
         unsigned m_restart_logs;
         unsigned restart_level(bool to_base);
         void log_stats();
+        void dump_profile();
         bool should_cancel();
         bool should_restart() const;
         void set_next_restart();
@@ -585,6 +606,7 @@ namespace sat {
         void sort_watch_lits();
         void exchange_par();
         lbool check_par(unsigned num_lits, literal const* lits);
+        lbool check_cube_and_conquer(unsigned num_lits, literal const* lits);
         lbool do_local_search(unsigned num_lits, literal const* lits);
         lbool do_ddfw_search(unsigned num_lits, literal const* lits);
         lbool do_prob_search(unsigned num_lits, literal const* lits);
@@ -621,7 +643,7 @@ namespace sat {
         }
 
         clause& get_clause(watched const& w) const {
-            SASSERT(w.get_kind() == watched::CLAUSE);
+            SASSERT(w.is_clause() || w.is_ternary_clause());
             return get_clause(w.get_clause_offset());
         }
 
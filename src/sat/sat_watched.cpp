@@ -26,11 +26,11 @@ namespace sat {
         watch_list::iterator it  = wlist.begin();              
         watch_list::iterator end = wlist.end();                
         for (; it != end; ++it) {                              
-            if (it->is_clause() && it->get_clause_offset() == c) {                                        
+            if ((it->is_clause() || it->is_ternary_clause()) && it->get_clause_offset() == c) {                                        
                 watch_list::iterator it2 = it;                 
                 ++it;    
                 for (; it != end; ++it, ++it2) {                      
-                    SASSERT(!((it->is_clause() && it->get_clause_offset() == c)));
+                    SASSERT(!((it->is_clause() || it->is_ternary_clause()) && it->get_clause_offset() == c));
                     *it2 = *it;                                
                 }                    
                 wlist.set_end(it2);
@@ -95,6 +95,9 @@ namespace sat {
             case watched::CLAUSE:
                 out << "(" << w.get_blocked_literal() << " " << *(ca.get_clause(w.get_clause_offset())) << ")";
                 break;
+            case watched::TERNARY:
+                out << "(" << w.literal1() << " " << w.literal2() << ")";
+                break;
             case watched::EXT_CONSTRAINT:
                 if (ext) {
                     ext->display_constraint(out, w.get_ext_constraint_idx());
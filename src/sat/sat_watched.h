@@ -33,6 +33,10 @@ namespace sat {
        For binary clauses: we use a bit to store whether the binary clause was learned or not.
        
        Remark: there are no clause objects for binary clauses.
+
+       Ternary clauses are watched on all three literals. The watch stores the other two
+       literals next to the clause offset, so propagation only accesses the clause
+       when it propagates or becomes false.
     */
 
     class extension;
@@ -40,10 +44,10 @@ namespace sat {
     class watched {
     public:
         enum kind {
-            BINARY = 0, CLAUSE, EXT_CONSTRAINT
+            BINARY = 0, CLAUSE, EXT_CONSTRAINT, TERNARY
         };
     private:
-        size_t   m_val1;
+        uint64_t m_val1;
         unsigned m_val2; 
     public:
         watched(literal l, bool learned):
@@ -59,13 +63,22 @@ namespace sat {
         unsigned val2() const { return m_val2; }
 
         watched(literal blocked_lit, clause_offset cls_off):
-            m_val1(cls_off), 
+            m_val1(static_cast<uint64_t>(cls_off) << 32), 
             m_val2(static_cast<unsigned>(CLAUSE) + (blocked_lit.to_uint() << 2)) {
             SASSERT(is_clause());
             SASSERT(get_blocked_literal() == blocked_lit);
             SASSERT(get_clause_offset() == cls_off);
         }
 
+        watched(literal l1, literal l2, clause_offset cls_off):
+            m_val1(l1.to_uint() + (static_cast<uint64_t>(cls_off) << 32)),
+            m_val2(static_cast<unsigned>(TERNARY) + (l2.to_uint() << 2)) {
+            SASSERT(is_ternary_clause());
+            SASSERT(literal1() == l1);
+            SASSERT(literal2() == l2);
+            SASSERT(get_clause_offset() == cls_off);
+        }
+
         explicit watched(ext_constraint_idx cnstr_idx):
             m_val1(cnstr_idx),
             m_val2(static_cast<unsigned>(EXT_CONSTRAINT)) {
@@ -87,30 +100,38 @@ namespace sat {
                 
 
         bool is_clause() const { return get_kind() == CLAUSE; }
-        clause_offset get_clause_offset() const { SASSERT(is_clause()); return static_cast<clause_offset>(m_val1); }
+        clause_offset get_clause_offset() const { SASSERT(is_clause() || is_ternary_clause()); return static_cast<clause_offset>(m_val1 >> 32); }
         literal get_blocked_literal() const { SASSERT(is_clause()); return to_literal(m_val2 >> 2); }
-        void set_clause_offset(clause_offset c) { SASSERT(is_clause()); m_val1 = c; }
+        void set_clause_offset(clause_offset c) { SASSERT(is_clause() || is_ternary_clause()); m_val1 = (m_val1 & 0xFFFFFFFFull) + (static_cast<uint64_t>(c) << 32); }
         void set_blocked_literal(literal l) { SASSERT(is_clause()); m_val2 = static_cast<unsigned>(CLAUSE) + (l.to_uint() << 2); }
         void set_clause(literal blocked_lit, clause_offset cls_off) {
-            m_val1 = cls_off;
+            m_val1 = static_cast<uint64_t>(cls_off) << 32;
             m_val2 = static_cast<unsigned>(CLAUSE) + (blocked_lit.to_uint() << 2);
         }
 
+        bool is_ternary_clause() const { return get_kind() == TERNARY; }
+        literal literal1() const { SASSERT(is_ternary_clause()); return to_literal(static_cast<unsigned>(m_val1)); }
+        literal literal2() const { SASSERT(is_ternary_clause()); return to_literal(m_val2 >> 2); }
+
         bool is_ext_constraint() const { return get_kind() == EXT_CONSTRAINT; }
-        ext_constraint_idx get_ext_constraint_idx() const { SASSERT(is_ext_constraint()); return m_val1; }
+        ext_constraint_idx get_ext_constraint_idx() const { SASSERT(is_ext_constraint()); return static_cast<ext_constraint_idx>(m_val1); }
         
         bool operator==(watched const & w) const { return m_val1 == w.m_val1 && m_val2 == w.m_val2; }
         bool operator!=(watched const & w) const { return !operator==(w); }
     };
 
-    static_assert(0 <= watched::BINARY && watched::BINARY <= 2, "");
-    static_assert(0 <= watched::CLAUSE && watched::CLAUSE <= 2, "");
-    static_assert(0 <= watched::EXT_CONSTRAINT && watched::EXT_CONSTRAINT <= 2, "");
+    static_assert(0 <= watched::BINARY && watched::BINARY <= 3, "");
+    static_assert(0 <= watched::CLAUSE && watched::CLAUSE <= 3, "");
+    static_assert(0 <= watched::EXT_CONSTRAINT && watched::EXT_CONSTRAINT <= 3, "");
+    static_assert(0 <= watched::TERNARY && watched::TERNARY <= 3, "");
+    static_assert(sizeof(clause_offset) == 4, "clause offsets are packed in the upper half of a watch");
 
     struct watched_lt {
         bool operator()(watched const & w1, watched const & w2) const {
             if (w2.is_binary_clause()) return false;
             if (w1.is_binary_clause()) return true;
+            if (w2.is_ternary_clause()) return false;
+            if (w1.is_ternary_clause()) return true;
             return false;
         }
     };
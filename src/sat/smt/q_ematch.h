@@ -145,6 +145,8 @@ namespace q {
 
         void collect_statistics(statistics& st) const;
 
+        void write_profile() { m_inst_queue.write_profile(); }
+
         void get_antecedents(sat::literal l, sat::ext_justification_idx idx, sat::literal_vector& r, bool probing);
 
         // callback from mam
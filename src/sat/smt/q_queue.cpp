@@ -40,6 +40,10 @@ namespace q {
         setup();
     }
 
+    queue::~queue() {
+        write_profile();
+    }
+
     void queue::setup() {
         TRACE("q", tout << "qi_cost: " << m_params.m_qi_cost << "\n";);
         if (!m_parser.parse_string(m_params.m_qi_cost.c_str(), m_cost_function)) {
@@ -136,7 +140,42 @@ namespace q {
         m_new_entries.push_back(entry(f, cost));
     }
 
+    struct queue::shrink_profile_terms : public trail {
+        quantifier_profile& p;
+        unsigned            m_num_terms;
+        shrink_profile_terms(quantifier_profile& p, unsigned n): p(p), m_num_terms(n) {}
+        void undo() override {
+            p.shrink_terms(m_num_terms);
+        }
+    };
+
     void queue::instantiate(entry& ent) {
+        if (!m_profile) {
+            if (m_params.m_qi_profile_file.empty()) {
+                instantiate_core(ent);
+                return;
+            }
+            m_profile = alloc(quantifier_profile, m, m_params.m_qi_profile_loop_generation);
+        }
+        binding& f = *ent.m_qb;
+        m_profile->start_instance(m_profile->get_trigger(f.q(), f.m_pattern));
+        for (unsigned i = 0; i < f.size(); ++i)
+            m_profile->add_binding(f[i]->get_expr());
+        auto const& nodes = ctx.get_egraph().nodes();
+        unsigned num_nodes = nodes.size();
+        unsigned num_terms = m_profile->num_terms();
+        bool instantiated = instantiate_core(ent);
+        for (unsigned i = num_nodes; i < nodes.size(); ++i)
+            m_profile->add_term(nodes[i]->get_expr(), nodes[i]->generation());
+        if (m_profile->num_terms() > num_terms)
+            ctx.push(shrink_profile_terms(*m_profile, num_terms));
+        m_profile->end_instance(instantiated);
+    }
+
+    /**
+     * Create the instance of ent. Return false if the instance is redundant.
+     */
+    bool queue::instantiate_core(entry& ent) {
         binding& f               = *ent.m_qb;
         quantifier * q           = f.q();
         unsigned num_bindings    = f.size();
@@ -147,7 +186,7 @@ namespace q {
         unsigned gen = get_new_gen(f, ent.m_cost);
         bool new_propagation = false;
         if (em.propagate(true, f.nodes(), gen, *f.c, new_propagation))
-            return;
+            return new_propagation;
 
 
         auto* ebindings = m_subst(q, num_bindings);
@@ -157,7 +196,7 @@ namespace q {
         ctx.get_rewriter()(instance);
         if (m.is_true(instance)) {
             stat->inc_num_instances_simplify_true();
-            return;
+            return false;
         }
         stat->inc_num_instances();
 
@@ -177,6 +216,7 @@ namespace q {
         euf::solver::scoped_generation _sg(ctx, gen);
         sat::literal result_l = ctx.mk_literal(instance);
         em.add_instantiation(*f.c, f, result_l);
+        return true;
     }
 
     bool queue::propagate() {
@@ -265,4 +305,9 @@ namespace q {
         st.update("q max missed cost", fmax);
     }
 
+    void queue::write_profile() {
+        if (m_profile)
+            m_profile->write(m_params.m_qi_profile_file);
+    }
+
 }
@@ -16,6 +16,7 @@ Author:
 --*/
 #pragma once
 
+#include "ast/quantifier_profile.h"
 #include "ast/quantifier_stat.h"
 #include "ast/cost_evaluator.h"
 #include "ast/rewriter/cached_var_subst.h"
@@ -60,9 +61,11 @@ namespace q {
         };
         struct reset_new_entries;
         struct reset_instantiated;
+        struct shrink_profile_terms;
 
         svector<entry>                m_new_entries;
         svector<entry>                m_delayed_entries;
+        scoped_ptr<quantifier_profile> m_profile;
 
         float get_cost(binding& f);
         void set_values(binding& f, float cost);
@@ -70,10 +73,13 @@ namespace q {
         void setup();
         unsigned get_new_gen(binding& f, float cost);
         void instantiate(entry& e);
+        bool instantiate_core(entry& e);
 
     public:
 
         queue(ematch& em, euf::solver& ctx);
+
+        ~queue();
             
         void insert(binding* f);
 
@@ -83,5 +89,7 @@ namespace q {
 
         void collect_statistics(::statistics & st) const;
 
+        void write_profile();
+
     };
 }
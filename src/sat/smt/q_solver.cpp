@@ -175,6 +175,7 @@ namespace q {
 
     void solver::finalize_model(model& mdl) {
         m_mbqi.finalize_model(mdl);
+        m_ematch.write_profile();
     }
 
     quantifier* solver::flatten(quantifier* q) {
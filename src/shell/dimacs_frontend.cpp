@@ -149,7 +149,8 @@ void verify_solution(char const * file_name) {
         std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
         exit(ERR_OPEN_FILE);
     }
-    parse_dimacs(in, std::cerr, solver);
+    in.close();
+    parse_dimacs_file(file_name, std::cerr, solver, sat_params(p).dimacs_threads());
     
     sat::model const & m = g_solver->get_model();
     for (unsigned i = 1; i < m.size(); i++) {
@@ -238,7 +239,8 @@ unsigned read_dimacs(char const * file_name) {
             std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
             exit(ERR_OPEN_FILE);
         }
-        parse_dimacs(in, std::cerr, solver);
+        in.close();
+        parse_dimacs_file(file_name, std::cerr, solver, sp.dimacs_threads());
     }
     else {
         parse_dimacs(std::cin, std::cerr, solver);
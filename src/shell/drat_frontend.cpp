@@ -64,11 +64,27 @@ public:
     }
 };
 
+/**
+   \brief binary DRAT proofs are recognized by a zero byte or a byte outside of 
+   the ASCII range in the first block of the file. Text proofs contain neither.
+*/
+static bool is_binary_drat(char const* drat_file) {
+    std::ifstream ins(drat_file, std::ios::binary);
+    char buffer[1024];
+    ins.read(buffer, sizeof(buffer));
+    std::streamsize n = ins.gcount();
+    for (std::streamsize i = 0; i < n; ++i) 
+        if (buffer[i] == 0 || static_cast<unsigned char>(buffer[i]) > 127)
+            return true;
+    return false;
+}
+
 unsigned read_drat(char const* drat_file) {
     ast_manager m;
     reg_decl_plugins(m);
-    std::ifstream ins(drat_file);
-    dimacs::drat_parser drat(ins, std::cerr);
+    bool binary = is_binary_drat(drat_file);
+    std::ifstream ins(drat_file, binary ? std::ios::in | std::ios::binary : std::ios::in);
+    dimacs::drat_parser drat(ins, std::cerr, binary);
     
     std::function<int(char const* r)> read_theory = [&](char const* r) {
         return m.mk_family_id(symbol(r));
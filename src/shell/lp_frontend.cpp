@@ -9,12 +9,14 @@ Author:
 
 #include "math/lp/lp_settings.h"
 #include "math/lp/mps_reader.h"
+#include "math/lp/lp_bound_propagator.h"
 #include "util/timeout.h"
 #include "util/cancel_eh.h"
 #include "util/scoped_timer.h"
 #include "util/rlimit.h"
 #include "util/gparams.h"
 #include "util/mutex.h"
+#include "util/stopwatch.h"
 #include <iostream>
 #include <signal.h>
 #include "smt/params/smt_params_helper.hpp"
@@ -96,6 +98,118 @@ void run_solver(smt_params_helper & params, char const * mps_file_name) {
     g_solver = nullptr;
     delete solver;
 }
+
+// collects the implied bounds of every row
+struct bprop_bench_imp {
+    lp::lar_solver& m_solver;
+    bprop_bench_imp(lp::lar_solver& s): m_solver(s) {}
+    lp::lar_solver& lp() { return m_solver; }
+    lp::lar_solver const& lp() const { return m_solver; }
+    bool bound_is_interesting(unsigned, lp::lconstraint_kind, rational const&) const { return true; }
+    void consume(rational const&, lp::constraint_index) {}
+    bool add_eq(lp::lpvar, lp::lpvar, lp::explanation const&, bool) { return false; }
+    bool is_equal(unsigned, unsigned) const { return false; }
+};
+
+// pivots a random non-basic column into the basis of a random row, so that 
+// the rows change between rounds as they do during search.
+static void bprop_bench_pivot(lp::lar_solver& s, random_gen& rand) {
+    unsigned m = s.A_r().row_count();
+    if (m == 0)
+        return;
+    unsigned i = rand(m);
+    auto const& row = s.A_r().m_rows[i];
+    unsigned bj = s.r_basis()[i];
+    unsigned sz = row.size();
+    for (unsigned k = 0, start = sz == 0 ? 0 : rand(sz); k < sz; ++k) {
+        unsigned j = row[(start + k) % sz].var();
+        if (j != bj) {
+            s.pivot_column_tableau(j, i);
+            return;
+        }
+    }
+}
+
+static bool same_ibounds(vector<lp::implied_bound> const& a, vector<lp::implied_bound> const& b) {
+    if (a.size() != b.size())
+        return false;
+    for (unsigned k = 0; k < a.size(); ++k)
+        if (!(a[k] == b[k]))
+            return false;
+    return true;
+}
+
+// Measures the simplex, and then bound propagation over all the rows of the tableau 
+// of a feasible solution, with the row strips of the tableau and with the compressed row copy.
+// Some rows are pivoted between rounds, so the compressed rows include the
+// cost of copying changed rows. Both scans must find the same implied bounds.
+void run_bprop_bench(char const * mps_file_name) {
+    std::string fn(mps_file_name);
+    lp::mps_reader<lp::mpq, lp::mpq> reader(fn);
+    reader.set_message_stream(&std::cout);
+    reader.read();
+    if (!reader.is_ok()) {
+        std::cerr << "cannot process " << mps_file_name << std::endl;
+        return;
+    }
+    scoped_ptr<lp::lar_solver> solver;
+    for (bool csr : { false, true }) {
+        solver = reader.create_lar_solver();
+        solver->settings().csr_rows() = csr;
+        stopwatch sw;
+        sw.start();
+        lp::lp_status st = solver->find_feasible_solution();
+        sw.stop();
+        std::cout << "simplex with " << (csr ? "compressed pivot rows" : "row strips") << ": status is " << lp_status_to_string(st)
+                  << " iterations " << solver->stats().m_total_iterations << " time " << sw.get_seconds() << std::endl;
+    }
+    bprop_bench_imp imp(*solver);
+    lp::lp_bound_propagator<bprop_bench_imp> bp(imp);
+    random_gen rand(0);
+    unsigned num_rows = solver->A_r().row_count();
+    unsigned num_rounds = 10;
+    unsigned num_pivots = std::max(1u, num_rows / 100);
+    stopwatch sw[2];
+    unsigned num_bounds[2] = { 0, 0 };
+    unsigned num_copies = solver->stats().m_csr_row_copies;
+    vector<lp::implied_bound> ibounds;
+    // warm-up: consume the rows touched by find_feasible_solution, so that 
+    // both scans of round 0 visit the same rows
+    bp.init();
+    solver->propagate_bounds_for_touched_rows(bp);
+    for (unsigned r = 0; r < num_rounds; ++r) {
+        for (unsigned k = 0; r > 0 && k < num_pivots; ++k)
+            bprop_bench_pivot(*solver, rand);
+        for (bool csr : { false, true }) {
+            solver->settings().csr_rows() = csr;
+            bp.init();
+            for (unsigned j = 0; j < solver->column_count(); ++j)
+                solver->mark_rows_for_bound_prop(j);
+            sw[csr].start();
+            solver->propagate_bounds_for_touched_rows(bp);
+            sw[csr].stop();
+            num_bounds[csr] += bp.ibounds().size();
+            if (!csr)
+                ibounds = bp.ibounds();
+            else if (!same_ibounds(ibounds, bp.ibounds())) {
+                std::cerr << "round " << r << ": the compressed rows imply " << bp.ibounds().size() 
+                          << " bounds, the row strips imply " << ibounds.size() << std::endl;
+                return;
+            }
+        }
+    }
+    num_copies = solver->stats().m_csr_row_copies - num_copies;
+    for (bool csr : { false, true }) {
+        std::cout << (csr ? "compressed rows" : "row strips") << ": rows " << num_rows
+                  << " rounds " << num_rounds << " pivots/round " << num_pivots
+                  << " implied bounds " << num_bounds[csr] 
+                  << " rows/sec " << (sw[csr].get_seconds() > 0 ? num_rows * num_rounds / sw[csr].get_seconds() : 0.0)
+                  << " time " << sw[csr].get_seconds();
+        if (csr)
+            std::cout << " row copies/row " << static_cast<double>(num_copies) / (num_rows * num_rounds);
+        std::cout << std::endl;
+    }
+}
 }
 
 unsigned read_mps_file(char const * mps_file_name) {
@@ -104,6 +218,9 @@ unsigned read_mps_file(char const * mps_file_name) {
     smt_params_helper p;
     param_descrs r;
     p.collect_param_descrs(r);
-    run_solver(p, mps_file_name);
+    if (p.arith_csr_bench())
+        run_bprop_bench(mps_file_name);
+    else
+        run_solver(p, mps_file_name);
     return 0;
 }
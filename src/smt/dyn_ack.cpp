@@ -165,7 +165,8 @@ namespace smt {
     dyn_ack_manager::dyn_ack_manager(context & ctx, dyn_ack_params & p):
         m_context(ctx),
         m(ctx.get_manager()),
-        m_params(p) {
+        m_params(p),
+        m_payoff_decls(m) {
     }
 
     dyn_ack_manager::~dyn_ack_manager() {
@@ -226,7 +227,7 @@ namespace smt {
         unsigned num_occs2 = 0;
         SASSERT(m_app_pair2num_occs.find(n1, n2, num_occs2) && num_occs == num_occs2);
 #endif
-        if (num_occs == m_params.m_dack_threshold) {
+        if (num_occs == get_threshold(n1->get_decl())) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << num_occs << "\n";);
             m_to_instantiate.push_back(p);
         }
@@ -329,7 +330,7 @@ namespace smt {
             ++it2;
             SASSERT(num_occs > 0);
             m_app_pair2num_occs.insert(p.first, p.second, num_occs);
-            if (num_occs >= m_params.m_dack_threshold)
+            if (num_occs >= get_threshold(p.first->get_decl()))
                 m_to_instantiate.push_back(p);
         }
         m_app_pairs.set_end(it2);
@@ -357,6 +358,8 @@ namespace smt {
         app_pair p((app*)nullptr,(app*)nullptr);
         if (m_clause2app_pair.find(cls, p)) {
             SASSERT(p.first && p.second);
+            add_uses(p.first->get_decl(), get_new_uses(cls));
+            m_clause2activity.erase(cls);
             m_instantiated.erase(p);
             m_clause2app_pair.erase(cls);
             SASSERT(!m_app_pair2num_occs.contains(p.first, p.second));
@@ -365,6 +368,8 @@ namespace smt {
         app_triple tr(0,0,0);
         if (m_triple.m_clause2apps.find(cls, tr)) {
             SASSERT(tr.first && tr.second && tr.third);
+            add_uses(nullptr, get_new_uses(cls));
+            m_clause2activity.erase(cls);
             m_triple.m_instantiated.erase(tr);
             m_triple.m_clause2apps.erase(cls);
             SASSERT(!m_triple.m_app2num_occs.contains(tr.first, tr.second, tr.third));
@@ -377,6 +382,8 @@ namespace smt {
             return;
         m_num_propagations_since_last_gc++;
         if (m_num_propagations_since_last_gc > m_params.m_dack_gc) {
+            if (m_params.m_dack_adaptive)
+                update_payoff();
             gc();
             m_num_propagations_since_last_gc = 0;
         }
@@ -438,12 +445,16 @@ namespace smt {
         }
         TRACE("dyn_ack_clause", tout << "new clause:\n"; m_context.display_clause_detail(tout, cls); tout << "\n";);
         m_clause2app_pair.insert(cls, p);
+        add_lemma(cls, n1->get_decl());
     }
 
     void dyn_ack_manager::reset() {
         init_search_eh();
         m_instantiated.reset();
         m_clause2app_pair.reset();
+        m_clause2activity.reset();
+        m_decl2payoff.reset();
+        m_payoff_decls.reset();
         m_triple.m_instantiated.reset();
         m_triple.m_clause2apps.reset();
     }
@@ -494,6 +505,86 @@ namespace smt {
         }
         TRACE("dyn_ack_clause", ctx.display_clause_detail(tout << "new clause:\n", cls); tout << "\n";);
         m_triple.m_clause2apps.insert(cls, tr);
+        add_lemma(cls, nullptr);
+    }
+
+    /**
+       \brief Lower the threshold of function symbols whose lemmas are used in conflicts,
+       and raise it for function symbols whose lemmas are rarely used.
+    */
+    unsigned dyn_ack_manager::get_threshold(func_decl * f) const {
+        unsigned threshold = m_params.m_dack_threshold;
+        payoff p;
+        if (!m_params.m_dack_adaptive || !m_decl2payoff.find(f, p) || p.m_lemmas < 4)
+            return threshold;
+        if (2 * p.m_used >= p.m_lemmas)
+            return std::max(1u, threshold / 2);
+        if (10 * p.m_used < p.m_lemmas)
+            return 4 * threshold;
+        return threshold;
+    }
+
+    void dyn_ack_manager::add_lemma(clause * cls, func_decl * f) {
+        if (!m_params.m_dack_adaptive)
+            return;
+        m_clause2activity.insert(cls, cls->get_activity());
+        if (!f)
+            return;
+        if (!m_decl2payoff.contains(f)) {
+            m_payoff_decls.push_back(f);
+            m_decl2payoff.insert(f, payoff());
+        }
+        m_decl2payoff.find(f).m_lemmas++;
+    }
+
+    void dyn_ack_manager::add_uses(func_decl * f, unsigned n) {
+        if (n == 0)
+            return;
+        m_context.m_stats.m_num_dyn_ack_used += n;
+        if (f && m_decl2payoff.contains(f))
+            m_decl2payoff.find(f).m_used += n;
+    }
+
+    /**
+       \brief Return the number of conflicts cls was used in since the last call.
+       Conflict resolution increments the activity of the lemmas it uses.
+    */
+    unsigned dyn_ack_manager::get_new_uses(clause * cls) {
+        unsigned last = 0;
+        if (!m_clause2activity.find(cls, last))
+            return 0;
+        unsigned act = cls->get_activity();
+        m_clause2activity.insert(cls, act);
+        return act > last ? act - last : 0;
+    }
+
+    /**
+       \brief Collect the uses of the lemmas since the last garbage collection.
+       Lemmas that were not used are demoted to activity 0, so they are the first
+       to be deleted by the next garbage collection of inactive lemmas.
+    */
+    void dyn_ack_manager::update_payoff() {
+        ptr_buffer<clause> unused;
+        for (auto const& [cls, p] : m_clause2app_pair) {
+            unsigned n = get_new_uses(cls);
+            add_uses(p.first->get_decl(), n);
+            if (n == 0)
+                unused.push_back(cls);
+        }
+        for (auto const& [cls, tr] : m_triple.m_clause2apps) {
+            unsigned n = get_new_uses(cls);
+            add_uses(nullptr, n);
+            if (n == 0)
+                unused.push_back(cls);
+        }
+        for (clause * cls : unused) {
+            if (cls->get_activity() == 0)
+                continue;
+            cls->set_activity(0);
+            m_clause2activity.insert(cls, 0);
+            m_context.m_stats.m_num_dyn_ack_demoted++;
+        }
+        TRACE("dyn_ack", tout << "demoted " << unused.size() << " lemmas\n";);
     }
 
 
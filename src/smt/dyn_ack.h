@@ -65,7 +65,21 @@ namespace smt {
             clause2app_triple                      m_clause2apps;
         };
         _triple                                    m_triple;
-        
+
+        // payoff of the Ackermann lemmas, used when m_dack_adaptive is set.
+        struct payoff {
+            unsigned m_lemmas { 0 }; // number of lemmas instantiated for the function symbol
+            unsigned m_used { 0 };   // number of times the lemmas were used in conflicts
+        };
+        obj_map<func_decl, payoff>                 m_decl2payoff;
+        func_decl_ref_vector                       m_payoff_decls;
+        obj_map<clause, unsigned>                  m_clause2activity;
+
+        unsigned get_threshold(func_decl * f) const;
+        unsigned get_new_uses(clause * cls);
+        void add_lemma(clause * cls, func_decl * f);
+        void add_uses(func_decl * f, unsigned n);
+        void update_payoff();
 
 
         void gc();
@@ -20,36 +20,18 @@ Revision History:
 
 namespace smt {
 
-    fingerprint::fingerprint(region & r, void * d, unsigned d_h, expr* def, unsigned n, enode * const * args):
+    fingerprint::fingerprint(void * d, unsigned d_h, expr* def, unsigned n, enode * const * args):
         m_data(d), 
         m_data_hash(d_h),
-        m_def(def),
         m_num_args(n), 
-        m_args(nullptr) {
-        m_args = new (r) enode*[n];
-        memcpy(m_args, args, sizeof(enode*) * n);
+        m_def(def) {
+        memcpy(reinterpret_cast<enode**>(this + 1), args, sizeof(enode*) * n);
     }
 
-    bool fingerprint_set::fingerprint_eq_proc::operator()(fingerprint const * f1, fingerprint const * f2) const {
-        if (f1->get_data() != f2->get_data()) 
-            return false;
-        if (f1->get_num_args() != f2->get_num_args())
-            return false;
-        unsigned n = f1->get_num_args();
-        for(unsigned i = 0; i < n; i++)
-            if (f1->get_arg(i) != f2->get_arg(i))
-                return false;
-        return true;
-    }
-
-    fingerprint * fingerprint_set::mk_dummy(void * data, unsigned data_hash, unsigned num_args, enode * const * args) {
-        m_tmp.reset();
-        m_tmp.append(num_args, args);
-        m_dummy.m_data      = data;
-        m_dummy.m_data_hash = data_hash;
-        m_dummy.m_num_args  = num_args;
-        m_dummy.m_args      = m_tmp.data();
-        return &m_dummy;
+    fingerprint * fingerprint::mk(region & r, void * d, unsigned d_h, expr* def, unsigned n, enode * const * args) {
+        static_assert(sizeof(fingerprint) % sizeof(enode*) == 0, "arguments are stored after the fingerprint");
+        void * mem = r.allocate(get_obj_size(n));
+        return new (mem) fingerprint(d, d_h, def, n, args);
     }
 
     std::ostream& operator<<(std::ostream& out, fingerprint const& f) {
@@ -61,44 +43,119 @@ namespace smt {
         return out;
     }
 
-    
-    fingerprint * fingerprint_set::insert(void * data, unsigned data_hash, unsigned num_args, enode * const * args, expr* def) {
-        fingerprint * d = mk_dummy(data, data_hash, num_args, args);
-        if (m_set.contains(d)) 
-            return nullptr;
+
+    unsigned fingerprint_set::hash(unsigned data_hash, unsigned num_args, enode * const * args) {
+        auto khasher = [&](enode * const *) { return data_hash; };
+        auto chasher = [&](enode * const * a, unsigned idx) { return a[idx]->hash(); };
+        return get_composite_hash(args, num_args, khasher, chasher);
+    }
+
+    bool fingerprint_set::eq(fingerprint const * f, void * data, unsigned num_args, enode * const * args) {
+        if (f->get_data() != data)
+            return false;
+        if (f->get_num_args() != num_args)
+            return false;
+        enode * const * f_args = f->get_args();
         for (unsigned i = 0; i < num_args; i++)
-            d->m_args[i] = d->m_args[i]->get_root();
-        if (m_set.contains(d)) {
-            TRACE("fingerprint_bug", tout << "failed: " << *d;);
+            if (f_args[i] != args[i])
+                return false;
+        return true;
+    }
+
+    fingerprint * fingerprint_set::find(unsigned h, void * data, unsigned num_args, enode * const * args) const {
+        if (m_table.empty())
             return nullptr;
+        unsigned mask = m_table.size() - 1;
+        for (unsigned idx = h & mask; ; idx = (idx + 1) & mask) {
+            cell const & c = m_table[idx];
+            if (!c.m_fingerprint)
+                return nullptr;
+            if (c.m_hash == h && eq(c.m_fingerprint, data, num_args, args))
+                return c.m_fingerprint;
         }
-        TRACE("fingerprint_bug", tout << "inserting @" << m_scopes.size() << " " << *d;);
-        fingerprint * f = new (m_region) fingerprint(m_region, data, data_hash, def, num_args, d->m_args);
+    }
+
+    void fingerprint_set::insert_cell(unsigned h, fingerprint * f) {
+        unsigned mask = m_table.size() - 1;
+        unsigned idx = h & mask;
+        while (m_table[idx].m_fingerprint)
+            idx = (idx + 1) & mask;
+        m_table[idx].m_hash = h;
+        m_table[idx].m_fingerprint = f;
+    }
+
+    void fingerprint_set::erase_cell(fingerprint * f) {
+        unsigned h = hash(f->get_data_hash(), f->get_num_args(), f->get_args());
+        unsigned mask = m_table.size() - 1;
+        unsigned idx = h & mask;
+        while (m_table[idx].m_fingerprint != f) {
+            SASSERT(m_table[idx].m_fingerprint);
+            idx = (idx + 1) & mask;
+        }
+        m_table[idx].m_fingerprint = nullptr;
+    }
+
+    void fingerprint_set::expand_table() {
+        unsigned capacity = m_table.empty() ? 64 : 2 * m_table.size();
+        m_table.reset();
+        m_table.resize(capacity);
+        for (fingerprint * f : m_fingerprints)
+            insert_cell(hash(f->get_data_hash(), f->get_num_args(), f->get_args()), f);
+    }
+
+    /**
+       \brief check if the set contains (data args) where the arguments are replaced by their roots.
+       h is the hash of the fingerprint with the roots as arguments, which are stored in m_tmp.
+    */
+    bool fingerprint_set::find_roots(void * data, unsigned data_hash, unsigned num_args, enode * const * args, unsigned & h) {
+        m_tmp.reset();
+        bool is_root = true;
+        for (unsigned i = 0; i < num_args; i++) {
+            enode * r = args[i]->get_root();
+            is_root &= r == args[i];
+            m_tmp.push_back(r);
+        }
+        h = hash(data_hash, num_args, args);
+        if (find(h, data, num_args, args))
+            return true;
+        if (is_root)
+            return false;
+        h = hash(data_hash, num_args, m_tmp.data());
+        return find(h, data, num_args, m_tmp.data()) != nullptr;
+    }
+
+    fingerprint * fingerprint_set::insert(void * data, unsigned data_hash, unsigned num_args, enode * const * args, expr* def) {
+        unsigned h = 0;
+        if (find_roots(data, data_hash, num_args, args, h)) {
+            TRACE("fingerprint_bug", tout << "failed: " << data_hash << " num_args " << num_args << "\n";);
+            return nullptr;
+        }
+        fingerprint * f = fingerprint::mk(m_region, data, data_hash, def, num_args, m_tmp.data());
+        TRACE("fingerprint_bug", tout << "inserting @" << m_scopes.size() << " " << *f;);
+        if (4 * (m_fingerprints.size() + 1) > 3 * m_table.size())
+            expand_table();
         m_fingerprints.push_back(f);
         m_defs.push_back(def);
-        m_set.insert(f);
+        insert_cell(h, f);
         return f;
     }
 
     bool fingerprint_set::contains(void * data, unsigned data_hash, unsigned num_args, enode * const * args) {
-        fingerprint * d = mk_dummy(data, data_hash, num_args, args);
-        if (m_set.contains(d)) 
-            return true;
-        for (unsigned i = 0; i < num_args; i++)
-            d->m_args[i] = d->m_args[i]->get_root();
-        if (m_set.contains(d))
-            return true;
-        return false;
+        unsigned h = 0;
+        return find_roots(data, data_hash, num_args, args, h);
     }
     
     void fingerprint_set::reset() {
-        m_set.reset();
+        m_table.reset();
         m_fingerprints.reset();
         m_defs.reset();
+        m_scopes.reset();
+        m_region.reset();
     }
         
     void fingerprint_set::push_scope() {
         m_scopes.push_back(m_fingerprints.size());
+        m_region.push_scope();
     }
     
     void fingerprint_set::pop_scope(unsigned num_scopes) {
@@ -106,23 +163,30 @@ namespace smt {
         SASSERT(num_scopes <= lvl);
         unsigned new_lvl  = lvl - num_scopes;
         unsigned old_size = m_scopes[new_lvl];
-        unsigned size     = m_fingerprints.size();
-        for (unsigned i = old_size; i < size; i++) 
-            m_set.erase(m_fingerprints[i]);
+        // erase in the reverse order of insertion.
+        for (unsigned i = m_fingerprints.size(); i-- > old_size; )
+            erase_cell(m_fingerprints[i]);
         m_fingerprints.shrink(old_size);
         m_defs.shrink(old_size);
         m_scopes.shrink(new_lvl);
+        m_region.pop_scope(num_scopes);
         TRACE("fingerprint_bug", tout << "pop @" << m_scopes.size() << "\n";);
     }
 
     void fingerprint_set::display(std::ostream & out) const {
         out << "fingerprints:\n";
-        SASSERT(m_set.size() == m_fingerprints.size());
         for (fingerprint const * f : m_fingerprints) {
             out << f->get_data() << " " << *f;
         }
     }
 
+    size_t fingerprint_set::memory_size() const {
+        size_t sz = m_table.capacity() * sizeof(cell) + m_fingerprints.capacity() * (sizeof(fingerprint*) + sizeof(expr*));
+        for (fingerprint const * f : m_fingerprints)
+            sz += fingerprint::get_obj_size(f->get_num_args());
+        return sz;
+    }
+
 #ifdef Z3DEBUG
     /**
        \brief Slow function for checking if there is a fingerprint congruent to (data args[0] ... args[num_args-1])
@@ -23,57 +23,68 @@ Revision History:
 
 namespace smt {
 
+    /**
+       \brief A fingerprint is allocated together with its arguments,
+       which are stored directly after the fingerprint.
+    */
     class fingerprint {
     protected:
         void*         m_data{ nullptr };
         unsigned      m_data_hash{ 0 };
-        expr*         m_def{ nullptr };
         unsigned      m_num_args{ 0 };
-        enode**       m_args{ nullptr };
+        expr*         m_def{ nullptr };
 
         friend class fingerprint_set;
-        fingerprint() {}
+        fingerprint(void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
     public:
-        fingerprint(region & r, void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
+        static fingerprint * mk(region & r, void * d, unsigned d_hash, expr* def, unsigned n, enode * const * args);
+        static size_t get_obj_size(unsigned n) { return sizeof(fingerprint) + n * sizeof(enode*); }
         void * get_data() const { return m_data; }
         expr * get_def() const { return m_def; }
         unsigned get_data_hash() const { return m_data_hash; }
         unsigned get_num_args() const { return m_num_args;  }
-        enode * const * get_args() const { return m_args; }
-        enode * get_arg(unsigned idx) const { SASSERT(idx < m_num_args); return m_args[idx]; }
-        enode * const * begin() const { return m_args; }
+        enode * const * get_args() const { return reinterpret_cast<enode * const *>(this + 1); }
+        enode * get_arg(unsigned idx) const { SASSERT(idx < m_num_args); return get_args()[idx]; }
+        enode * const * begin() const { return get_args(); }
         enode * const * end() const { return begin() + get_num_args(); }
         friend std::ostream& operator<<(std::ostream& out, fingerprint const& f);
     };
-    
+
+    /**
+       \brief Set of fingerprints with backtracking.
+
+       The fingerprints are kept in an open addressing table with linear probing
+       that stores the hash of each fingerprint next to it, and they are allocated
+       in a region that is scoped together with the set.
+       Fingerprints are removed in the reverse order of insertion, so an entry
+       can be removed by clearing its cell: no fingerprint inserted before it
+       was probed past it. The table is rehashed in the order of insertion
+       to preserve this property.
+    */
     class fingerprint_set {
-        
-        struct fingerprint_khasher {
-            unsigned operator()(fingerprint const * f) const { return f->get_data_hash(); }
-        };
-        struct fingerprint_chasher {
-            unsigned operator()(fingerprint const * f, unsigned idx) const { return f->get_arg(idx)->hash(); }
-        };
-        struct fingerprint_hash_proc {
-            unsigned operator()(fingerprint const * f) const {
-                return get_composite_hash<fingerprint *, fingerprint_khasher, fingerprint_chasher>(const_cast<fingerprint*>(f), f->get_num_args());
-            }
+
+        struct cell {
+            unsigned      m_hash { 0 };
+            fingerprint * m_fingerprint { nullptr };
         };
-        struct fingerprint_eq_proc { bool operator()(fingerprint const * f1, fingerprint const * f2) const; };
-        typedef ptr_hashtable<fingerprint, fingerprint_hash_proc, fingerprint_eq_proc> set;
 
-        region &                 m_region;
-        set                      m_set;
+        region                   m_region;
+        svector<cell>            m_table;
         ptr_vector<fingerprint>  m_fingerprints;
         expr_ref_vector          m_defs;
         unsigned_vector          m_scopes;
         ptr_vector<enode>        m_tmp;
-        fingerprint              m_dummy;
 
-        fingerprint * mk_dummy(void * data, unsigned data_hash, unsigned num_args, enode * const * args);
+        static unsigned hash(unsigned data_hash, unsigned num_args, enode * const * args);
+        static bool eq(fingerprint const * f, void * data, unsigned num_args, enode * const * args);
+        fingerprint * find(unsigned h, void * data, unsigned num_args, enode * const * args) const;
+        bool find_roots(void * data, unsigned data_hash, unsigned num_args, enode * const * args, unsigned & h);
+        void insert_cell(unsigned h, fingerprint * f);
+        void erase_cell(fingerprint * f);
+        void expand_table();
 
     public:
-        fingerprint_set(ast_manager& m, region & r): m_region(r), m_defs(m) {}
+        fingerprint_set(ast_manager& m): m_defs(m) {}
         fingerprint * insert(void * data, unsigned data_hash, unsigned num_args, enode * const * args, expr* def);
         unsigned size() const { return m_fingerprints.size(); }
         bool contains(void * data, unsigned data_hash, unsigned num_args, enode * const * args);
@@ -81,10 +92,12 @@ namespace smt {
         void push_scope();
         void pop_scope(unsigned num_scopes);
         void display(std::ostream & out) const;
+        /**
+           \brief number of bytes used by the table and the fingerprints.
+        */
+        size_t memory_size() const;
 #ifdef Z3DEBUG
         bool slow_contains(void const * data, unsigned data_hash, unsigned num_args, enode * const * args) const;
 #endif
     };
 };
-
-
@@ -21,11 +21,17 @@ Revision History:
 #include "util/pool.h"
 #include "util/trail.h"
 #include "util/stopwatch.h"
+#include "util/mutex.h"
+#include "util/scoped_ptr_vector.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_smt2_pp.h"
 #include "smt/mam.h"
 #include "smt/smt_context.h"
+#ifndef SINGLE_THREAD
+#include <atomic>
+#include <thread>
+#endif
 
 using namespace smt;
 
@@ -387,6 +393,7 @@ namespace {
         unsigned                   m_num_choices;
         instruction *              m_root;
         enode_vector               m_candidates;
+        double                     m_match_time { 0 };
 #ifdef Z3DEBUG
         context *                  m_context;
         ptr_vector<app>            m_patterns;
@@ -542,6 +549,14 @@ namespace {
             return m_candidates;
         }
 
+        void add_match_time(double secs) {
+            m_match_time += secs;
+        }
+
+        double get_match_time() const {
+            return m_match_time;
+        }
+
 #ifdef Z3DEBUG
         void set_context(context * ctx) {
             SASSERT(m_context == 0);
@@ -562,7 +577,7 @@ namespace {
                     out << mk_pp(a, m) << "\n";
             }
 #endif
-            out << "function: " << m_root_lbl->get_name();
+            out << "function: " << m_root_lbl->get_name() << " match time: " << m_match_time << " secs";
 #ifdef _PROFILE_MAM
             out << " " << m_watch.get_seconds() << " secs, [" << m_counter << "]";
 #endif
@@ -1833,6 +1848,30 @@ namespace {
 
     typedef svector<backtrack_point> backtrack_stack;
 
+    /**
+       \brief matches of a code tree found by a worker thread.
+       They are passed to the quantifier instantiation queue after all threads are done.
+    */
+    struct match_buffer {
+        struct record {
+            quantifier * m_qa;
+            app *        m_pat;
+            unsigned     m_bindings;       // offset in m_bindings
+            unsigned     m_num_bindings;
+            unsigned     m_max_generation;
+            unsigned     m_min_top_generation;
+            unsigned     m_max_top_generation;
+            unsigned     m_used_enodes;    // offset in m_used_enodes
+            unsigned     m_num_used_enodes;
+        };
+        enode_vector                         m_candidates;
+        svector<record>                      m_records;
+        enode_vector                         m_bindings;
+        vector<std::tuple<enode *, enode *>> m_used_enodes;
+        double                               m_time { 0 };
+        bool                                 m_completed { false };
+    };
+
     class interpreter {
         context &           m_context;
         ast_manager &       m;
@@ -1864,6 +1903,29 @@ namespace {
 
         pool<enode_vector>  m_pool;
 
+        // When m_buffer is set, the interpreter runs on a worker thread: 
+        // matches are recorded in m_buffer and congruence table lookups
+        // are serialized using m_cg_mux.
+        match_buffer *      m_buffer { nullptr };
+        mutex *             m_cg_mux { nullptr };
+
+        bool canceled() {
+            return m_buffer ? m.limit().is_canceled() : m_context.get_cancel_flag();
+        }
+
+        bool limits_exceeded() {
+            return m_buffer ? m.limit().is_canceled() : m_context.resource_limits_exceeded();
+        }
+
+        enode * get_enode_eq_to(func_decl * f, unsigned num_args, enode * const * args) {
+            if (!m_cg_mux)
+                return m_context.get_enode_eq_to(f, num_args, args);
+            lock_guard lock(*m_cg_mux);
+            return m_context.get_enode_eq_to(f, num_args, args);
+        }
+
+        void record_match(quantifier * qa, app * pat, unsigned num_bindings);
+
         enode_vector * mk_enode_vector() {
             enode_vector * r = m_pool.mk();
             r->reset();
@@ -1998,6 +2060,11 @@ namespace {
         ~interpreter() {
         }
 
+        void set_buffer(match_buffer * b, mutex * cg_mux) {
+            m_buffer = b;
+            m_cg_mux = cg_mux;
+        }
+
         void init(code_tree * t) {
             TRACE("mam_bug", tout << "preparing to match tree:\n" << *t << "\n";);
             m_registers.reserve(t->get_num_regs(), nullptr);
@@ -2064,6 +2131,22 @@ namespace {
         }
     };
 
+    void interpreter::record_match(quantifier * qa, app * pat, unsigned num_bindings) {
+        match_buffer::record r;
+        r.m_qa               = qa;
+        r.m_pat              = pat;
+        r.m_bindings         = m_buffer->m_bindings.size();
+        r.m_num_bindings     = num_bindings;
+        r.m_max_generation   = m_max_generation;
+        get_min_max_top_generation(r.m_min_top_generation, r.m_max_top_generation);
+        r.m_used_enodes      = m_buffer->m_used_enodes.size();
+        r.m_num_used_enodes  = m_used_enodes.size();
+        m_buffer->m_bindings.append(num_bindings, m_bindings.data());
+        for (auto const& e : m_used_enodes)
+            m_buffer->m_used_enodes.push_back(e);
+        m_buffer->m_records.push_back(r);
+    }
+
     /**
        \brief Return a vector with the relevant f-parents of n such that n is the i-th argument.
     */
@@ -2534,14 +2617,19 @@ namespace {
             m_bindings[0] = m_registers[static_cast<const yield *>(m_pc)->m_bindings[0]];
 #define ON_MATCH(NUM)                                                   \
             m_max_generation = std::max(m_max_generation, get_max_generation(NUM, m_bindings.begin())); \
-            if (m_context.get_cancel_flag()) {                          \
+            if (canceled()) {                                           \
                 return false;                                           \
             }                                                           \
-            m_mam.on_match(static_cast<const yield *>(m_pc)->m_qa,                                      \
-                           static_cast<const yield *>(m_pc)->m_pat,                                     \
-                           NUM,                                                                         \
-                           m_bindings.begin(),                                                          \
-                           m_max_generation, m_used_enodes)
+            if (m_buffer)                                               \
+                record_match(static_cast<const yield *>(m_pc)->m_qa,    \
+                             static_cast<const yield *>(m_pc)->m_pat,   \
+                             NUM);                                      \
+            else                                                        \
+                m_mam.on_match(static_cast<const yield *>(m_pc)->m_qa,                                  \
+                               static_cast<const yield *>(m_pc)->m_pat,                                 \
+                               NUM,                                                                     \
+                               m_bindings.begin(),                                                      \
+                               m_max_generation, m_used_enodes)
             ON_MATCH(1);
             goto backtrack;
 
@@ -2599,7 +2687,7 @@ namespace {
 
         case GET_CGR1:
 #define GET_CGR_COMMON()                                                                                                                                                \
-            m_n1 = m_context.get_enode_eq_to(static_cast<const get_cgr *>(m_pc)->m_label, static_cast<const get_cgr *>(m_pc)->m_num_args, m_args.data());              \
+            m_n1 = get_enode_eq_to(static_cast<const get_cgr *>(m_pc)->m_label, static_cast<const get_cgr *>(m_pc)->m_num_args, m_args.data());                 \
             if (m_n1 == 0 || !m_context.is_relevant(m_n1))                                                                                                              \
                 goto backtrack;                                                                                                                                         \
             update_max_generation(m_n1, nullptr);                                                                                                                       \
@@ -2710,7 +2798,7 @@ namespace {
 
         if (since_last_check++ > 100) {
             since_last_check = 0;
-            if (m_context.resource_limits_exceeded()) {
+            if (limits_exceeded()) {
                 // Soft timeout...
                 // Cleanup before exiting
                 while (m_top != 0) {
@@ -2945,6 +3033,10 @@ namespace {
                 return nullptr;
         }
 
+        ptr_vector<code_tree> const & trees() const {
+            return m_trees;
+        }
+
         ptr_vector<code_tree>::iterator begin_code_trees() {
             return m_trees.begin();
         }
@@ -3095,6 +3187,18 @@ namespace {
         interpreter                 m_interpreter;
         code_tree_map               m_trees;
 
+        struct stats {
+            unsigned m_num_parallel_rounds { 0 };
+            unsigned m_max_threads { 0 };
+            double   m_match_time { 0 };
+            double   m_max_tree_time { 0 };
+        };
+        stats                       m_stats;
+        // interpreters of the worker threads used for parallel matching.
+        scoped_ptr_vector<interpreter> m_workers;
+        vector<match_buffer>        m_buffers;
+        mutex                       m_cg_mux;
+
         ptr_vector<code_tree>       m_tmp_trees;
         ptr_vector<func_decl>       m_tmp_trees_to_delete;
         ptr_vector<code_tree>       m_to_match;
@@ -3885,13 +3989,154 @@ namespace {
             }
         }
 
+        /**
+           \brief match the code trees in m_to_match on several threads.
+           The E-graph is not modified while matching. Each worker records the 
+           matches of a tree in its own buffer and the buffers are passed to the 
+           instantiation queue in the order of m_to_match, so the instances are 
+           the same, and are inserted in the same order, as when matching sequentially.
+           Return false if matching was interrupted by a resource limit.
+        */
+        bool parallel_match(unsigned num_threads) {
+#ifdef SINGLE_THREAD
+            UNREACHABLE();
+            return false;
+#else
+            unsigned num_trees = m_to_match.size();
+            m_buffers.reserve(num_trees);
+            // candidates are filtered before matching, so that workers do not set marks on enodes.
+            for (unsigned i = 0; i < num_trees; ++i) {
+                code_tree * t = m_to_match[i];
+                match_buffer & b = m_buffers[i];
+                b.m_candidates.reset();
+                b.m_records.reset();
+                b.m_bindings.reset();
+                b.m_used_enodes.reset();
+                b.m_time = 0;
+                b.m_completed = false;
+                for (enode * app : t->get_candidates()) {
+                    if (t->filter_candidates()) {
+                        if (app->is_marked() || !app->is_cgr())
+                            continue;
+                        app->set_mark();
+                    }
+                    else if (!app->is_cgr())
+                        continue;
+                    b.m_candidates.push_back(app);
+                }
+                if (t->filter_candidates())
+                    for (enode * app : b.m_candidates)
+                        app->unset_mark();
+            }
+            num_threads = std::min(num_threads, num_trees);
+            while (m_workers.size() < num_threads)
+                m_workers.push_back(alloc(interpreter, m_context, *this, m_use_filters));
+
+            std::atomic<unsigned> next(0);
+            std::string ex_msg;
+            bool has_exception = false;
+            auto worker = [&](unsigned id) {
+                interpreter & intr = *m_workers[id];
+                try {
+                    for (unsigned i = next++; i < num_trees; i = next++) {
+                        code_tree * t = m_to_match[i];
+                        match_buffer & b = m_buffers[i];
+                        stopwatch sw;
+                        sw.start();
+                        intr.set_buffer(&b, &m_cg_mux);
+                        intr.init(t);
+                        b.m_completed = true;
+                        for (enode * app : b.m_candidates) {
+                            if (m.limit().is_canceled() || !intr.execute_core(t, app)) {
+                                b.m_completed = false;
+                                break;
+                            }
+                        }
+                        sw.stop();
+                        b.m_time = sw.get_seconds();
+                    }
+                }
+                catch (z3_exception & ex) {
+                    lock_guard lock(m_cg_mux);
+                    ex_msg = ex.msg();
+                    has_exception = true;
+                }
+                intr.set_buffer(nullptr, nullptr);
+            };
+            vector<std::thread> threads;
+            for (unsigned id = 1; id < num_threads; ++id)
+                threads.push_back(std::thread([&, id]() { worker(id); }));
+            worker(0);
+            for (auto & th : threads)
+                th.join();
+            if (has_exception)
+                throw default_exception(std::move(ex_msg));
+
+            m_stats.m_num_parallel_rounds++;
+            m_stats.m_max_threads = std::max(m_stats.m_max_threads, num_threads);
+            for (unsigned i = 0; i < num_trees; ++i) {
+                code_tree * t = m_to_match[i];
+                match_buffer & b = m_buffers[i];
+                for (auto const & r : b.m_records)
+                    add_match(b, r);
+                t->add_match_time(b.m_time);
+                m_stats.m_match_time += b.m_time;
+                m_stats.m_max_tree_time = std::max(m_stats.m_max_tree_time, t->get_match_time());
+                if (!b.m_completed)
+                    return false;
+                t->reset_candidates();
+            }
+            return true;
+#endif
+        }
+
+        void add_match(match_buffer const & b, match_buffer::record const & r) {
+            vector<std::tuple<enode *, enode *>> used_enodes;
+            for (unsigned i = 0; i < r.m_num_used_enodes; ++i)
+                used_enodes.push_back(b.m_used_enodes[r.m_used_enodes + i]);
+            m_context.add_instance(r.m_qa, r.m_pat, r.m_num_bindings, b.m_bindings.data() + r.m_bindings, nullptr, 
+                                   r.m_max_generation, r.m_min_top_generation, r.m_max_top_generation, used_enodes);
+        }
+
+        unsigned num_match_threads() const {
+#if defined(SINGLE_THREAD) || defined(_PROFILE_MAM)
+            return 1;
+#else
+            unsigned num_threads = m_context.get_fparams().m_ematching_threads;
+            if (num_threads <= 1 || m_to_match.size() < 2)
+                return 1;
+            DEBUG_CODE(if (m_check_missing_instances) return 1;);
+            unsigned num_candidates = 0;
+            for (code_tree * t : m_to_match)
+                num_candidates += t->get_candidates().size();
+            // small rounds are not worth the cost of starting threads.
+            if (num_candidates < 64)
+                return 1;
+            return num_threads;
+#endif
+        }
+
         void match() override {
             TRACE("trigger_bug", tout << "match\n"; display(tout););
-            for (code_tree* t : m_to_match) {
-                SASSERT(t->has_candidates());
-                if (!m_interpreter.execute(t))
+            unsigned num_threads = num_match_threads();
+            if (num_threads > 1) {
+                if (!parallel_match(num_threads))
                     return;
-                t->reset_candidates();
+            }
+            else {
+                for (code_tree* t : m_to_match) {
+                    SASSERT(t->has_candidates());
+                    stopwatch sw;
+                    sw.start();
+                    bool ok = m_interpreter.execute(t);
+                    sw.stop();
+                    t->add_match_time(sw.get_seconds());
+                    m_stats.m_match_time += sw.get_seconds();
+                    m_stats.m_max_tree_time = std::max(m_stats.m_max_tree_time, t->get_match_time());
+                    if (!ok)
+                        return;
+                    t->reset_candidates();
+                }
             }
             m_to_match.reset();
             if (!m_new_patterns.empty()) {
@@ -3953,6 +4198,19 @@ namespace {
             return !m_shared_enodes.empty() && m_shared_enodes.contains(n);
         }
 
+        void collect_profile(q::quantifier_profile & p) const override {
+            for (code_tree const * t : m_trees.trees())
+                if (t)
+                    p.add_match_time(t->get_root_lbl(), t->get_match_time());
+        }
+
+        void collect_statistics(::statistics & st) const override {
+            st.update("mam parallel rounds", m_stats.m_num_parallel_rounds);
+            st.update("mam threads", m_stats.m_max_threads);
+            st.update("mam match time", m_stats.m_match_time);
+            st.update("mam max tree match time", m_stats.m_max_tree_time);
+        }
+
         // This method is invoked when n becomes relevant.
         // If lazy == true, then n is not added to the list of candidate enodes for matching. That is, the method just updates the lbls.
         void relevant_eh(enode * n, bool lazy) override {
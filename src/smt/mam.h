@@ -19,7 +19,9 @@ Revision History:
 #pragma once
 
 #include "ast/ast.h"
+#include "ast/quantifier_profile.h"
 #include "smt/smt_types.h"
+#include "util/statistics.h"
 #include <tuple>
 
 namespace smt {
@@ -63,6 +65,10 @@ namespace smt {
         
         virtual bool is_shared(enode * n) const = 0;
 
+        virtual void collect_statistics(::statistics & st) const {}
+
+        virtual void collect_profile(q::quantifier_profile & p) const {}
+
 #ifdef Z3DEBUG
         virtual bool check_missing_instances() = 0;
 #endif
@@ -31,6 +31,8 @@ void qi_params::updt_params(params_ref const & _p) {
     m_qe_lite = p.q_lite();
     m_qi_profile = p.qi_profile();
     m_qi_profile_freq = p.qi_profile_freq();
+    m_qi_profile_file = p.qi_profile_file();
+    m_qi_profile_loop_generation = p.qi_profile_loop_generation();
     m_qi_max_instances = p.qi_max_instances();
     m_qi_eager_threshold = p.qi_eager_threshold();
     m_qi_lazy_threshold = p.qi_lazy_threshold();
@@ -50,6 +52,8 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_qi_max_lazy_multipattern_matching);
     DISPLAY_PARAM(m_qi_profile);
     DISPLAY_PARAM(m_qi_profile_freq);
+    DISPLAY_PARAM(m_qi_profile_file);
+    DISPLAY_PARAM(m_qi_profile_loop_generation);
     DISPLAY_PARAM(m_qi_quick_checker);
     DISPLAY_PARAM(m_qi_lazy_quick_checker);
     DISPLAY_PARAM(m_qi_promote_unsat);
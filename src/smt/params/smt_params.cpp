@@ -27,6 +27,7 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_random_seed = p.random_seed();
     m_relevancy_lvl = p.relevancy();
     m_ematching   = p.ematching();
+    m_ematching_threads = p.ematching_threads();
     m_induction   = p.induction();
     m_clause_proof = p.clause_proof();
     m_phase_selection = static_cast<phase_selection>(p.phase_selection());
@@ -48,6 +49,11 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_threads       = p.threads();
     m_threads_max_conflicts  = p.threads_max_conflicts();
     m_threads_cube_frequency = p.threads_cube_frequency();
+    m_threads_share_max_size = p.threads_share_max_size();
+    m_threads_share_max_glue = p.threads_share_max_glue();
+    m_lazy_internalize = p.lazy_internalize();
+    m_retain_theory_lemmas = p.retain_theory_lemmas();
+    m_lemma_strengthening = p.lemma_strengthening();
     m_core_validate = p.core_validate();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
@@ -115,16 +121,22 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_phase_caching_on);
     DISPLAY_PARAM(m_phase_caching_off);
     DISPLAY_PARAM(m_minimize_lemmas);
+    DISPLAY_PARAM(m_lemma_strengthening);
     DISPLAY_PARAM(m_max_conflicts);
     DISPLAY_PARAM(m_cube_depth);
     DISPLAY_PARAM(m_threads);
     DISPLAY_PARAM(m_threads_max_conflicts);
     DISPLAY_PARAM(m_threads_cube_frequency);
+    DISPLAY_PARAM(m_threads_share_max_size);
+    DISPLAY_PARAM(m_threads_share_max_glue);
+    DISPLAY_PARAM(m_lazy_internalize);
+    DISPLAY_PARAM(m_retain_theory_lemmas);
     DISPLAY_PARAM(m_simplify_clauses);
     DISPLAY_PARAM(m_tick);
     DISPLAY_PARAM(m_display_features);
     DISPLAY_PARAM(m_new_core2th_eq);
     DISPLAY_PARAM(m_ematching);
+    DISPLAY_PARAM(m_ematching_threads);
     DISPLAY_PARAM(m_induction);
     DISPLAY_PARAM(m_clause_proof);
     DISPLAY_PARAM(m_proof_log);
@@ -70,7 +70,8 @@ enum case_split_strategy {
     CS_RELEVANCY, // case split based on relevancy
     CS_RELEVANCY_ACTIVITY, // case split based on relevancy and activity
     CS_RELEVANCY_GOAL, // based on relevancy and the current goal
-    CS_ACTIVITY_THEORY_AWARE_BRANCHING // activity-based case split, but theory solvers can manipulate activity
+    CS_ACTIVITY_THEORY_AWARE_BRANCHING, // activity-based case split, but theory solvers can manipulate activity
+    CS_VMTF // case split on the most recently bumped variable (variable move-to-front)
 };
 
 struct smt_params : public preprocessor_params,
@@ -100,17 +101,23 @@ struct smt_params : public preprocessor_params,
     unsigned         m_phase_caching_on = 700;
     unsigned         m_phase_caching_off = 100;
     bool             m_minimize_lemmas = true;
+    bool             m_lemma_strengthening = false;
     unsigned         m_max_conflicts = UINT_MAX;
     unsigned         m_restart_max;
     unsigned         m_cube_depth = 1;
     unsigned         m_threads = 1;
     unsigned         m_threads_max_conflicts = UINT_MAX;
     unsigned         m_threads_cube_frequency = 2;
+    unsigned         m_threads_share_max_size = 8;
+    unsigned         m_threads_share_max_glue = 4;
+    bool             m_lazy_internalize = false;
+    bool             m_retain_theory_lemmas = false;
     bool             m_simplify_clauses = true;
     unsigned         m_tick = 1000;
     bool             m_display_features = false;
     bool             m_new_core2th_eq = true;
     bool             m_ematching = true;
+    unsigned         m_ematching_threads = 1;
     bool             m_induction = false;
     bool             m_clause_proof = false;
     symbol           m_proof_log;
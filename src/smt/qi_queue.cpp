@@ -145,7 +145,7 @@ namespace smt {
               }
               tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        m_new_entries.push_back(entry(f, pat, cost, generation));
     }
 
     void qi_queue::instantiate() {
@@ -194,6 +194,33 @@ namespace smt {
     }
 
     void qi_queue::instantiate(entry & ent) {
+        if (!m_profile) {
+            if (m_params.m_qi_profile_file.empty()) {
+                instantiate_core(ent);
+                return;
+            }
+            m_profile = alloc(q::quantifier_profile, m, m_params.m_qi_profile_loop_generation);
+        }
+        fingerprint * f = ent.m_qb;
+        m_profile->start_instance(m_profile->get_trigger(static_cast<quantifier*>(f->get_data()), ent.m_pat));
+        for (unsigned i = 0; i < f->get_num_args(); ++i)
+            m_profile->add_binding(f->get_arg(i)->get_expr());
+        unsigned num_enodes = m_context.enodes().size();
+        unsigned num_vars   = m_context.get_num_bool_vars();
+        bool instantiated   = instantiate_core(ent);
+        for (unsigned i = num_enodes; i < m_context.enodes().size(); ++i) {
+            enode * n = m_context.enodes()[i];
+            m_profile->add_term(n->get_expr(), n->get_generation());
+        }
+        for (unsigned v = num_vars; v < m_context.get_num_bool_vars(); ++v)
+            m_profile->add_var(v);
+        m_profile->end_instance(instantiated);
+    }
+
+    /**
+       \brief create the instance of ent. Return false if the instance is redundant.
+    */
+    bool qi_queue::instantiate_core(entry & ent) {
         // set temporary flag to enable quantifier-specific tracing in within smt_internalizer.
         flet<bool> _coming_from_quant(m_context.m_coming_from_quant, true);
 
@@ -217,7 +244,7 @@ namespace smt {
             // a dummy instantiation is still an instantiation.
             // in this way smt.qi.profile=true coincides with the axiom profiler
             stat->inc_num_instances_checker_sat();
-            return;
+            return false;
         }
 
         STRACE("instance", tout << "### " << static_cast<void*>(f) <<", " << q->get_qid()  << "\n";);
@@ -242,7 +269,7 @@ namespace smt {
                 m.trace_stream() << "[end-of-instance]\n";
             }
 
-            return;
+            return false;
         }
 #if 0
         std::cout << "instantiate\n";
@@ -353,7 +380,7 @@ namespace smt {
 
         if (m.has_trace_stream())
             m.trace_stream() << "[end-of-instance]\n";
-
+        return true;
     }
 
     void qi_queue::push_scope() {
@@ -364,6 +391,8 @@ namespace smt {
         s.m_delayed_entries_lim    = m_delayed_entries.size();
         s.m_instances_lim          = m_instances.size();
         s.m_instantiated_trail_lim = m_instantiated_trail.size();
+        s.m_num_bool_vars          = m_context.get_num_bool_vars();
+        s.m_num_profile_terms      = m_profile ? m_profile->num_terms() : 0;
     }
 
     void qi_queue::pop_scope(unsigned num_scopes) {
@@ -376,6 +405,10 @@ namespace smt {
         m_instantiated_trail.shrink(old_sz);
         m_delayed_entries.shrink(s.m_delayed_entries_lim);
         m_instances.shrink(s.m_instances_lim);
+        if (m_profile) {
+            m_profile->shrink_vars(s.m_num_bool_vars);
+            m_profile->shrink_terms(s.m_num_profile_terms);
+        }
         m_new_entries.reset();
         m_scopes.shrink(new_lvl);
         TRACE("new_entries_bug", tout << "[qi:pop-scope]\n";);
@@ -496,6 +529,19 @@ namespace smt {
         }
     }
 
+    void qi_queue::conflict_eh(unsigned num_lits, literal const * lits) {
+        if (!m_profile)
+            return;
+        m_profile->begin_conflict();
+        for (unsigned i = 0; i < num_lits; ++i)
+            m_profile->add_conflict_var(lits[i].var());
+    }
+
+    void qi_queue::write_profile() {
+        if (m_profile)
+            m_profile->write(m_params.m_qi_profile_file);
+    }
+
     void qi_queue::collect_statistics(::statistics & st) const {
         st.update("quant instantiations", m_stats.m_num_instances);
         st.update("lazy quant instantiations", m_stats.m_num_lazy_instances);
@@ -19,6 +19,7 @@ Revision History:
 #pragma once
 
 #include "ast/ast.h"
+#include "ast/quantifier_profile.h"
 #include "ast/quantifier_stat.h"
 #include "ast/rewriter/cached_var_subst.h"
 #include "parsers/util/cost_parser.h"
@@ -54,10 +55,11 @@ namespace smt {
         double                        m_eager_cost_threshold;
         struct entry {
             fingerprint * m_qb;
+            app *         m_pat;
             float         m_cost;
             unsigned      m_generation:31;
             unsigned      m_instantiated:1;
-            entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
+            entry(fingerprint * f, app * pat, float c, unsigned g):m_qb(f), m_pat(pat), m_cost(c), m_generation(g), m_instantiated(false) {}
         };
         svector<entry>                m_new_entries;
         svector<entry>                m_delayed_entries;
@@ -67,14 +69,18 @@ namespace smt {
             unsigned   m_delayed_entries_lim;
             unsigned   m_instances_lim;
             unsigned   m_instantiated_trail_lim;
+            unsigned   m_num_bool_vars;
+            unsigned   m_num_profile_terms;
         };
         svector<scope>                m_scopes;
+        scoped_ptr<q::quantifier_profile> m_profile;
 
         void init_parser_vars();
         q::quantifier_stat * set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
         float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
         unsigned get_new_gen(quantifier * q, unsigned generation, float cost);
         void instantiate(entry & ent);
+        bool instantiate_core(entry & ent);
         void get_min_max_costs(float & min, float & max) const;
         void display_instance_profile(fingerprint * f, quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned proof_id, unsigned generation);
 
@@ -96,6 +102,9 @@ namespace smt {
         void reset();
         void display_delayed_instances_stats(std::ostream & out) const;
         void collect_statistics(::statistics & st) const;
+        q::quantifier_profile * get_profile() { return m_profile.get(); }
+        void conflict_eh(unsigned num_lits, literal const * lits);
+        void write_profile();
     };
 };
 
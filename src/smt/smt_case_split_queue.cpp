@@ -1245,6 +1245,143 @@ namespace {
     };
 }
 
+namespace {
+
+    /**
+       \brief Case split queue based on variable move-to-front.
+
+       Variables are kept in a doubly linked list ordered by the time they were
+       last bumped. Bumping moves a variable to the end of the list, and case
+       splits are taken from the most recently bumped unassigned variable. The
+       search position only moves towards the front of the list, except when
+       a more recent variable is unassigned, so all operations are constant
+       time, except for skipping assigned variables, which is amortized.
+    */
+    class vmtf_case_split_queue : public case_split_queue {
+        struct link {
+            bool_var m_prev { null_bool_var };
+            bool_var m_next { null_bool_var };
+            uint64_t m_stamp { 0 };
+            bool     m_in_queue { false };
+        };
+        context &     m_context;
+        smt_params &  m_params;
+        svector<link> m_links;
+        bool_var      m_head { null_bool_var };   // least recently bumped
+        bool_var      m_tail { null_bool_var };   // most recently bumped
+        bool_var      m_search { null_bool_var }; // variables after m_search are assigned
+        uint64_t      m_stamp { 0 };
+
+        void unlink(bool_var v) {
+            link & l = m_links[v];
+            if (l.m_prev != null_bool_var)
+                m_links[l.m_prev].m_next = l.m_next;
+            else
+                m_head = l.m_next;
+            if (l.m_next != null_bool_var)
+                m_links[l.m_next].m_prev = l.m_prev;
+            else
+                m_tail = l.m_prev;
+            if (m_search == v)
+                m_search = l.m_prev;
+            l.m_prev = l.m_next = null_bool_var;
+            l.m_in_queue = false;
+        }
+
+        void enqueue(bool_var v) {
+            link & l = m_links[v];
+            SASSERT(!l.m_in_queue);
+            l.m_prev = m_tail;
+            l.m_next = null_bool_var;
+            l.m_stamp = ++m_stamp;
+            l.m_in_queue = true;
+            if (m_tail != null_bool_var)
+                m_links[m_tail].m_next = v;
+            else
+                m_head = v;
+            m_tail = v;
+            if (m_context.get_assignment(v) == l_undef)
+                m_search = v;
+        }
+
+    public:
+        vmtf_case_split_queue(context & ctx, smt_params & p):
+            m_context(ctx),
+            m_params(p) {
+        }
+
+        void activity_increased_eh(bool_var v) override {
+            if (v == m_tail || !m_links[v].m_in_queue)
+                return;
+            unlink(v);
+            enqueue(v);
+        }
+
+        void activity_decreased_eh(bool_var v) override {}
+
+        void mk_var_eh(bool_var v) override {
+            if (v >= m_links.size())
+                m_links.resize(v + 1);
+            enqueue(v);
+        }
+
+        void del_var_eh(bool_var v) override {
+            if (v < m_links.size() && m_links[v].m_in_queue)
+                unlink(v);
+        }
+
+        void unassign_var_eh(bool_var v) override {
+            if (m_search == null_bool_var || m_links[v].m_stamp > m_links[m_search].m_stamp)
+                m_search = v;
+        }
+
+        void relevant_eh(expr * n) override {}
+
+        void init_search_eh() override {}
+
+        void end_search_eh() override {}
+
+        void reset() override {
+            m_links.reset();
+            m_head = m_tail = m_search = null_bool_var;
+            m_stamp = 0;
+        }
+
+        void push_scope() override {}
+
+        void pop_scope(unsigned num_scopes) override {}
+
+        void next_case_split(bool_var & next, lbool & phase) override {
+            phase = l_undef;
+
+            if (m_context.get_random_value() < static_cast<int>(m_params.m_random_var_freq * random_gen::max_value())) {
+                next = m_context.get_random_value() % m_context.get_num_b_internalized(); 
+                if (m_context.get_assignment(next) == l_undef)
+                    return;
+            }
+
+            while (m_search != null_bool_var && m_context.get_assignment(m_search) != l_undef)
+                m_search = m_links[m_search].m_prev;
+            next = m_search;
+        }
+
+        void display(std::ostream & out) override {
+            bool first = true;
+            for (bool_var v = m_tail; v != null_bool_var; v = m_links[v].m_prev) {
+                if (m_context.get_assignment(v) == l_undef) {
+                    if (first) {
+                        out << "remaining case-splits:\n";
+                        first = false;
+                    }
+                    out << "#" << m_context.bool_var2expr(v)->get_id() << " ";
+                }
+            }
+            if (!first)
+                out << "\n";
+        }
+    };
+}
+
 namespace smt {
     case_split_queue * mk_case_split_queue(context & ctx, smt_params & p) {
         if (ctx.relevancy_lvl() < 2 && (p.m_case_split_strategy == CS_RELEVANCY || p.m_case_split_strategy == CS_RELEVANCY_ACTIVITY || 
@@ -1270,6 +1407,8 @@ namespace smt {
             return alloc(rel_goal_case_split_queue, ctx, p);
         case CS_ACTIVITY_THEORY_AWARE_BRANCHING:
             return alloc(theory_aware_branching_queue, ctx, p);
+        case CS_VMTF:
+            return alloc(vmtf_case_split_queue, ctx, p);
         default:
             return alloc(act_case_split_queue, ctx, p);
         }
@@ -51,8 +51,72 @@ namespace smt {
         return c;
     }
 
-    bool cg_table::cg_eq::operator()(enode * n1, enode * n2) const {
+    /**
+       \brief cg_hash for the four applications ns with num_args arguments. 
+       The Jenkins mix is applied to the four lanes in lockstep, so the lane
+       loops compile to vector instructions.
+    */
+    static void cg_hash4(enode * const * ns, unsigned num_args, unsigned * hashes) {
+        unsigned a[4], b[4], c[4];
+        for (unsigned k = 0; k < 4; ++k) {
+            a[k] = b[k] = 0x9e3779b9;
+            c[k] = 11;
+        }
+        unsigned i = num_args;
+        while (i >= 3) {
+            i--;
+            for (unsigned k = 0; k < 4; ++k)
+                a[k] += ns[k]->get_arg(i)->get_root()->hash();
+            i--;
+            for (unsigned k = 0; k < 4; ++k)
+                b[k] += ns[k]->get_arg(i)->get_root()->hash();
+            i--;
+            for (unsigned k = 0; k < 4; ++k)
+                c[k] += ns[k]->get_arg(i)->get_root()->hash();
+            for (unsigned k = 0; k < 4; ++k)
+                mix(a[k], b[k], c[k]);
+        }
+        switch (i) {
+        case 2:
+            for (unsigned k = 0; k < 4; ++k)
+                b[k] += ns[k]->get_arg(1)->get_root()->hash();
+            Z3_fallthrough;
+        case 1:
+            for (unsigned k = 0; k < 4; ++k)
+                c[k] += ns[k]->get_arg(0)->get_root()->hash();
+        }
+        for (unsigned k = 0; k < 4; ++k) {
+            mix(a[k], b[k], c[k]);
+            hashes[k] = c[k];
+        }
+    }
+
+    void cg_table::mk_hashes(unsigned sz, enode * const * ns, unsigned * hashes) {
+        unsigned i = 0;
+        while (i < sz) {
+            enode * n = ns[i];
+            void * t = get_table(n);
+            unsigned num_args = n->get_num_args();
+            bool batch = GET_TAG(t) == NARY && i + 4 <= sz;
+            for (unsigned k = 1; batch && k < 4; ++k)
+                batch = ns[i + k]->get_num_args() == num_args && GET_TAG(get_table(ns[i + k])) == NARY;
+            if (batch) {
+                cg_hash4(ns + i, num_args, hashes + i);
+                SASSERT(hashes[i] == cg_hash()(n));
+                i += 4;
+            }
+            else {
+                hashes[i] = mk_entry(n, t).m_hash;
+                ++i;
+            }
+        }
+    }
+
+    bool cg_table::cg_eq::operator()(cg_entry const & e1, cg_entry const & e2) const {
+        enode * n1 = e1.m_node, * n2 = e2.m_node;
         SASSERT(n1->get_decl() == n2->get_decl());
+        if (e1.m_hash != e2.m_hash)
+            return false;
         unsigned num = n1->get_num_args();
         if (num != n2->get_num_args()) {
             return false;
@@ -87,7 +151,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table, cg_entry_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -170,8 +234,8 @@ namespace smt {
     void cg_table::display_binary(std::ostream& out, void* t) const {
         binary_table* tb = UNTAG(binary_table*, t);
         out << "b ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " " << cg_binary_hash()(n) << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " " << e.m_hash << " ";
         }
         out << "\n";
     }
@@ -179,8 +243,8 @@ namespace smt {
     void cg_table::display_binary_comm(std::ostream& out, void* t) const {
         comm_table* tb = UNTAG(comm_table*, t);
         out << "bc ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -188,8 +252,8 @@ namespace smt {
     void cg_table::display_unary(std::ostream& out, void* t) const {
         unary_table* tb = UNTAG(unary_table*, t);
         out << "un ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -197,35 +261,37 @@ namespace smt {
     void cg_table::display_nary(std::ostream& out, void* t) const {
         table* tb = UNTAG(table*, t);
         out << "nary ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
 
 
-    enode_bool_pair cg_table::insert(enode * n) {
+    enode_bool_pair cg_table::insert(enode * n, unsigned h) {
         // it doesn't make sense to insert a constant.
         SASSERT(n->get_num_args() > 0);
         SASSERT(!m_manager.is_and(n->get_expr()));
         SASSERT(!m_manager.is_or(n->get_expr()));
         enode * n_prime;
         void * t = get_table(n); 
+        cg_entry e(n, h);
+        SASSERT(h == mk_entry(n, t).m_hash);
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(e).m_node;
             return enode_bool_pair(n_prime, false);
         case BINARY:
-            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
-            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
+            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(e).m_node;
+            TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << e.m_hash << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
                   display_binary(tout, t); tout << "contains_ptr: " << contains_ptr(n) << "\n";); 
             return enode_bool_pair(n_prime, false);
         case BINARY_COMM:
             m_commutativity = false;
-            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(e).m_node;
             return enode_bool_pair(n_prime, m_commutativity);
         default:
-            n_prime = UNTAG(table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(table*, t)->insert_if_not_there(e).m_node;
             return enode_bool_pair(n_prime, false);
         }
     }
@@ -233,19 +299,20 @@ namespace smt {
     void cg_table::erase(enode * n) {
         SASSERT(n->get_num_args() > 0);
         void * t = get_table(n); 
+        cg_entry e = mk_entry(n, t);
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            UNTAG(unary_table*, t)->erase(n);
+            UNTAG(unary_table*, t)->erase(e);
             break;
         case BINARY:
-            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " contains: " << contains_ptr(n) << "\n";);
-            UNTAG(binary_table*, t)->erase(n);
+            TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << e.m_hash << " contains: " << contains_ptr(n) << "\n";);
+            UNTAG(binary_table*, t)->erase(e);
             break;
         case BINARY_COMM:
-            UNTAG(comm_table*, t)->erase(n);
+            UNTAG(comm_table*, t)->erase(e);
             break;
         default:
-            UNTAG(table*, t)->erase(n);
+            UNTAG(table*, t)->erase(e);
             break;
         }
     }
@@ -30,8 +30,26 @@ namespace smt {
 
     /**
        \brief Congruence table.
+
+       The entries of the tables store the hash of the application, computed from
+       the roots of its arguments when it is inserted. Parents are removed from the
+       table before their arguments are merged and reinserted afterwards, so the roots
+       of the arguments of an application in the table do not change and the stored
+       hash remains valid. Lookups reject entries with a different hash and tables
+       are grown without accessing the enodes.
     */
     class cg_table {
+        struct cg_entry {
+            enode *  m_node { nullptr };
+            unsigned m_hash { 0 };
+            cg_entry() {}
+            cg_entry(enode * n, unsigned h): m_node(n), m_hash(h) {}
+        };
+
+        struct cg_entry_hash {
+            unsigned operator()(cg_entry const & e) const { return e.m_hash; }
+        };
+
         struct cg_unary_hash {
             unsigned operator()(enode * n) const {
                 SASSERT(n->get_num_args() == 1);
@@ -40,15 +58,16 @@ namespace smt {
         };
 
         struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 1);
                 SASSERT(n2->get_num_args() == 1);
                 SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
+                return e1.m_hash == e2.m_hash && n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
             }
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_unary_eq> unary_table;
         
         struct cg_binary_hash {
             unsigned operator()(enode * n) const {
@@ -58,17 +77,19 @@ namespace smt {
         };
 
         struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 2);
                 SASSERT(n2->get_num_args() == 2);
                 SASSERT(n1->get_decl() == n2->get_decl());
                 return 
+                    e1.m_hash == e2.m_hash &&
                     n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
                     n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
             }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_binary_eq> binary_table;
         
         struct cg_comm_hash {
             unsigned operator()(enode * n) const {
@@ -84,10 +105,13 @@ namespace smt {
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 2);
                 SASSERT(n2->get_num_args() == 2);
                 SASSERT(n1->get_decl() == n2->get_decl());
+                if (e1.m_hash != e2.m_hash)
+                    return false;
                 enode * c1_1 = n1->get_arg(0)->get_root();
                 enode * c1_2 = n1->get_arg(1)->get_root();
                 enode * c2_1 = n2->get_arg(0)->get_root();
@@ -103,17 +127,17 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_comm_eq> comm_table;
 
         struct cg_hash {
             unsigned operator()(enode * n) const;
         };
 
         struct cg_eq {
-            bool operator()(enode * n1, enode * n2) const;
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const;
         };
 
-        typedef chashtable<enode*, cg_hash, cg_eq> table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_eq> table;
 
         ast_manager &                 m_manager;
         bool                          m_commutativity; //!< true if the last found congruence used commutativity
@@ -138,6 +162,33 @@ namespace smt {
             return m_tables[tid];
         }
 
+        static cg_entry mk_entry(enode * n, void * t) {
+            switch (static_cast<table_kind>(GET_TAG(t))) {
+            case UNARY:
+                return cg_entry(n, cg_unary_hash()(n));
+            case BINARY:
+                return cg_entry(n, cg_binary_hash()(n));
+            case BINARY_COMM:
+                return cg_entry(n, cg_comm_hash()(n));
+            default:
+                return cg_entry(n, cg_hash()(n));
+            }
+        }
+
+        static cg_entry const * find_core(enode * n, void * t) {
+            cg_entry e = mk_entry(n, t);
+            switch (static_cast<table_kind>(GET_TAG(t))) {
+            case UNARY:
+                return UNTAG(unary_table*, t)->find_core(e);
+            case BINARY:
+                return UNTAG(binary_table*, t)->find_core(e);
+            case BINARY_COMM:
+                return UNTAG(comm_table*, t)->find_core(e);
+            default:
+                return UNTAG(table*, t)->find_core(e);
+            }
+        }
+
     public:
         cg_table(ast_manager & m);
         ~cg_table();
@@ -148,55 +199,55 @@ namespace smt {
            return n' and a boolean indicating whether n and n' are congruence
            modulo commutativity, otherwise insert n and return (n,false).
         */
-        enode_bool_pair insert(enode * n);
+        enode_bool_pair insert(enode * n) { return insert(n, hash(n)); }
+
+        /**
+           \brief insert n with its hash h, computed by hash or mk_hashes.
+        */
+        enode_bool_pair insert(enode * n, unsigned h);
 
         void erase(enode * n);
 
+        /**
+           \brief the hash of n from the roots of its arguments.
+        */
+        unsigned hash(enode * n) { return mk_entry(n, get_table(n)).m_hash; }
+
+        /**
+           \brief store the hashes of the sz applications ns in hashes.
+           Runs of four n-ary applications with the same number of arguments
+           are hashed together, one lane per application.
+        */
+        void mk_hashes(unsigned sz, enode * const * ns, unsigned * hashes);
+
         bool contains(enode * n) const {
             SASSERT(n->get_num_args() > 0);
             void * t = const_cast<cg_table*>(this)->get_table(n); 
+            cg_entry e = mk_entry(n, t);
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
+                return UNTAG(unary_table*, t)->contains(e);
             case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
+                return UNTAG(binary_table*, t)->contains(e);
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
+                return UNTAG(comm_table*, t)->contains(e);
             default:
-                return UNTAG(table*, t)->contains(n);
+                return UNTAG(table*, t)->contains(e);
             }
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = nullptr;
             void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : nullptr;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : nullptr;
-            default:
-                return UNTAG(table*, t)->find(n, r) ? r : nullptr;
-            }
+            cg_entry const * r = find_core(n, t);
+            return r ? r->m_node : nullptr;
         }
 
         bool contains_ptr(enode * n) const {
-            enode * r;
             SASSERT(n->get_num_args() > 0);
             void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
-            default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
-            }
+            cg_entry const * r = find_core(n, t);
+            return r && r->m_node == n;
         }
 
         void reset();
@@ -390,6 +390,7 @@ namespace smt {
         TRACE("conflict_detail", m_ctx.display(tout););
         m_lemma.reset();
         m_lemma_atoms.reset();
+        m_otfs.reset();
         SASSERT(m_ctx.get_search_level() >= m_ctx.get_base_level());
         js                  = conflict;
         consequent          = false_literal;
@@ -447,9 +448,18 @@ namespace smt {
 
         TRACE("conflict_verbose",m_ctx.display_literals_verbose(tout << "before minimization:\n", m_lemma) << "\n";);
 
+        unsigned initial_size = m_lemma.size();
+
         if (m_params.m_minimize_lemmas)
             minimize_lemma();
 
+        if (m_params.m_lemma_strengthening && !m.proofs_enabled())
+            minimize_lemma_binres();
+
+        m_ctx.m_stats.m_num_learned++;
+        m_ctx.m_stats.m_num_learned_lits_initial += initial_size;
+        m_ctx.m_stats.m_num_learned_lits += m_lemma.size();
+
         TRACE("conflict", m_ctx.display_literals(tout << "after minimization:\n", m_lemma) << "\n";);
         TRACE("conflict_verbose", m_ctx.display_literals_verbose(tout << "after minimization:\n", m_lemma) << "\n";);
         TRACE("conflict_bug", m_ctx.display_literals_verbose(tout, m_lemma) << "\n";);
@@ -545,6 +555,8 @@ namespace smt {
                 justification * js = cls->get_justification();
                 if (js)
                     process_justification(consequent, js, num_marks);
+                else if (consequent != false_literal)
+                    check_otfs(cls, consequent, num_marks);
                 break;
             }
             case b_justification::BIN_CLAUSE:
@@ -766,6 +778,71 @@ namespace smt {
         TRACE("conflict", tout << "lemma: " << m_lemma << "\n";);
     }
 
+    /**
+       \brief Remove the literals ~l of m_lemma such that (m_lemma[0] or l) is a binary clause.
+       The resolvent of m_lemma and the binary clause on l is m_lemma minus ~l.
+
+       \warning This method assumes the literals in m_lemma[1] ... m_lemma[m_lemma.size() - 1] are marked,
+       the removed literals are unmarked.
+    */
+    void conflict_resolution::minimize_lemma_binres() {
+        literal uip = m_lemma[0];
+        watch_list & wl = m_watches[(~uip).index()];
+        unsigned num_reduced = 0;
+        for (literal * it = wl.begin_literals(), * end = wl.end_literals(); it != end; ++it) {
+            literal l = *it;
+            // the literals of m_lemma are false, so ~l is in m_lemma when l is true and its variable is marked.
+            if (m_ctx.is_marked(l.var()) && m_ctx.get_assignment(l) == l_true) {
+                m_ctx.unset_mark(l.var());
+                ++num_reduced;
+            }
+        }
+        if (num_reduced == 0)
+            return;
+        unsigned sz = m_lemma.size();
+        unsigned j  = 1;
+        for (unsigned i = 1; i < sz; i++) {
+            if (m_ctx.is_marked(m_lemma[i].var())) {
+                if (j != i) {
+                    m_lemma[j] = m_lemma[i];
+                    m_lemma_atoms.set(j, m_lemma_atoms.get(i));
+                }
+                j++;
+            }
+        }
+        m_lemma      .shrink(j);
+        m_lemma_atoms.shrink(j);
+        m_ctx.m_stats.m_num_binres_lits += num_reduced;
+        TRACE("conflict", tout << "binres lemma: " << m_lemma << "\n";);
+    }
+
+    /**
+       \brief The learned clause cls justifies consequent, and its other literals were just resolved.
+       If every literal of cls, other than consequent, that is not assigned at the base level is in
+       the resolvent, then the resolvent subsumes cls minus consequent, and consequent can be removed
+       from cls. The clause is strengthened after backjumping, see context::resolve_conflict.
+
+       Only learned clauses without atoms, justifications or delete handlers are strengthened.
+    */
+    void conflict_resolution::check_otfs(clause * cls, literal consequent, unsigned num_marks) {
+        if (!m_params.m_lemma_strengthening ||
+            m.proofs_enabled() ||
+            !cls->is_learned() ||
+            cls->get_num_literals() <= 3 ||
+            cls->in_reinit_stack() ||
+            cls->reinternalize_atoms() ||
+            cls->get_del_eh())
+            return;
+        unsigned base_lvl = m_ctx.get_base_level();
+        unsigned num_lits = 0;
+        for (literal l : *cls)
+            if (l != consequent && m_ctx.get_assign_level(l) > base_lvl)
+                ++num_lits;
+        // m_lemma[0] is reserved for the first uip
+        if (num_lits == num_marks + m_lemma.size() - 1)
+            m_otfs.push_back(std::make_pair(cls, consequent));
+    }
+
     /**
        \brief Return the proof object associated with the equality (= n1 n2)
        if it already exists. Otherwise, return 0 and add p to the todo-list.
@@ -189,6 +189,11 @@ namespace smt {
         bool process_justification_for_minimization(justification * js);
         bool implied_by_marked(literal lit);
         void minimize_lemma();
+        void minimize_lemma_binres();
+
+        // learned clauses that are strengthened by removing the literal (on-the-fly subsumption)
+        svector<std::pair<clause*, literal>> m_otfs;
+        void check_otfs(clause * cls, literal consequent, unsigned num_marks);
 
         void structural_minimization();
 
@@ -243,6 +248,14 @@ namespace smt {
         void release_lemma_atoms() {
             m_lemma_atoms.reset();
         }
+
+        /**
+           \brief Return the learned clauses found by the last call to resolve() that
+           are subsumed by a resolvent, paired with the literal to remove from them.
+        */
+        svector<std::pair<clause*, literal>> const & get_otfs_clauses() const {
+            return m_otfs;
+        }
         
         proof * get_lemma_proof() {
             return m_lemma_proof;
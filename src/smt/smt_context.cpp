@@ -29,6 +29,7 @@ Revision History:
 #include "ast/proofs/proof_checker.h"
 #include "ast/ast_util.h"
 #include "ast/well_sorted.h"
+#include "ast/for_each_expr.h"
 #include "model/model_params.hpp"
 #include "model/model.h"
 #include "model/model_pp.h"
@@ -64,10 +65,11 @@ namespace smt {
         m_progress_callback(nullptr),
         m_next_progress_sample(0),
         m_clause_proof(*this),
-        m_fingerprints(m, m_region),
+        m_fingerprints(m),
         m_b_internalized_stack(m),
         m_e_internalized_stack(m),
         m_l_internalized_stack(m),
+        m_lazy_assertions(m),
         m_final_check_idx(0),
         m_cg_table(m),
         m_units_to_reassert(m),
@@ -621,6 +623,7 @@ namespace smt {
         enode_vector & r2_parents  = r2->m_parents;
         enode_vector & r1_parents  = r1->m_parents;
         unsigned num_r1_parents = r1_parents.size();
+        m_cg_parents.reset();
         for (unsigned i = 0; i < num_r1_parents; ++i) {
             enode* parent = r1_parents[i];
             if (!parent->is_marked())
@@ -645,31 +648,38 @@ namespace smt {
                     continue;
                 }
             }
-            if (parent->is_cgc_enabled()) {
-                enode_bool_pair pair = m_cg_table.insert(parent);
-                enode * parent_prime = pair.first;
-                if (parent_prime == parent) {
-                    SASSERT(parent);
-                    SASSERT(parent->is_cgr());
-                    SASSERT(m_cg_table.contains_ptr(parent));
-                    r2_parents.push_back(parent);
-                    continue;
-                }
-                parent->m_cg = parent_prime;
-                SASSERT(!m_cg_table.contains_ptr(parent));
-                if (parent_prime->m_root != parent->m_root) {
-                    bool used_commutativity = pair.second;
-                    TRACE("cg", tout << "found new congruence: #" << parent->get_owner_id() << " = #" << parent_prime->get_owner_id()
-                          << " used_commutativity: " << used_commutativity << "\n";);
-                    push_new_congruence(parent, parent_prime, used_commutativity);
-                }
-            }
+            if (parent->is_cgc_enabled()) 
+                m_cg_parents.push_back(parent);
             else {
                 // If congruence closure is not enabled for parent, then I just copy it
                 // to r2_parents
                 r2_parents.push_back(parent);
             }
         }
+        // The roots of the arguments do not change until the parents are reinserted,
+        // so the parents are hashed in one batch.
+        m_cg_hashes.resize(m_cg_parents.size());
+        m_cg_table.mk_hashes(m_cg_parents.size(), m_cg_parents.data(), m_cg_hashes.data());
+        for (unsigned i = 0; i < m_cg_parents.size(); ++i) {
+            enode * parent = m_cg_parents[i];
+            enode_bool_pair pair = m_cg_table.insert(parent, m_cg_hashes[i]);
+            enode * parent_prime = pair.first;
+            if (parent_prime == parent) {
+                SASSERT(parent);
+                SASSERT(parent->is_cgr());
+                SASSERT(m_cg_table.contains_ptr(parent));
+                r2_parents.push_back(parent);
+                continue;
+            }
+            parent->m_cg = parent_prime;
+            SASSERT(!m_cg_table.contains_ptr(parent));
+            if (parent_prime->m_root != parent->m_root) {
+                bool used_commutativity = pair.second;
+                TRACE("cg", tout << "found new congruence: #" << parent->get_owner_id() << " = #" << parent_prime->get_owner_id()
+                      << " used_commutativity: " << used_commutativity << "\n";);
+                push_new_congruence(parent, parent_prime, used_commutativity);
+            }
+        }
     }
 
     /**
@@ -2985,7 +2995,118 @@ namespace smt {
         SASSERT (num_scopes > 0);
         if (num_scopes > m_scope_lvl) return;
         pop_to_base_lvl();
+        vector<literal_vector> lemmas;
+        if (m_fparams.m_retain_theory_lemmas && !m.proofs_enabled() && !m_fparams.m_clause_proof) 
+            collect_theory_lemmas(m_scope_lvl - num_scopes, lemmas);
         pop_scope(num_scopes);
+        while (!m_checkpoints.empty() && m_checkpoints.back().m_base_lvl > m_base_lvl)
+            m_checkpoints.pop_back();
+        reassert_theory_lemmas(lemmas);
+    }
+
+    /**
+       \brief Create a checkpoint of the current state and return its id.
+       The enodes, clauses and theory state are kept by a user scope, so
+       restoring them is a pop of the trail. The activities and phases of
+       the Boolean variables are not part of the trail, they are copied.
+    */
+    unsigned context::checkpoint() {
+        push();
+        checkpoint_data cp;
+        cp.m_base_lvl = m_base_lvl;
+        cp.m_bvar_inc = m_bvar_inc;
+        cp.m_activity = m_activity;
+        for (bool_var v = 0; v < static_cast<bool_var>(get_num_bool_vars()); ++v) {
+            bool_var_data const& d = get_bdata(v);
+            cp.m_phase.push_back(d.m_phase_available ? to_lbool(d.m_phase) : l_undef);
+        }
+        m_checkpoints.push_back(std::move(cp));
+        return m_checkpoints.size() - 1;
+    }
+
+    /**
+       \brief Return to the state of checkpoint id. The checkpoint stays
+       valid, the checkpoints created after it are discarded. 
+       Theory lemmas learned since the checkpoint are kept when 
+       smt.retain_theory_lemmas is set, as for pop.
+    */
+    void context::restore(unsigned id) {
+        SASSERT(id < m_checkpoints.size());
+        m_checkpoints.shrink(id + 1);
+        checkpoint_data cp = std::move(m_checkpoints.back());
+        m_checkpoints.pop_back();
+        // leave the scope of the checkpoint with the assertions made since,
+        // and enter a new scope at the same level
+        SASSERT(m_base_lvl >= cp.m_base_lvl);
+        pop(m_base_lvl - cp.m_base_lvl + 1);
+        push();
+        SASSERT(m_base_lvl == cp.m_base_lvl);
+        unsigned num_vars = std::min(get_num_bool_vars(), cp.m_activity.size());
+        for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+            double act = m_activity[v];
+            if (act == cp.m_activity[v])
+                continue;
+            m_activity[v] = cp.m_activity[v];
+            activity_changed(v, cp.m_activity[v] > act);
+        }
+        m_bvar_inc = cp.m_bvar_inc;
+        for (bool_var v = 0; v < static_cast<bool_var>(num_vars); ++v) {
+            bool_var_data& d = get_bdata(v);
+            d.m_phase_available = cp.m_phase[v] != l_undef;
+            d.m_phase = cp.m_phase[v] == l_true;
+        }
+        m_checkpoints.push_back(std::move(cp));
+    }
+
+    /**
+       \brief collect the theory lemmas that are deleted when popping to new_lvl.
+       Theory lemmas are valid independently of the assertions, so they can be
+       kept after the pop as long as their atoms survive.
+    */
+    void context::collect_theory_lemmas(unsigned new_lvl, vector<literal_vector>& lemmas) {
+        SASSERT(new_lvl <= m_base_lvl);
+        unsigned lim = new_lvl < m_base_lvl ? m_base_scopes[new_lvl].m_lemmas_lim : m_lemmas.size();
+        for (unsigned i = lim; i < m_lemmas.size(); ++i) {
+            clause * cls = m_lemmas[i];
+            if (cls->deleted() || !cls->is_th_lemma())
+                continue;
+            lemmas.push_back(literal_vector(cls->get_num_literals(), cls->begin()));
+        }
+    }
+
+    void context::reassert_theory_lemmas(vector<literal_vector>& lemmas) {
+        unsigned num_vars = get_num_bool_vars();
+        for (literal_vector& lits : lemmas) {
+            if (inconsistent())
+                break;
+            if (any_of(lits, [&](literal l) { return l.var() >= static_cast<bool_var>(num_vars); }))
+                continue;
+            mk_clause(lits.size(), lits.data(), nullptr, CLS_TH_LEMMA);
+            m_stats.m_num_retained_lemmas++;
+        }
+        TRACE("pop_scope", tout << "retained theory lemmas: " << m_stats.m_num_retained_lemmas << "\n";);
+    }
+
+    /**
+       \brief Add the clause e as a theory lemma, for clauses received from 
+       other solvers. Unlike an assertion, the lemma is deleted when lemma
+       garbage collection finds it inactive. The atoms of e must be in the
+       internalized form of the context, as produced by literal2expr.
+    */
+    void context::add_lemma(expr * e) {
+        if (m.proofs_enabled()) {
+            assert_expr(e);
+            return;
+        }
+        SASSERT(at_base_level());
+        expr_ref_vector fmls(m);
+        flatten_or(e, fmls);
+        literal_vector lits;
+        for (expr* f : fmls) {
+            internalize(f, true);
+            lits.push_back(get_literal(f));
+        }
+        mk_clause(lits.size(), lits.data(), nullptr, CLS_TH_LEMMA);
     }
 
     /**
@@ -3221,7 +3342,10 @@ namespace smt {
                 expr * f   = m_asserted_formulas.get_formula(qhead);
                 proof * pr = m_asserted_formulas.get_formula_proof(qhead);
                 SASSERT(!pr || f == m.get_fact(pr));
-                internalize_assertion(f, pr, 0);
+                if (m_fparams.m_lazy_internalize && !m.proofs_enabled())
+                    defer_assertion(f);
+                else
+                    internalize_assertion(f, pr, 0);
                 ++qhead;
             }
             m_asserted_formulas.commit();
@@ -3233,6 +3357,61 @@ namespace smt {
         TRACE("after_internalize_assertions", display(tout););
     }
 
+    void context::defer_assertion(expr * f) {
+        m_lazy_assertions.push_back(f);
+        m_lazy_internalized.push_back(false);
+        push_trail(push_back_vector<expr_ref_vector>(m_lazy_assertions));
+        push_trail(push_back_vector<bool_vector>(m_lazy_internalized));
+    }
+
+    /**
+       \brief evaluate the deferred assertions in the candidate model and record the falsified ones.
+       Model completion fixes the values of the symbols that are not yet internalized, so
+       the deferred assertions that hold remain true in the final model.
+       Return true if all deferred assertions hold.
+    */
+    bool context::check_lazy_assertions() {
+        m_lazy_falsified.reset();
+        if (!has_lazy_assertions())
+            return true;
+        mk_proto_model();
+        expr_ref val(m);
+        for (unsigned i = 0; i < m_lazy_assertions.size(); ++i) {
+            if (m_lazy_internalized[i])
+                continue;
+            if (!m_proto_model || !m_proto_model->eval(m_lazy_assertions.get(i), val, true) || !m.is_true(val))
+                m_lazy_falsified.push_back(i);
+        }
+        TRACE("lazy_internalize", tout << "falsified " << m_lazy_falsified.size() << " of " 
+              << m_lazy_assertions.size() - m_lazy_num_internalized << " deferred assertions\n";);
+        return m_lazy_falsified.empty();
+    }
+
+    /**
+       \brief internalize the deferred assertions falsified by the last candidate model.
+       They are internalized at the search level and deferred again when it is popped.
+    */
+    void context::internalize_lazy_assertions() {
+        if (m_lazy_falsified.empty())
+            return;
+        ++m_lazy_rounds;
+        push_trail(value_trail<unsigned>(m_lazy_num_internalized));
+        unsigned long long mem = memory::get_allocation_size();
+        for (unsigned i : m_lazy_falsified) {
+            expr * f = m_lazy_assertions.get(i);
+            push_trail(set_bitvector_trail(m_lazy_internalized, i));
+            ++m_lazy_num_internalized;
+            m_lazy_nodes += get_num_exprs(f);
+            internalize_assertion(f, nullptr, 0);
+        }
+        unsigned long long new_mem = memory::get_allocation_size();
+        if (new_mem > mem)
+            m_lazy_bytes += new_mem - mem;
+        IF_VERBOSE(2, verbose_stream() << "(smt.lazy-internalize :internalized " << m_lazy_falsified.size()
+                   << " :deferred " << m_lazy_assertions.size() - m_lazy_num_internalized << ")\n";);
+        m_lazy_falsified.reset();
+    }
+
     void context::asserted_inconsistent() {
         proof * pr = m_asserted_formulas.get_inconsistency_proof();
         m_unsat_proof = pr;
@@ -3451,6 +3630,7 @@ namespace smt {
               m_case_split_queue->display(tout << "case splits\n");
               );
         display_profile(verbose_stream());
+        m_qmanager->write_profile();
         if (r == l_true && get_cancel_flag()) {
             r = l_undef;
         }
@@ -3766,9 +3946,12 @@ namespace smt {
             return false;
         if (status == l_false) 
             return false;
-        if (status == l_true && !m_qmanager->has_quantifiers() && !has_lambda()) 
+        bool lazy_falsified = status == l_true && !check_lazy_assertions();
+        if (lazy_falsified)
+            ; // continue the search with the falsified deferred assertions
+        else if (status == l_true && !m_qmanager->has_quantifiers() && !has_lambda()) 
             return false;
-        if (status == l_true && m_qmanager->has_quantifiers()) {
+        else if (status == l_true && m_qmanager->has_quantifiers()) {
             // possible outcomes   DONE l_true, DONE l_undef, CONTINUE
             mk_proto_model();
             quantifier_manager::check_model_result cmr = quantifier_manager::UNKNOWN;
@@ -3788,7 +3971,7 @@ namespace smt {
                 break;
             }
         }
-        if (status == l_true && has_lambda()) {
+        if (status == l_true && !lazy_falsified && has_lambda()) {
             m_last_search_failure = LAMBDAS;
             status = l_undef;
             return false;
@@ -3804,6 +3987,7 @@ namespace smt {
                 pop_scope(m_scope_lvl - curr_lvl);
                 SASSERT(at_search_level());
             }
+            internalize_lazy_assertions();
             for (theory* th : m_theory_set) 
                 if (!inconsistent()) 
                     th->restart_eh();
@@ -4087,6 +4271,7 @@ namespace smt {
             SASSERT(num_lits > 0);
             unsigned conflict_lvl = get_assign_level(lits[0]);
             SASSERT(conflict_lvl <= m_scope_lvl);
+            m_qmanager->conflict_eh(num_lits, lits);
 
             // When num_lits == 1, then the default behavior is to go
             // to base-level. If the problem has quantifiers, it may be
@@ -4241,6 +4426,9 @@ namespace smt {
             }
 #endif
             mk_clause(num_lits, lits, js, CLS_LEARNED);
+            for (auto const& [cls, l] : m_conflict_resolution->get_otfs_clauses())
+                if (!inconsistent())
+                    strengthen_clause(*cls, l);
             if (delay_forced_restart) {
                 SASSERT(num_lits == 1);
                 expr * unit     = bool_var2expr(lits[0].var());
@@ -4275,6 +4463,39 @@ namespace smt {
         return false;
     }
 
+    /**
+       \brief Remove the literal l from the learned clause cls after backjumping.
+       The clause minus l is subsumed by a resolvent of the last conflict, and l
+       was assigned above the new scope level, see conflict_resolution::check_otfs.
+    */
+    void context::strengthen_clause(clause & cls, literal l) {
+        SASSERT(get_assignment(l) == l_undef);
+        SASSERT(!cls.in_reinit_stack() && !cls.get_justification());
+        remove_watch_literal(&cls, 0);
+        remove_watch_literal(&cls, 1);
+        unsigned num = cls.get_num_literals();
+        for (unsigned i = 0; i < num; ++i) {
+            if (cls[i] == l) {
+                cls.swap_lits(i, num - 1);
+                break;
+            }
+        }
+        SASSERT(cls[num - 1] == l);
+        m_clause_proof.shrink(cls, num - 1);
+        cls.set_num_literals(num - 1);
+        dec_ref(l);
+        cls.swap_lits(0, select_watch_lit(&cls, 0));
+        cls.swap_lits(1, select_watch_lit(&cls, 1));
+        add_watch_literal(&cls, 0);
+        add_watch_literal(&cls, 1);
+        m_stats.m_num_otfs++;
+        TRACE("otfs", display_clause(tout << "strengthened: ", &cls); tout << "\n";);
+        if (get_assignment(cls[0]) == l_false)
+            set_conflict(b_justification(&cls));
+        else if (get_assignment(cls[0]) == l_undef && get_assignment(cls[1]) == l_false)
+            assign(cls[0], b_justification(&cls));
+    }
+
     /*
       \brief we record and restore relevancy information for literals in conflict clauses.
       A literal may have been marked relevant within the scope that gets popped during
@@ -4585,7 +4806,7 @@ namespace smt {
         if (fl == MEMOUT || fl == CANCELED || fl == NUM_CONFLICTS || fl == RESOURCE_LIMIT) {
             TRACE("get_model", tout << "last search failure: " << fl << "\n";);   
         }     
-        else if (m_fparams.m_model || m_fparams.m_model_on_final_check || 
+        else if (m_fparams.m_model || m_fparams.m_model_on_final_check || has_lazy_assertions() ||
                  (m_qmanager->has_quantifiers() && m_qmanager->model_based())) {
             m_model_generator->reset();
             m_proto_model = m_model_generator->mk_model();
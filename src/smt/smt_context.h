@@ -105,6 +105,15 @@ namespace smt {
         expr_ref_vector             m_e_internalized_stack; // stack of the expressions already internalized as enodes.
         quantifier_ref_vector       m_l_internalized_stack;
 
+        // assertions whose internalization is deferred until a candidate model falsifies them.
+        expr_ref_vector             m_lazy_assertions;
+        bool_vector                 m_lazy_internalized;
+        unsigned                    m_lazy_num_internalized = 0;
+        unsigned_vector             m_lazy_falsified;      // falsified by the last candidate model
+        unsigned                    m_lazy_rounds = 0;
+        unsigned                    m_lazy_nodes = 0;      // size of the deferred assertions that were internalized
+        unsigned long long          m_lazy_bytes = 0;      // memory used to internalize them
+
         ptr_vector<justification>   m_justifications;
 
         unsigned                    m_final_check_idx = 0; // circular counter used for implementing fairness
@@ -128,6 +137,8 @@ namespace smt {
         vector<enode_vector>        m_decl2enodes;  // decl -> enode (for decls with arity > 0)
         enode_vector                m_empty_vector;
         cg_table                    m_cg_table;
+        enode_vector                m_cg_parents;   // parents reinserted into m_cg_table by one merge
+        unsigned_vector             m_cg_hashes;    // their hashes
         struct new_eq {
             enode *                 m_lhs;
             enode *                 m_rhs;
@@ -553,6 +564,8 @@ namespace smt {
 
         ptr_vector<enode> const& enodes() const { return m_enodes; }
 
+        cg_table & get_cg_table() { return m_cg_table; }
+
         ptr_vector<enode>::const_iterator begin_enodes() const {
             return m_enodes.begin();
         }
@@ -640,12 +653,27 @@ namespace smt {
         svector<scope>              m_scopes;
         svector<base_scope>         m_base_scopes;
 
+        // A checkpoint is a user scope together with the heuristic state
+        // that a pop does not undo: the activities and phases of the
+        // Boolean variables that exist when the checkpoint is taken.
+        struct checkpoint_data {
+            unsigned                m_base_lvl;
+            double                  m_bvar_inc;
+            svector<double>         m_activity;
+            svector<lbool>          m_phase;
+        };
+        vector<checkpoint_data>     m_checkpoints;
+
         void push_scope();
 
         unsigned pop_scope_core(unsigned num_scopes);
 
         void pop_scope(unsigned num_scopes);
 
+        void collect_theory_lemmas(unsigned new_lvl, vector<literal_vector>& lemmas);
+
+        void reassert_theory_lemmas(vector<literal_vector>& lemmas);
+
         void undo_trail_stack(unsigned old_size);
 
         void unassign_vars(unsigned old_lim);
@@ -1209,6 +1237,14 @@ namespace smt {
 
         void asserted_inconsistent();
 
+        bool has_lazy_assertions() const { return m_lazy_num_internalized < m_lazy_assertions.size(); }
+
+        void defer_assertion(expr * f);
+
+        bool check_lazy_assertions();
+
+        void internalize_lazy_assertions();
+
         bool validate_assumptions(expr_ref_vector const& asms);
 
         void init_assumptions(expr_ref_vector const& asms);
@@ -1251,6 +1287,8 @@ namespace smt {
 
         virtual bool resolve_conflict();
 
+        void strengthen_clause(clause & cls, literal l);
+
 
         // -----------------------------------
         //
@@ -1622,12 +1660,20 @@ namespace smt {
 
         void assert_expr(expr * e, proof * pr);
 
+        void add_lemma(expr * e);
+
         void internalize_assertions();
 
         void push();
 
         void pop(unsigned num_scopes);
 
+        unsigned checkpoint();
+
+        void restore(unsigned id);
+
+        unsigned num_checkpoints() const { return m_checkpoints.size(); }
+
         lbool check(unsigned num_assumptions = 0, expr * const * assumptions = nullptr, bool reset_cancel = true);
 
         lbool check(expr_ref_vector const& cube, vector<expr_ref_vector> const& clauses);
@@ -20,6 +20,7 @@ Revision History:
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_pp_util.h"
+#include "ast/for_each_expr.h"
 #include "util/stats.h"
 #ifndef SINGLE_THREAD
 #include <thread>
@@ -418,11 +419,34 @@ namespace smt {
         st.update("mk clause binary", m_stats.m_num_mk_bin_clause);        
         st.update("del clause", m_stats.m_num_del_clause);
         st.update("dyn ack", m_stats.m_num_dyn_ack);
+        if (m_fparams.m_dack_adaptive) {
+            st.update("dyn ack used", m_stats.m_num_dyn_ack_used);
+            st.update("dyn ack demoted", m_stats.m_num_dyn_ack_demoted);
+        }
         st.update("interface eqs", m_stats.m_num_interface_eqs);
         st.update("max generation", m_stats.m_max_generation);
         st.update("minimized lits", m_stats.m_num_minimized_lits);
+        st.update("minimized binres lits", m_stats.m_num_binres_lits);
+        st.update("otfs strengthened clauses", m_stats.m_num_otfs);
+        if (m_stats.m_num_learned > 0) {
+            st.update("learned avg size initial", static_cast<double>(m_stats.m_num_learned_lits_initial) / m_stats.m_num_learned);
+            st.update("learned avg size", static_cast<double>(m_stats.m_num_learned_lits) / m_stats.m_num_learned);
+        }
         st.update("num checks", m_stats.m_num_checks);
+        st.update("retained theory lemmas", m_stats.m_num_retained_lemmas);
         st.update("mk bool var", m_stats.m_num_mk_bool_var ? m_stats.m_num_mk_bool_var - 1 : 0);
+        if (!m_lazy_assertions.empty()) {
+            // estimate the memory saved from the memory used by the deferred assertions that were internalized
+            unsigned deferred_nodes = 0;
+            for (unsigned i = 0; i < m_lazy_assertions.size(); ++i)
+                if (!m_lazy_internalized[i])
+                    deferred_nodes += get_num_exprs(m_lazy_assertions.get(i));
+            double bytes_per_node = m_lazy_nodes > 0 ? static_cast<double>(m_lazy_bytes) / m_lazy_nodes : 0.0;
+            st.update("lazy deferred assertions", m_lazy_assertions.size() - m_lazy_num_internalized);
+            st.update("lazy internalized assertions", m_lazy_num_internalized);
+            st.update("lazy internalize rounds", m_lazy_rounds);
+            st.update("lazy saved memory (MB)", deferred_nodes * bytes_per_node / (1024.0 * 1024.0));
+        }
         m_qmanager->collect_statistics(st);
         m_asserted_formulas.collect_statistics(st);
         for (theory* th : m_theory_set) {
@@ -23,6 +23,7 @@ Revision History:
 #include "ast/ast_smt2_pp.h"
 #include "smt/smt_model_finder.h"
 #include "ast/for_each_expr.h"
+#include "smt/smt_parallel.h"
 
 #include <iostream>
 
@@ -1417,6 +1418,8 @@ namespace smt {
         default:
             break;
         }
+        if (m_par && is_lemma(k))
+            m_par->share_lemma(*this, num_lits, lits);
         TRACE("mk_clause", display_literals_verbose(tout << "after simplification: " << literal_vector(num_lits, lits) << "\n", num_lits, lits) << "\n";);
 
         unsigned activity = 1;
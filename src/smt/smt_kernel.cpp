@@ -108,6 +108,14 @@ namespace smt {
         return m_imp->m_kernel.get_scope_level();
     }
 
+    unsigned kernel::checkpoint() {
+        return m_imp->m_kernel.checkpoint();
+    }
+
+    void kernel::restore(unsigned id) {
+        m_imp->m_kernel.restore(id);
+    }
+
     void kernel::reset() {
         ast_manager & _m = m();
         smt_params& fps = m_imp->m_kernel.get_fparams();
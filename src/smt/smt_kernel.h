@@ -107,6 +107,20 @@ namespace smt {
         */
         unsigned get_scope_level() const;
 
+        /**
+           \brief Create a checkpoint and return its id. A checkpoint is a
+           backtracking point that also records the activities and phases
+           of the Boolean variables.
+        */
+        unsigned checkpoint();
+
+        /**
+           \brief Return to the state of the given checkpoint without 
+           internalizing its assertions again. The checkpoint can be restored
+           again, the checkpoints created after it are discarded.
+        */
+        void restore(unsigned id);
+
         /**
            \brief Reset the kernel.
            All assertions are erased.
@@ -21,9 +21,37 @@ Author:
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_translation.h"
+#include "ast/for_each_expr.h"
 #include "smt/smt_parallel.h"
 #include "smt/smt_lookahead.h"
 
+namespace smt {
+
+    void parallel::share_lemma(context& pctx, unsigned num_lits, literal const* lits) {
+        if (num_lits > m_share_max_size)
+            return;
+        // glue is the number of distinct decision levels, unassigned literals count as one level.
+        auto level = [&](literal l) { return pctx.get_assignment(l) == l_undef ? UINT_MAX : pctx.get_assign_level(l); };
+        unsigned glue = 0;
+        for (unsigned i = 0; i < num_lits; ++i) {
+            unsigned lvl = level(lits[i]), j = 0;
+            for (; j < i && level(lits[j]) != lvl; ++j)
+                ;
+            if (j == i && ++glue > m_share_max_glue)
+                return;
+        }
+        expr_ref_vector clause(pctx.get_manager());
+        for (unsigned i = 0; i < num_lits; ++i) {
+            bool_var v = lits[i].var();
+            bool_var_data const& d = pctx.get_bdata(v);
+            if (d.is_theory_atom() && !pctx.m_theories.get_plugin(d.get_theory())->is_safe_to_copy(v))
+                return;
+            clause.push_back(pctx.literal2expr(lits[i]));
+        }
+        m_lemmas[pctx.m_par_index].push_back(mk_or(clause));
+    }
+}
+
 #ifdef SINGLE_THREAD
 
 namespace smt {
@@ -38,6 +66,31 @@ namespace smt {
 #include <thread>
 
 namespace smt {
+
+    namespace {
+        struct found_skolem {};
+
+        struct skolem_proc {
+            void operator()(var* n) const {}
+            void operator()(app const* n) const { if (n->get_decl()->is_skolem()) throw found_skolem(); }
+            void operator()(quantifier* n) const {}
+        };
+
+        /**
+           \brief symbols created by a worker are not known to the other workers,
+           so clauses that contain skolem symbols are not shared.
+         */
+        bool has_skolem(expr* e) {
+            skolem_proc p;
+            try {
+                for_each_expr(p, e);
+            }
+            catch (found_skolem const&) {
+                return true;
+            }
+            return false;
+        }
+    }
     
     lbool parallel::operator()(expr_ref_vector const& asms) {
 
@@ -46,6 +99,7 @@ namespace smt {
         flet<unsigned> _nt(ctx.m_fparams.m_threads, 1);
         unsigned thread_max_conflicts = ctx.get_fparams().m_threads_max_conflicts;
         unsigned max_conflicts = ctx.get_fparams().m_max_conflicts;
+        unsigned cube_frequency = ctx.get_fparams().m_threads_cube_frequency;
 
         // try first sequential with a low conflict budget to make super easy problems cheap
         unsigned max_c = std::min(thread_max_conflicts, 40u);
@@ -65,6 +119,13 @@ namespace smt {
         scoped_ptr_vector<context> pctxs;
         vector<expr_ref_vector> pasms;
 
+        // the buffered lemmas live in the managers of the workers
+        struct reset_lemmas {
+            vector<expr_ref_vector>& m_lemmas;
+            ~reset_lemmas() { m_lemmas.reset(); }
+        };
+        reset_lemmas _rl { m_lemmas };
+
         ast_manager& m = ctx.m;
         scoped_limits sl(m.limit());
         unsigned finished_id = UINT_MAX;
@@ -72,10 +133,11 @@ namespace smt {
         par_exception_kind ex_kind = DEFAULT_EX;
         unsigned error_code = 0;
         bool done = false;
-        unsigned num_rounds = 0;
         if (m.has_trace_stream())
             throw default_exception("trace streams have to be off in parallel mode");
 
+        m_share_max_size = ctx.get_fparams().m_threads_share_max_size;
+        m_share_max_glue = ctx.get_fparams().m_threads_share_max_glue;
         
         for (unsigned i = 0; i < num_threads; ++i) {
             smt_params.push_back(ctx.get_fparams());
@@ -90,83 +152,134 @@ namespace smt {
             ast_translation tr(m, *new_m);
             pasms.push_back(tr(asms));
             sl.push_child(&(new_m->limit()));
+            m_lemmas.push_back(expr_ref_vector(*new_m));
+            new_ctx.m_par = this;
+            new_ctx.m_par_index = i;
         }
 
-        auto cube = [](context& ctx, expr_ref_vector& lasms, expr_ref& c) {
+        // translations between the workers and the shared pool keep their caches across exchanges.
+        // They access the main manager, so they are only used while holding the lock.
+        scoped_ptr_vector<ast_translation> exporters, importers;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            exporters.push_back(alloc(ast_translation, *pms[i], m, false));
+            importers.push_back(alloc(ast_translation, m, *pms[i], false));
+        }
+
+        std::mutex mux;
+        expr_ref_vector shared_clauses(m);    // pool of clauses over the main manager
+        unsigned_vector shared_owner;         // worker that contributed each clause
+        obj_hashtable<expr> shared_set;
+        vector<expr_ref_vector> cubes;        // cubes over the main manager waiting for a worker
+        unsigned_vector shared_lim(num_threads, 0u), unit_lim(num_threads, 0u);
+        unsigned_vector num_exported(num_threads, 0u), num_imported(num_threads, 0u), num_split(num_threads, 0u);
+
+        auto split = [](context& ctx, expr_ref_vector& cube, expr_ref& c) {
             lookahead lh(ctx);
             c = lh.choose();
             if (c) {
                 if ((ctx.get_random_value() % 2) == 0) 
                     c = c.get_manager().mk_not(c);
-                lasms.push_back(c);
-            }
-        };
-
-        obj_hashtable<expr> unit_set;
-        expr_ref_vector unit_trail(ctx.m);
-        unsigned_vector unit_lim;
-        for (unsigned i = 0; i < num_threads; ++i) unit_lim.push_back(0);
-
-        std::function<void(void)> collect_units = [&,this]() {
-            for (unsigned i = 0; i < num_threads; ++i) {
-                context& pctx = *pctxs[i];
-                pctx.pop_to_base_lvl();
-                ast_translation tr(pctx.m, ctx.m);
-                unsigned sz = pctx.assigned_literals().size();
-                for (unsigned j = unit_lim[i]; j < sz; ++j) {
-                    literal lit = pctx.assigned_literals()[j];
-                    expr_ref e(pctx.bool_var2expr(lit.var()), pctx.m);
-                    if (lit.sign()) e = pctx.m.mk_not(e);
-                    expr_ref ce(tr(e.get()), ctx.m);
-                    if (!unit_set.contains(ce)) {
-                        unit_set.insert(ce);
-                        unit_trail.push_back(ce);
-                    }
-                }
+                cube.push_back(c);
             }
-
-            unsigned sz = unit_trail.size();
-            for (unsigned i = 0; i < num_threads; ++i) {
-                context& pctx = *pctxs[i];
-                ast_translation tr(ctx.m, pctx.m);
-                for (unsigned j = unit_lim[i]; j < sz; ++j) {
-                    expr_ref src(ctx.m), dst(pctx.m);
-                    dst = tr(unit_trail.get(j));
-                    pctx.assert_expr(dst);
-                }
-                unit_lim[i] = sz;
-            }
-            IF_VERBOSE(1, verbose_stream() << "(smt.thread :units " << sz << ")\n");
         };
 
-        std::mutex mux;
-
         auto worker_thread = [&](int i) {
             try {
                 context& pctx = *pctxs[i];
                 ast_manager& pm = *pms[i];
-                expr_ref_vector lasms(pasms[i]);
-                expr_ref c(pm);
-
-                pctx.get_fparams().m_max_conflicts = std::min(thread_max_conflicts, max_conflicts);
-                if (num_rounds > 0 && (pctx.get_fparams().m_threads_cube_frequency % num_rounds) == 0) 
-                    cube(pctx, lasms, c);
-                IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i; 
-                           if (num_rounds > 0) verbose_stream() << " :round " << num_rounds;
-                           if (c) verbose_stream() << " :cube " << mk_bounded_pp(c, pm, 3);
-                           verbose_stream() << ")\n";);
-                lbool r = pctx.check(lasms.size(), lasms.data());
-                
-                if (r == l_undef && pctx.m_num_conflicts >= max_conflicts) 
-                    ; // no-op
-                else if (r == l_undef && pctx.m_num_conflicts >= thread_max_conflicts) 
-                    return;
-                else if (r == l_false && pctx.unsat_core().contains(c)) {
-                    IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :learn " << mk_bounded_pp(c, pm, 3) << ")");
-                    pctx.assert_expr(mk_not(mk_and(pctx.unsat_core())));
-                    return;
-                } 
-                
+                ast_translation& exporter = *exporters[i];
+                ast_translation& importer = *importers[i];
+                expr_ref_vector& lemmas = m_lemmas[i];
+                expr_ref_vector cube(pm), lasms(pm), exports(pm), imports(pm);
+                unsigned budget = thread_max_conflicts;
+                unsigned conflicts_left = max_conflicts;
+                unsigned num_checks = 0;
+                lbool r = l_undef;
+
+                while (true) {
+                    // exchange units and lemmas with the shared pool, then pick up a cube if idle.
+                    pctx.pop_to_base_lvl();
+                    literal_vector const& units = pctx.assigned_literals();
+                    unit_lim[i] = std::min(unit_lim[i], units.size());
+                    for (unsigned j = unit_lim[i]; j < units.size(); ++j)
+                        lemmas.push_back(pctx.literal2expr(units[j]));
+                    unit_lim[i] = units.size();
+                    exports.reset();
+                    for (expr* e : lemmas)
+                        if (!has_skolem(e))
+                            exports.push_back(e);
+                    lemmas.reset();
+                    imports.reset();
+                    {
+                        std::lock_guard<std::mutex> lock(mux);
+                        if (done)
+                            return;
+                        for (expr* e : exports) {
+                            expr_ref ce(exporter(e), m);
+                            if (m.is_true(ce) || shared_set.contains(ce))
+                                continue;
+                            shared_set.insert(ce);
+                            shared_clauses.push_back(ce);
+                            shared_owner.push_back(i);
+                            ++num_exported[i];
+                        }
+                        for (unsigned j = shared_lim[i]; j < shared_clauses.size(); ++j)
+                            if (shared_owner[j] != static_cast<unsigned>(i))
+                                imports.push_back(importer(shared_clauses.get(j)));
+                        shared_lim[i] = shared_clauses.size();
+                        if (cube.empty() && !cubes.empty()) {
+                            for (expr* e : cubes.back())
+                                cube.push_back(importer(e));
+                            cubes.pop_back();
+                        }
+                    }
+                    // imported clauses are lemmas, garbage collection may delete them.
+                    for (expr* e : imports)
+                        pctx.add_lemma(e);
+                    num_imported[i] += imports.size();
+
+                    lasms.reset();
+                    lasms.append(pasms[i]);
+                    lasms.append(cube);
+                    pctx.get_fparams().m_max_conflicts = std::min(budget, conflicts_left);
+                    IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :budget " << budget;
+                               if (!imports.empty()) verbose_stream() << " :imported " << imports.size();
+                               if (!cube.empty()) verbose_stream() << " :cube " << mk_bounded_pp(mk_and(cube), pm, 3);
+                               verbose_stream() << ")\n";);
+                    r = pctx.check(lasms.size(), lasms.data());
+                    ++num_checks;
+                    conflicts_left -= std::min(conflicts_left, pctx.m_num_conflicts);
+
+                    if (r == l_undef && pctx.get_last_search_failure() == NUM_CONFLICTS && conflicts_left > 0) {
+                        // out of budget: split the cube and leave the other half to the next idle worker.
+                        if (budget <= UINT_MAX / 2)
+                            budget *= 2;
+                        expr_ref c(pm);
+                        if (cube_frequency > 0 && num_checks % cube_frequency == 0)
+                            split(pctx, cube, c);
+                        if (c) {
+                            expr_ref_vector other(cube);
+                            other.set(other.size() - 1, mk_not(pm, c));
+                            std::lock_guard<std::mutex> lock(mux);
+                            cubes.push_back(expr_ref_vector(m));
+                            for (expr* e : other)
+                                cubes.back().push_back(exporter(e));
+                            ++num_split[i];
+                        }
+                        continue;
+                    }
+                    if (r == l_false && any_of(cube, [&](expr* e) { return pctx.unsat_core().contains(e); })) {
+                        // the cube is refuted, the negated core is a lemma for all workers.
+                        expr_ref lemma(mk_not(mk_and(pctx.unsat_core())), pm);
+                        IF_VERBOSE(1, verbose_stream() << "(smt.thread " << i << " :learn " << mk_bounded_pp(lemma, pm, 3) << ")\n");
+                        pctx.pop_to_base_lvl();
+                        pctx.add_lemma(lemma);
+                        lemmas.push_back(lemma);
+                        cube.reset();
+                        continue;
+                    }
+                    break;
+                }
 
                 bool first = false;
                 {
@@ -190,6 +303,7 @@ namespace smt {
 
             }
             catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
                 if (finished_id == UINT_MAX) {
                     error_code = err.error_code();
                     ex_kind = ERROR_EX;
@@ -197,6 +311,7 @@ namespace smt {
                 }
             }
             catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
                 if (finished_id == UINT_MAX) {
                     ex_msg = ex.msg();
                     ex_kind = DEFAULT_EX;
@@ -204,6 +319,7 @@ namespace smt {
                 }
             }
             catch (...) {
+                std::lock_guard<std::mutex> lock(mux);
                 if (finished_id == UINT_MAX) {
                     ex_msg = "unknown exception";
                     ex_kind = ERROR_EX;
@@ -214,22 +330,23 @@ namespace smt {
 
         // for debugging:  num_threads = 1;
 
-        while (true) {
-            vector<std::thread> threads(num_threads);
-            for (unsigned i = 0; i < num_threads; ++i) {
-                threads[i] = std::thread([&, i]() { worker_thread(i); });
-            }
-            for (auto & th : threads) {
-                th.join();
-            }
-            if (done) break;
-
-            collect_units();
-            ++num_rounds;
-            max_conflicts = (max_conflicts < thread_max_conflicts) ? 0 : (max_conflicts - thread_max_conflicts);
-            thread_max_conflicts *= 2;            
+        vector<std::thread> threads(num_threads);
+        for (unsigned i = 0; i < num_threads; ++i) {
+            threads[i] = std::thread([&, i]() { worker_thread(i); });
+        }
+        for (auto & th : threads) {
+            th.join();
         }
 
+        unsigned total_exported = 0, total_imported = 0, total_split = 0;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            total_exported += num_exported[i];
+            total_imported += num_imported[i];
+            total_split += num_split[i];
+        }
+        ctx.m_aux_stats.update("smt par shared clauses", total_exported);
+        ctx.m_aux_stats.update("smt par imported clauses", total_imported);
+        ctx.m_aux_stats.update("smt par cubes", total_split);
         for (context* c : pctxs) {
             c->collect_statistics(ctx.m_aux_stats);
         }
@@ -9,6 +9,12 @@ Abstract:
 
     Parallel SMT, portfolio loop specialized to SMT core.
 
+    Workers run continuously on their own copy of the context.
+    Units, low glue learned clauses and theory lemmas are exchanged
+    through a shared pool of clauses over the main ast_manager. Cubes
+    are split off by lookahead when a worker exhausts its conflict
+    budget and are picked up from a shared queue by idle workers.
+
 Author:
 
     nbjorner 2020-01-31
@@ -23,12 +29,22 @@ Revision History:
 namespace smt {
 
     class parallel {
-        context& ctx;
+        context&                ctx;
+        unsigned                m_share_max_size = 0;
+        unsigned                m_share_max_glue = 0;
+        vector<expr_ref_vector> m_lemmas;   // lemmas of each worker waiting to be shared
+
     public:
         parallel(context& ctx): ctx(ctx) {}
 
         lbool operator()(expr_ref_vector const& asms);
 
+        /**
+           \brief called by worker contexts on every learned clause and theory lemma.
+           Lemmas of small size and glue are buffered for the shared pool.
+         */
+        void share_lemma(context& pctx, unsigned num_lits, literal const* lits);
+
     };
 
 }
@@ -564,11 +564,25 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
     }
 
+    void quantifier_manager::conflict_eh(unsigned num_lits, literal const * lits) {
+        m_imp->m_qi_queue.conflict_eh(num_lits, lits);
+    }
+
+    void quantifier_manager::write_profile() {
+        q::quantifier_profile * p = m_imp->m_qi_queue.get_profile();
+        if (!p)
+            return;
+        p->reset_match_time();
+        m_imp->m_plugin->collect_profile(*p);
+        m_imp->m_qi_queue.write_profile();
+    }
+
     void quantifier_manager::display_stats(std::ostream & out, quantifier * q) const {
         m_imp->display_stats(out, q);
     }
@@ -736,6 +750,16 @@ namespace smt {
             return m_active && (m_mam->is_shared(n) || m_lazy_mam->is_shared(n));
         }
 
+        void collect_statistics(::statistics & st) const override {
+            if (m_mam) m_mam->collect_statistics(st);
+            if (m_lazy_mam) m_lazy_mam->collect_statistics(st);
+        }
+
+        void collect_profile(q::quantifier_profile & p) const override {
+            if (m_mam) m_mam->collect_profile(p);
+            if (m_lazy_mam) m_lazy_mam->collect_profile(p);
+        }
+
         void adjust_model(proto_model * m) override {
             if (m_fparams->m_mbqi) {
                 m_model_finder->fix_model(m);
@@ -19,10 +19,12 @@ Revision History:
 #pragma once
 
 #include "ast/ast.h"
+#include "ast/quantifier_profile.h"
 #include "ast/quantifier_stat.h"
 #include "util/statistics.h"
 #include "util/params.h"
 #include "smt/smt_types.h"
+#include "smt/smt_literal.h"
 #include <tuple>
 
 class proto_model;
@@ -96,6 +98,9 @@ namespace smt {
         void collect_statistics(::statistics & st) const;
         void reset_statistics();
 
+        void conflict_eh(unsigned num_lits, literal const * lits);
+        void write_profile();
+
         ptr_vector<quantifier>::const_iterator begin_quantifiers() const;
         ptr_vector<quantifier>::const_iterator end_quantifiers() const;
         ptr_vector<quantifier>::const_iterator begin() const { return begin_quantifiers(); }
@@ -175,6 +180,10 @@ namespace smt {
         virtual void push() = 0;
         virtual void pop(unsigned num_scopes) = 0;
 
+        virtual void collect_statistics(::statistics & st) const {}
+
+        virtual void collect_profile(q::quantifier_profile & p) const {}
+
 
 
     };
@@ -18,6 +18,8 @@ Revision History:
 --*/
 #pragma once
 
+#include <cstdint>
+
 namespace smt {
 
     struct statistics {
@@ -39,12 +41,20 @@ namespace smt {
         unsigned m_num_mk_lits;
         unsigned m_num_dyn_ack;
         unsigned m_num_del_dyn_ack;
+        unsigned m_num_dyn_ack_used;
+        unsigned m_num_dyn_ack_demoted;
         unsigned m_num_interface_eqs;
         unsigned m_max_generation;
         unsigned m_num_minimized_lits;
+        unsigned m_num_learned;
+        uint64_t m_num_learned_lits_initial;
+        uint64_t m_num_learned_lits;
+        unsigned m_num_binres_lits;
+        unsigned m_num_otfs;
         unsigned m_num_checks;
         unsigned m_num_simplifications;
         unsigned m_num_del_clauses;
+        unsigned m_num_retained_lemmas;
         statistics() {
             reset();
         }
@@ -0,0 +1,148 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    cut_pool.cpp
+
+Abstract:
+
+    Check the cuts of the cut pool on small bounded integer programs.
+    An invalid cut cuts off integer solutions, so the solver with the
+    cut pool is compared with an enumeration of all the integer points.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "smt/smt_kernel.h"
+#include "smt/params/smt_params.h"
+#include "util/util.h"
+#include "test/stat_util.h"
+#include <iostream>
+
+namespace {
+
+    // the constraints sum_j a[i][j]*x_j <= b[i] or >= b[i] over 0 <= x_j <= u_j
+    struct ilp {
+        unsigned_vector      m_upper;
+        vector<vector<int>>  m_rows;
+        vector<int>          m_rhs;
+        bool_vector          m_geq;
+
+        unsigned num_vars() const { return m_upper.size(); }
+
+        bool holds(unsigned_vector const& x) const {
+            for (unsigned i = 0; i < m_rows.size(); ++i) {
+                int s = 0;
+                for (unsigned j = 0; j < num_vars(); ++j)
+                    s += m_rows[i][j] * static_cast<int>(x[j]);
+                if (m_geq[i] ? s < m_rhs[i] : s > m_rhs[i])
+                    return false;
+            }
+            return true;
+        }
+
+        bool is_sat() const {
+            unsigned_vector x(num_vars(), 0u);
+            while (true) {
+                if (holds(x))
+                    return true;
+                unsigned j = 0;
+                for (; j < num_vars() && x[j] == m_upper[j]; ++j)
+                    x[j] = 0;
+                if (j == num_vars())
+                    return false;
+                ++x[j];
+            }
+        }
+
+        void add_row(vector<int> const& a, int b, bool geq) {
+            m_rows.push_back(a);
+            m_rhs.push_back(b);
+            m_geq.push_back(geq);
+        }
+    };
+
+    // general integer rows, where the rows scaled by 2 and 3 give mixed integer rounding cuts
+    void mk_general(random_gen& rand, ilp& p) {
+        unsigned n = 4;
+        for (unsigned j = 0; j < n; ++j)
+            p.m_upper.push_back(5);
+        for (unsigned i = 0; i < 3; ++i) {
+            vector<int> a;
+            for (unsigned j = 0; j < n; ++j)
+                a.push_back(static_cast<int>(rand(13)) - 6);
+            p.add_row(a, static_cast<int>(rand(21)) - 5, rand(2) == 0);
+        }
+    }
+
+    // a knapsack over binary columns with a lower bound on the profit, which gives cover cuts
+    void mk_knapsack(random_gen& rand, ilp& p) {
+        unsigned n = 10;
+        vector<int> w, c;
+        int sum_w = 0, sum_c = 0;
+        for (unsigned j = 0; j < n; ++j) {
+            p.m_upper.push_back(1);
+            w.push_back(3 + static_cast<int>(rand(18)));
+            c.push_back(1 + static_cast<int>(rand(10)));
+            sum_w += w.back();
+            sum_c += c.back();
+        }
+        p.add_row(w, sum_w / 2, false);
+        p.add_row(c, sum_c / 2 + static_cast<int>(rand(sum_c / 4 + 1)), true);
+    }
+
+    lbool solve(ilp const& p, bool cut_pool, ::statistics& st) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        arith_util a(m);
+        smt_params fp;
+        params_ref prms;
+        prms.set_bool("arith.cut_pool", cut_pool);
+        smt::kernel solver(m, fp, prms);
+        expr_ref_vector xs(m);
+        for (unsigned j = 0; j < p.num_vars(); ++j) {
+            expr_ref x(m.mk_const(symbol(j), a.mk_int()), m);
+            xs.push_back(x);
+            solver.assert_expr(a.mk_ge(x, a.mk_int(0)));
+            solver.assert_expr(a.mk_le(x, a.mk_int(p.m_upper[j])));
+        }
+        for (unsigned i = 0; i < p.m_rows.size(); ++i) {
+            expr_ref_vector sum(m);
+            for (unsigned j = 0; j < p.num_vars(); ++j)
+                if (p.m_rows[i][j] != 0)
+                    sum.push_back(a.mk_mul(a.mk_int(p.m_rows[i][j]), xs.get(j)));
+            expr_ref lhs(sum.empty() ? a.mk_int(0) : a.mk_add(sum), m);
+            expr_ref rhs(a.mk_int(p.m_rhs[i]), m);
+            solver.assert_expr(p.m_geq[i] ? a.mk_ge(lhs, rhs) : a.mk_le(lhs, rhs));
+        }
+        lbool r = solver.check();
+        solver.collect_statistics(st);
+        return r;
+    }
+
+    void check(ilp const& p, ::statistics& st) {
+        lbool expected = p.is_sat() ? l_true : l_false;
+        ENSURE(solve(p, true, st) == expected);
+        ::statistics st2;
+        ENSURE(solve(p, false, st2) == expected);
+    }
+}
+
+void tst_cut_pool() {
+    random_gen rand(0);
+    ::statistics st;
+    for (unsigned k = 0; k < 100; ++k) {
+        ilp p;
+        mk_general(rand, p);
+        check(p, st);
+    }
+    for (unsigned k = 0; k < 100; ++k) {
+        ilp p;
+        mk_knapsack(rand, p);
+        check(p, st);
+    }
+    st.display(std::cout);
+    ENSURE(get_stat(st, "arith-cut-pool-mir") > 0);
+    ENSURE(get_stat(st, "arith-cut-pool-cover") > 0);
+}
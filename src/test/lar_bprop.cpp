@@ -0,0 +1,85 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    lar_bprop.cpp
+
+Abstract:
+
+    Check that bound propagation over the touched rows finds the same
+    implied bounds on one thread and on several threads.
+
+--*/
+#include "math/lp/lar_solver.h"
+#include "math/lp/lp_bound_propagator.h"
+#include "util/util.h"
+#include <iostream>
+
+namespace {
+
+    struct bprop_imp {
+        lp::lar_solver& m_solver;
+        bprop_imp(lp::lar_solver& s): m_solver(s) {}
+        lp::lar_solver& lp() { return m_solver; }
+        lp::lar_solver const& lp() const { return m_solver; }
+        bool bound_is_interesting(unsigned, lp::lconstraint_kind, rational const&) const { return true; }
+        void consume(rational const&, lp::constraint_index) {}
+        bool add_eq(lp::lpvar, lp::lpvar, lp::explanation const&, bool) { return false; }
+        bool is_equal(unsigned, unsigned) const { return false; }
+    };
+
+    // bounded columns and terms over three of them, every term is a row of the tableau
+    void mk_rows(lp::lar_solver& s, unsigned num_vars, unsigned num_rows) {
+        random_gen rand(0);
+        for (unsigned j = 0; j < num_vars; ++j) {
+            lp::var_index v = s.add_var(j, false);
+            s.add_var_bound(v, lp::GE, rational(-static_cast<int>(rand(10))));
+            s.add_var_bound(v, lp::LE, rational(static_cast<int>(rand(10))));
+        }
+        for (unsigned i = 0; i < num_rows; ++i) {
+            vector<std::pair<rational, lp::var_index>> coeffs;
+            for (unsigned k = 0; k < 3; ++k) {
+                int c = 1 + static_cast<int>(rand(3));
+                coeffs.push_back(std::make_pair(rational(rand(2) == 0 ? c : -c), rand(num_vars)));
+            }
+            lp::var_index t = s.add_term(coeffs, num_vars + i);
+            s.add_var_bound(t, lp::LE, rational(static_cast<int>(rand(20))));
+        }
+    }
+
+    void propagate(lp::lar_solver& s, unsigned num_threads, vector<lp::implied_bound>& ibounds) {
+        bprop_imp imp(s);
+        lp::lp_bound_propagator<bprop_imp> bp(imp);
+        s.settings().bprop_threads() = num_threads;
+        bp.init();
+        for (unsigned j = 0; j < s.column_count(); ++j)
+            s.mark_rows_for_bound_prop(j);
+        s.propagate_bounds_for_touched_rows(bp);
+        ibounds = bp.ibounds();
+    }
+}
+
+void tst_lar_bprop() {
+    unsigned num_rows = 2500;
+    lp::lar_solver s;
+    mk_rows(s, 1000, num_rows);
+    lp::lp_status st = s.find_feasible_solution();
+    ENSURE(st == lp::lp_status::OPTIMAL || st == lp::lp_status::FEASIBLE);
+    ENSURE(s.A_r().row_count() >= num_rows);
+    vector<lp::implied_bound> seq, par;
+    // the first round also visits the rows touched by the solver, so the
+    // bounds are only compared from the second round on, which visits the
+    // same rows in the same order.
+    propagate(s, 1, seq);
+    propagate(s, 1, seq);
+    unsigned rounds = s.settings().stats().m_bprop_parallel_rounds;
+    propagate(s, 8, par);
+    std::cout << "rows " << s.A_r().row_count() << " implied bounds " << seq.size() << "\n";
+    // the rows are split between the threads
+    ENSURE(s.settings().stats().m_bprop_parallel_rounds == rounds + 1);
+    ENSURE(!seq.empty());
+    ENSURE(seq.size() == par.size());
+    for (unsigned k = 0; k < seq.size(); ++k)
+        ENSURE(seq[k] == par[k]);
+}
@@ -0,0 +1,96 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    lar_float_first.cpp
+
+Abstract:
+
+    Solve random linear real arithmetic problems with and without the
+    floating-point-first simplex and check that both agree on feasibility
+    and end in a feasible basis.
+
+--*/
+#include "math/lp/lar_solver.h"
+#include "util/util.h"
+#include "util/uint_set.h"
+#include <iostream>
+
+namespace {
+
+    // columns with bounds, some of them strict, and terms over four columns with bounds.
+    // Each round adds num_rows terms, so the later rounds start from the basis of the earlier ones.
+    void add_round(random_gen& rand, lp::lar_solver& s, unsigned num_vars, unsigned num_rows, unsigned& ext) {
+        auto kind = [&](bool lower) { return rand(4) == 0 ? (lower ? lp::GT : lp::LT) : (lower ? lp::GE : lp::LE); };
+        for (unsigned i = 0; i < num_rows; ++i) {
+            vector<std::pair<rational, lp::var_index>> coeffs;
+            for (unsigned k = 0; k < 4; ++k) {
+                int c = 1 + static_cast<int>(rand(5));
+                coeffs.push_back(std::make_pair(rational(rand(2) == 0 ? c : -c), rand(num_vars)));
+            }
+            lp::var_index t = s.add_term(coeffs, ext++);
+            int b = static_cast<int>(rand(40)) - 10;
+            s.add_var_bound(t, kind(false), rational(b));
+            if (rand(3) == 0)
+                s.add_var_bound(t, kind(true), rational(b - 1 - static_cast<int>(rand(20))));
+        }
+    }
+
+    // every row has its own basic column, which occurs in no other row
+    bool basis_is_ok(lp::lar_solver& s) {
+        uint_set basic;
+        for (unsigned i = 0; i < s.A_r().row_count(); ++i) {
+            unsigned j = s.get_base_column_in_row(i);
+            if (basic.contains(j) || s.A_r().m_columns[j].size() != 1)
+                return false;
+            basic.insert(j);
+        }
+        return true;
+    }
+
+    lp::lp_status solve(unsigned seed, bool float_first, unsigned& repairs) {
+        random_gen rand(seed);
+        lp::lar_solver s;
+        s.settings().float_first() = float_first;
+        unsigned num_vars = 30, ext = 0;
+        for (unsigned j = 0; j < num_vars; ++j) {
+            lp::var_index v = s.add_var(ext++, false);
+            s.add_var_bound(v, rand(5) == 0 ? lp::GT : lp::GE, rational(-static_cast<int>(rand(20))));
+            if (rand(2) == 0)
+                s.add_var_bound(v, lp::LE, rational(static_cast<int>(rand(20))));
+        }
+        lp::lp_status st = lp::lp_status::OPTIMAL;
+        for (unsigned round = 0; round < 3; ++round) {
+            add_round(rand, s, num_vars, 10, ext);
+            st = s.find_feasible_solution();
+            if (st == lp::lp_status::INFEASIBLE)
+                break;
+            ENSURE(st == lp::lp_status::OPTIMAL || st == lp::lp_status::FEASIBLE);
+            ENSURE(s.is_feasible());
+            ENSURE(s.ax_is_correct());
+            ENSURE(basis_is_ok(s));
+        }
+        repairs = s.settings().stats().m_float_first_repairs;
+        ENSURE(float_first || s.settings().stats().m_float_first_calls == 0);
+        return st;
+    }
+}
+
+void tst_lar_float_first() {
+    unsigned num_sat = 0, num_unsat = 0, calls = 0, repairs = 0;
+    for (unsigned seed = 0; seed < 40; ++seed) {
+        unsigned r1 = 0, r2 = 0;
+        lp::lp_status st1 = solve(seed, false, r1);
+        lp::lp_status st2 = solve(seed, true, r2);
+        ENSURE((st1 == lp::lp_status::INFEASIBLE) == (st2 == lp::lp_status::INFEASIBLE));
+        if (st1 == lp::lp_status::INFEASIBLE)
+            ++num_unsat;
+        else
+            ++num_sat;
+        ++calls;
+        repairs += r2;
+    }
+    std::cout << "sat " << num_sat << " unsat " << num_unsat << " float first repairs " << repairs << " in " << calls << " instances\n";
+    ENSURE(num_sat > 0 && num_unsat > 0);
+}
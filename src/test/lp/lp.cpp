@@ -59,6 +59,7 @@
 #include "math/lp/cross_nested.h"
 #include "math/lp/int_cube.h"
 #include "math/lp/emonics.h"
+#include "math/lp/small_rational.h"
 namespace nla {
 void test_horner();
 void test_monics();
@@ -2206,6 +2207,7 @@ void setup_args_parser(argument_parser & parser) {
     parser.add_option_with_help_string("--test_mpq", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np", "test rationals");
     parser.add_option_with_help_string("--test_mpq_np_plus", "test rationals using plus instead of +=");
+    parser.add_option_with_help_string("--test_pivot", "measure the pivot throughput of mpq and small_rational tableaus");
     parser.add_option_with_help_string("--maximize_term", "test maximize_term()");
 }
 
@@ -3313,6 +3315,118 @@ void test_rationals() {
     std::cout << T_to_string(r) << std::endl;
 }
 
+static rational cell_value(mpq const & v) { return v; }
+static rational cell_value(small_rational const & v) { return v.to_rational(); }
+
+// makes column j the unit column of row i
+template <typename T>
+void pivot_tableau_column(static_matrix<T, T> & A, unsigned i, unsigned j) {
+    auto & column = A.m_columns[j];
+    unsigned k = 0;
+    while (column[k].var() != i)
+        k++;
+    T pivot = A.get_val(column[k]);
+    for (auto & c : A.m_rows[i])
+        c.coeff() /= pivot;
+    if (k > 0) {
+        std::swap(column[0], column[k]);
+        A.m_rows[column[0].var()][column[0].offset()].offset() = 0;
+        A.m_rows[column[k].var()][column[k].offset()].offset() = k;
+    }
+    while (column.size() > 1)
+        A.pivot_row_to_row_given_cell(i, column.back(), j);
+}
+
+// Pivots a random sparse tableau with small integer coefficients, starting
+// from the slack basis, until num_pivots pivots are done or more than
+// max_big_permille of the cells per mille do not fit a small rational.
+// Returns the number of pivots per second and the final tableau as a dense
+// vector. The cap does not depend on T, so both types do the same pivots.
+template <typename T>
+double pivot_throughput(unsigned m, unsigned n, unsigned num_pivots, unsigned max_big_permille,
+                        vector<rational> & tableau, unsigned & num_big, unsigned & pivots) {
+    random_gen rand(17);
+    unsigned cols = n + m;
+    static_matrix<T, T> A(m, cols);
+    vector<unsigned> basis;
+    vector<bool> is_basic(cols, false);
+    for (unsigned i = 0; i < m; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            if (rand(10) != 0)
+                continue;
+            int v = static_cast<int>(rand(9)) - 4;
+            A.add_new_element(i, j, T(v == 0 ? 1 : v));
+        }
+        A.add_new_element(i, n + i, T(1));
+        basis.push_back(n + i);
+        is_basic[n + i] = true;
+    }
+    auto too_big = [&]() {
+        unsigned nnz = 0, big = 0;
+        for (unsigned i = 0; i < m; i++)
+            for (auto const & c : A.m_rows[i]) {
+                nnz++;
+                if (cell_value(c.coeff()).is_big())
+                    big++;
+            }
+        return 1000 * static_cast<uint64_t>(big) > static_cast<uint64_t>(max_big_permille) * nnz;
+    };
+    stopwatch sw;
+    pivots = 0;
+    for (unsigned p = 0; p < num_pivots; p++) {
+        if (p % 16 == 0 && too_big())
+            break;
+        sw.start();
+        unsigned i = rand(m);
+        auto const & row = A.m_rows[i];
+        unsigned start = rand(row.size());
+        unsigned entering = UINT_MAX;
+        for (unsigned k = 0; k < row.size() && entering == UINT_MAX; k++) {
+            unsigned j = row[(start + k) % row.size()].var();
+            if (!is_basic[j])
+                entering = j;
+        }
+        if (entering != UINT_MAX) {
+            pivot_tableau_column(A, i, entering);
+            is_basic[basis[i]] = false;
+            is_basic[entering] = true;
+            basis[i] = entering;
+            pivots++;
+        }
+        sw.stop();
+    }
+    tableau.reset();
+    tableau.resize(m * cols);
+    num_big = 0;
+    for (unsigned i = 0; i < m; i++)
+        for (auto const & c : A.m_rows[i]) {
+            tableau[i * cols + c.var()] = cell_value(c.coeff());
+            if (numeric_traits<T>::is_big(c.coeff()))
+                num_big++;
+        }
+    return sw.get_seconds() > 0 ? pivots / sw.get_seconds() : 0;
+}
+
+// Random pivots make the coefficients grow without bound, so the runs stop
+// when the share of big cells passes a cap: with no big cells small_rational
+// stays on its 64-bit path, with a fifth of the cells big it falls back to
+// mpq and does not beat it.
+void test_pivot_throughput() {
+    for (unsigned max_big_permille : { 0u, 200u }) {
+        for (unsigned m : { 20u, 50u, 100u }) {
+            unsigned num_pivots = 20 * m;
+            vector<rational> t1, t2;
+            unsigned big1, big2, pivots1, pivots2;
+            double r1 = pivot_throughput<mpq>(m, 2 * m, num_pivots, max_big_permille, t1, big1, pivots1);
+            double r2 = pivot_throughput<small_rational>(m, 2 * m, num_pivots, max_big_permille, t2, big2, pivots2);
+            std::cout << "rows " << m << ", big cells cap " << max_big_permille << " per mille: " << pivots1 << " pivots, mpq "
+                      << r1 << " pivots/sec, small_rational " << r2 << " pivots/sec, big cells " << big2 << std::endl;
+            VERIFY(pivots1 == pivots2);
+            VERIFY(t1 == t2);
+        }
+    }
+}
+
 void get_random_interval(bool& neg_inf, bool& pos_inf, int& x, int &y) {
     int i = my_random() % 10;
     if (i == 0) {
@@ -3939,6 +4053,11 @@ void test_lp_local(int argn, char**argv) {
         return finalize(0);
     }
 
+    if (args_parser.option_is_used("--test_pivot")) {
+        test_pivot_throughput();
+        return finalize(0);
+    }
+
     if (args_parser.option_is_used("--test_mpq_np")) {
         test_rationals_no_numeric_pairs();
         return finalize(0);
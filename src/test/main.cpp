@@ -216,6 +216,16 @@ int main(int argc, char ** argv) {
     TST(permutation);
     TST(nlsat);
     TST(zstring);
+    TST(cut_pool);
+    TST(lar_bprop);
+    TST(lar_float_first);
+    TST(smt_fingerprints);
+    TST(sat_ddfw_simd);
+    TST(sat_cube_and_conquer);
+    TST(sat_drat);
+    TST(smt_case_split);
+    TST(smt_checkpoint);
+    TST(smt_cg_table);
     if (test_all) return 0;
     TST(ext_numeral);
     TST(interval);
@@ -255,6 +265,10 @@ int main(int argc, char ** argv) {
     TST(pb2bv);
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
+    TST_ARGV(sat_local_search_bench);
+    TST_ARGV(sat_drat_bench);
+    TST_ARGV(smt_fingerprints_bench);
+    TST_ARGV(smt_case_split_bench);
     TST_ARGV(cnf_backbones);
     TST(bdd);
     TST(pdd);
@@ -0,0 +1,75 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_cube_and_conquer.cpp
+
+Abstract:
+
+    Compare the results of cube and conquer with the sequential solver on
+    random 3-SAT instances near the threshold, with a small conflict budget
+    per cube so that cubes are split again. Check that sat.max_conflicts
+    bounds the conflicts of all cubes together.
+
+--*/
+#include "sat/sat_solver.h"
+#include "test/sat_test_util.h"
+#include "test/stat_util.h"
+#include <iostream>
+
+static lbool solve(vector<sat::literal_vector>& clauses, unsigned num_vars, params_ref const& p, statistics& st, bool check_model) {
+    reslimit limit;
+    sat::solver s(p, limit);
+    for (unsigned v = 0; v <= num_vars; ++v)
+        s.mk_var();
+    for (sat::literal_vector& c : clauses)
+        s.mk_clause(c.size(), c.data());
+    lbool r = s.check();
+    if (r == l_true && check_model) {
+        sat::model const& m = s.get_model();
+        for (sat::literal_vector const& c : clauses) {
+            bool sat = false;
+            for (sat::literal l : c)
+                sat |= m[l.var()] == (l.sign() ? l_false : l_true);
+            ENSURE(sat);
+        }
+    }
+    s.collect_statistics(st);
+    return r;
+}
+
+void tst_sat_cube_and_conquer() {
+    params_ref cc;
+    cc.set_uint("threads", 4);
+    cc.set_bool("cube_and_conquer", true);
+    cc.set_uint("cube_and_conquer.conflicts", 20);
+    unsigned num_vars = 120, num_sat = 0, num_unsat = 0;
+    statistics cc_st;
+    for (unsigned seed = 0; seed < 6; ++seed) {
+        vector<sat::literal_vector> clauses;
+        mk_random_3sat(clauses, num_vars, (426 * num_vars) / 100, seed);
+        statistics st;
+        lbool r1 = solve(clauses, num_vars, params_ref(), st, true);
+        lbool r2 = solve(clauses, num_vars, cc, cc_st, true);
+        std::cout << "seed " << seed << " sequential " << r1 << " cube and conquer " << r2 << "\n";
+        ENSURE(r1 == r2);
+        num_sat += r1 == l_true;
+        num_unsat += r1 == l_false;
+    }
+    std::cout << "sat " << num_sat << " unsat " << num_unsat << " cubes " << get_stat(cc_st, "sat cc cubes")
+              << " splits " << get_stat(cc_st, "sat cc splits") << " steals " << get_stat(cc_st, "sat cc steals") << "\n";
+    ENSURE(num_sat > 0 && num_unsat > 0);
+    ENSURE(get_stat(cc_st, "sat cc splits") > 0);
+
+    // the solver stops one conflict after the budget of each cube.
+    unsigned max_conflicts = 200;
+    cc.set_uint("max_conflicts", max_conflicts);
+    vector<sat::literal_vector> clauses;
+    mk_random_3sat(clauses, 300, (426 * 300) / 100, 0);
+    statistics st;
+    lbool r = solve(clauses, 300, cc, st, true);
+    std::cout << "max_conflicts " << max_conflicts << " result " << r << " conflicts " << get_stat(st, "sat cc conflicts")
+              << " cubes " << get_stat(st, "sat cc cubes") << "\n";
+    ENSURE(get_stat(st, "sat cc conflicts") <= max_conflicts + get_stat(st, "sat cc cubes"));
+}
@@ -0,0 +1,339 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Measure the cost of writing DRAT and LRAT proofs, check that
+    binary proofs are read back by the DRAT parser, and check the
+    hints of LRAT proofs.
+
+--*/
+#include "sat/sat_solver.h"
+#include "sat/dimacs.h"
+#include "test/sat_test_util.h"
+#include "test/stat_util.h"
+#include "util/stopwatch.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <cstdio>
+#include <unordered_map>
+
+static void mk_instance(sat::solver& s, char const* file_name, unsigned num_vars) {
+    if (file_name)
+        parse_dimacs_file(file_name, std::cerr, s, 1);
+    else
+        mk_random_3sat(s, num_vars, 5 * num_vars, 0);
+}
+
+static size_t file_size(char const* file_name) {
+    std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+    return in ? static_cast<size_t>(in.tellg()) : 0;
+}
+
+static std::string read_file(char const* file_name) {
+    std::ifstream in(file_name, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void bench_proof(char const* file_name, unsigned num_vars, char const* proof_file, bool binary, bool async, bool lrat = false) {
+    params_ref p;
+    if (proof_file) {
+        p.set_sym("drat.file", symbol(proof_file));
+        p.set_bool("drat.binary", binary);
+        p.set_bool("drat.async", async);
+        p.set_bool("drat.lrat", lrat);
+    }
+    stopwatch sw;
+    lbool r;
+    {
+        reslimit limit;
+        sat::solver s(p, limit);
+        mk_instance(s, file_name, num_vars);
+        sw.start();
+        r = s.check();
+        // the proof is complete once the solver and its writer are gone.
+    }
+    sw.stop();
+    std::cout << (lrat ? "lrat " : "drat ") << (proof_file ? (binary ? "binary" : "text  ") : "none  ")
+              << (proof_file ? (async ? " async" : " sync ") : "      ")
+              << " result: " << r << " seconds: " << sw.get_seconds();
+    if (proof_file)
+        std::cout << " bytes: " << file_size(proof_file);
+    std::cout << "\n";
+}
+
+/**
+   \brief replay a binary proof through the DRAT checker. 
+   Every added clause is verified to be DRUP or DRAT and the proof must end 
+   in the empty clause.
+ */
+static void check_binary_proof(char const* file_name, unsigned num_vars, char const* proof_file) {
+    params_ref p;
+    p.set_bool("drat.check_unsat", true);
+    reslimit limit;
+    sat::solver input(params_ref(), limit);
+    mk_instance(input, file_name, num_vars);
+    sat::solver s(p, limit);
+    sat::drat checker(s);
+    checker.updt_config();
+    auto declare = [&](sat::literal_vector const& lits) {
+        for (sat::literal lit : lits)
+            while (lit.var() >= s.num_vars())
+                s.mk_var(true);
+    };
+    sat::literal_vector lits;
+    for (unsigned v = 0; v < input.num_vars(); ++v)
+        if (input.value(v) != l_undef) {
+            lits.reset();
+            lits.push_back(sat::literal(v, input.value(v) == l_false));
+            declare(lits);
+            checker.add(lits, sat::status::input());
+        }
+    svector<sat::solver::bin_clause> bins;
+    input.collect_bin_clauses(bins, false, false);
+    for (auto const& [l1, l2] : bins) {
+        lits.reset();
+        lits.push_back(l1);
+        lits.push_back(l2);
+        declare(lits);
+        checker.add(lits, sat::status::input());
+    }
+    for (sat::clause* c : input.clauses()) {
+        lits.reset();
+        lits.append(c->size(), c->begin());
+        declare(lits);
+        checker.add(lits, sat::status::input());
+    }
+    unsigned num_records = 0;
+    std::ifstream in(proof_file, std::ios::in | std::ios::binary);
+    dimacs::drat_parser parser(in, std::cerr, true);
+    for (auto const& r : parser) {
+        ++num_records;
+        declare(r.m_lits);
+        checker.add(r.m_lits, r.m_status);
+    }
+    statistics st;
+    checker.collect_statistics(st);
+    std::cout << "binary proof records: " << num_records << " refuted: " << checker.inconsistent() << "\n" << st;
+    ENSURE(checker.inconsistent());
+}
+
+namespace {
+    struct lrat_record {
+        bool               m_del = false;
+        unsigned           m_id = 0;
+        sat::literal_vector m_lits;
+        unsigned_vector    m_ids;     // hints, or the deleted clauses
+        bool operator==(lrat_record const& other) const {
+            return m_del == other.m_del && (m_del || m_id == other.m_id) && m_lits == other.m_lits && m_ids == other.m_ids;
+        }
+        bool operator!=(lrat_record const& other) const { return !(*this == other); }
+    };
+}
+
+static vector<lrat_record> read_text_lrat(char const* proof_file) {
+    vector<lrat_record> records;
+    std::ifstream in(proof_file);
+    std::string tok;
+    while (in >> tok) {
+        lrat_record r;
+        r.m_id = std::stoul(tok);
+        in >> tok;
+        if (tok == "d") {
+            r.m_del = true;
+            while (in >> tok && tok != "0")
+                r.m_ids.push_back(std::stoul(tok));
+        }
+        else {
+            for (; tok != "0"; in >> tok) {
+                int l = std::stoi(tok);
+                r.m_lits.push_back(sat::literal(std::abs(l), l < 0));
+            }
+            while (in >> tok && tok != "0")
+                r.m_ids.push_back(std::stoul(tok));
+        }
+        records.push_back(r);
+    }
+    return records;
+}
+
+static vector<lrat_record> read_binary_lrat(char const* proof_file) {
+    vector<lrat_record> records;
+    std::string bytes = read_file(proof_file);
+    unsigned i = 0;
+    auto next = [&]() {
+        unsigned n = 0, shift = 0;
+        unsigned char ch;
+        do {
+            ch = static_cast<unsigned char>(bytes[i++]);
+            n |= (ch & 127u) << shift;
+            shift += 7;
+        }
+        while (ch & 128);
+        return n;
+    };
+    while (i < bytes.size()) {
+        lrat_record r;
+        char kind = bytes[i++];
+        ENSURE(kind == 'a' || kind == 'd');
+        r.m_del = kind == 'd';
+        if (!r.m_del) {
+            r.m_id = next() / 2;
+            for (unsigned l = next(); l != 0; l = next())
+                r.m_lits.push_back(sat::literal(l / 2, l % 2 == 1));
+        }
+        for (unsigned id = next(); id != 0; id = next())
+            r.m_ids.push_back(id / 2);
+        records.push_back(r);
+    }
+    return records;
+}
+
+/**
+   \brief check an LRAT proof of the input clauses, numbered from 1.
+   Under the negation of each lemma every hint must be unit, except the last one
+   which must be false. Deleted clauses cannot be used as hints.
+ */
+static void check_lrat(vector<sat::literal_vector> const& inputs, vector<lrat_record> const& records) {
+    std::unordered_map<unsigned, sat::literal_vector> db;
+    unsigned last_id = inputs.size();
+    for (unsigned i = 0; i < inputs.size(); ++i)
+        db[i + 1] = inputs[i];
+    svector<lbool> value;
+    auto val = [&](sat::literal l) {
+        lbool v = value.get(l.var(), l_undef);
+        return l.sign() ? ~v : v;
+    };
+    bool refuted = false;
+    unsigned num_hints = 0;
+    for (lrat_record const& r : records) {
+        if (r.m_del) {
+            for (unsigned id : r.m_ids)
+                ENSURE(db.erase(id) == 1);
+            continue;
+        }
+        ENSURE(r.m_id > last_id);
+        last_id = r.m_id;
+        value.reset();
+        for (sat::literal l : r.m_lits)
+            value.setx(l.var(), l.sign() ? l_true : l_false, l_undef);
+        bool conflict = false;
+        for (unsigned id : r.m_ids) {
+            ENSURE(!conflict);
+            ENSURE(db.count(id) == 1);
+            sat::literal unit = sat::null_literal;
+            unsigned num_undef = 0;
+            for (sat::literal l : db[id]) {
+                ENSURE(val(l) != l_true);
+                if (val(l) == l_undef && l != unit) {
+                    unit = l;
+                    ++num_undef;
+                }
+            }
+            ENSURE(num_undef <= 1);
+            if (num_undef == 0)
+                conflict = true;
+            else
+                value.setx(unit.var(), unit.sign() ? l_false : l_true, l_undef);
+        }
+        ENSURE(conflict);
+        num_hints += r.m_ids.size();
+        db[r.m_id] = r.m_lits;
+        refuted |= r.m_lits.empty();
+    }
+    std::cout << "lrat records: " << records.size() << " hints: " << num_hints << " refuted: " << refuted << "\n";
+    ENSURE(refuted);
+}
+
+/**
+   \brief solve an unsatisfiable random instance with LRAT proofs in both formats.
+   Extra input clauses are a tautology, a clause with a repeated literal and a
+   clause that loses a literal to a unit, since the solver does not keep them as given.
+ */
+static void test_lrat(unsigned num_vars) {
+    vector<sat::literal_vector> inputs;
+    sat::literal x1(1, false), x2(2, false), x3(3, false), x4(4, false);
+    sat::literal tautology[3] = { x4, ~x4, x1 }, weakened[3] = { ~x1, x2, x3 }, repeated[3] = { x2, x3, x2 };
+    inputs.push_back(sat::literal_vector(3, tautology));
+    inputs.push_back(sat::literal_vector(1, &x1));
+    inputs.push_back(sat::literal_vector(3, weakened));
+    inputs.push_back(sat::literal_vector(3, repeated));
+    mk_random_3sat(inputs, num_vars, 5 * num_vars, 0);
+    char const* text_proof = "sat_lrat.lrat";
+    char const* binary_proof = "sat_lrat.blrat";
+    for (char const* proof_file : { text_proof, binary_proof }) {
+        params_ref p;
+        p.set_sym("drat.file", symbol(proof_file));
+        p.set_bool("drat.binary", proof_file == binary_proof);
+        p.set_bool("drat.lrat", true);
+        reslimit limit;
+        sat::solver s(p, limit);
+        for (unsigned v = 0; v <= num_vars; ++v)
+            s.mk_var();
+        for (sat::literal_vector& c : inputs)
+            s.mk_clause(c.size(), c.data());
+        ENSURE(s.check() == l_false);
+        statistics st;
+        s.get_drat().collect_statistics(st);
+        ENSURE(get_stat(st, "lrat-lemmas-without-hints") == 0);
+    }
+    vector<lrat_record> text = read_text_lrat(text_proof);
+    ENSURE(text == read_binary_lrat(binary_proof));
+    check_lrat(inputs, text);
+    std::remove(text_proof);
+    std::remove(binary_proof);
+}
+
+/**
+   \brief the writer thread writes the same proof as the synchronous writer,
+   and the binary proof refutes the instance.
+ */
+void tst_sat_drat() {
+    unsigned num_vars = 80;
+    char const* sync_proof = "sat_drat_sync.bdrat";
+    char const* async_proof = "sat_drat_async.bdrat";
+    bench_proof(nullptr, num_vars, sync_proof, true, false);
+    bench_proof(nullptr, num_vars, async_proof, true, true);
+    ENSURE(file_size(sync_proof) > 0);
+    ENSURE(read_file(sync_proof) == read_file(async_proof));
+    check_binary_proof(nullptr, num_vars, async_proof);
+    std::remove(sync_proof);
+    std::remove(async_proof);
+    test_lrat(num_vars);
+}
+
+/**
+   \brief compare the solve time without proofs, with text proofs and with binary proofs,
+   written synchronously or from the writer thread, and with LRAT proofs.
+   usage: sat_drat_bench [num_vars | file.cnf]
+ */
+void tst_sat_drat_bench(char ** argv, int argc, int& i) {
+    unsigned num_vars = 200;
+    char const* file_name = nullptr;
+    if (i + 1 < argc && argv[i + 1][0] != '/') {
+        ++i;
+        if ('0' <= argv[i][0] && argv[i][0] <= '9')
+            num_vars = atoi(argv[i]);
+        else
+            file_name = argv[i];
+    }
+    char const* text_proof = "sat_drat_bench.drat";
+    char const* binary_proof = "sat_drat_bench.bdrat";
+    bench_proof(file_name, num_vars, nullptr, false, false);
+    bench_proof(file_name, num_vars, text_proof, false, false);
+    bench_proof(file_name, num_vars, text_proof, false, true);
+    bench_proof(file_name, num_vars, binary_proof, true, false);
+    bench_proof(file_name, num_vars, binary_proof, true, true);
+    bench_proof(file_name, num_vars, text_proof, false, false, true);
+    bench_proof(file_name, num_vars, binary_proof, true, false, true);
+    bench_proof(file_name, num_vars, binary_proof, true, false);
+    check_binary_proof(file_name, num_vars, binary_proof);
+    std::remove(text_proof);
+    std::remove(binary_proof);
+}
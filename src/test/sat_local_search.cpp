@@ -1,5 +1,10 @@
 #include "sat/sat_local_search.h"
+#include "sat/sat_ddfw.h"
+#include "sat/sat_simd.h"
 #include "sat/sat_solver.h"
+#include "test/sat_test_util.h"
+#include "test/stat_util.h"
+#include "util/stopwatch.h"
 #include "util/cancel_eh.h"
 #include "util/scoped_ctrl_c.h"
 #include "util/scoped_timer.h"
@@ -127,3 +132,86 @@ void tst_sat_local_search(char ** argv, int argc, int& i) {
     local_search.check(0, nullptr, nullptr);    
 
 }
+
+static lbool bench_ddfw(sat::solver const& s, bool simd, unsigned budget, double& flips) {
+    params_ref p;
+    p.set_bool("ddfw.simd", simd);
+    sat::ddfw ddfw;
+    ddfw.updt_params(p);
+    ddfw.set_seed(1);
+    ddfw.add(s);
+    ddfw.rlimit().push(budget);
+    stopwatch sw;
+    sw.start();
+    lbool r = ddfw.check(0, nullptr, nullptr);
+    sw.stop();
+    statistics st;
+    ddfw.collect_statistics(st);
+    flips = get_stat(st, "sat ddfw flips");
+    std::cout << "ddfw " << (simd ? "simd  " : "scalar") << " result: " << r << " flips: " << flips
+              << " seconds: " << sw.get_seconds() << " flips/sec: " << flips / std::max(sw.get_seconds(), 1e-6) << "\n";
+    return r;
+}
+
+static lbool bench_local_search(sat::solver const& s, bool simd, unsigned budget, double& flips) {
+    sat::local_search ls;
+    ls.import(s, true);
+    ls.config().set_simd(simd && sat::has_avx2());
+    ls.rlimit().push(budget);
+    stopwatch sw;
+    sw.start();
+    lbool r = ls.check(0, nullptr, nullptr);
+    sw.stop();
+    statistics st;
+    ls.collect_statistics(st);
+    flips = get_stat(st, "local-search-flips");
+    std::cout << "local-search " << (simd ? "simd  " : "scalar") << " result: " << r << " flips: " << flips
+              << " seconds: " << sw.get_seconds() << " flips/sec: " << flips / std::max(sw.get_seconds(), 1e-6) << "\n";
+    return r;
+}
+
+/**
+   \brief the AVX2 and the scalar score updates of DDFW and of walksat 
+   follow the same search.
+ */
+void tst_sat_ddfw_simd() {
+    if (!sat::has_avx2()) {
+        std::cout << "ddfw simd skipped: the CPU does not support AVX2\n";
+        return;
+    }
+    reslimit limit;
+    params_ref params;
+    sat::solver solver(params, limit);
+    mk_random_3sat(solver, 2000, 8400, 0);
+    double scalar_flips = 0, simd_flips = 0;
+    lbool r1 = bench_ddfw(solver, false, 200000, scalar_flips);
+    lbool r2 = bench_ddfw(solver, true, 200000, simd_flips);
+    ENSURE(r1 == r2);
+    ENSURE(scalar_flips == simd_flips);
+    r1 = bench_local_search(solver, false, 2, scalar_flips);
+    r2 = bench_local_search(solver, true, 2, simd_flips);
+    ENSURE(r1 == r2);
+    ENSURE(scalar_flips == simd_flips);
+}
+
+/**
+   \brief measure flips per second of DDFW and of walksat local search with the 
+   scalar and the AVX2 score updates, on a random 3-SAT instance.
+   usage: sat_local_search_bench [num_vars] [num_steps]
+ */
+void tst_sat_local_search_bench(char ** argv, int argc, int& i) {
+    unsigned num_vars = 50000, budget = 2000000;
+    if (i + 1 < argc && argv[i + 1][0] != '/') 
+        num_vars = atoi(argv[++i]);
+    if (i + 1 < argc && argv[i + 1][0] != '/') 
+        budget = atoi(argv[++i]);
+    reslimit limit;
+    params_ref params;
+    sat::solver solver(params, limit);
+    mk_random_3sat(solver, num_vars, (42 * num_vars) / 10, 0);
+    double flips;
+    bench_ddfw(solver, false, budget, flips);
+    bench_ddfw(solver, true, budget, flips);
+    bench_local_search(solver, false, std::max(1u, budget / 100000), flips);
+    bench_local_search(solver, true, std::max(1u, budget / 100000), flips);
+}
@@ -0,0 +1,47 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_test_util.h
+
+Abstract:
+
+    Instance generators shared by the SAT solver tests.
+
+--*/
+#pragma once
+
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+/**
+   \brief random 3-SAT instance with num_vars variables and num_clauses clauses.
+   Ratios above 4.26 are unsatisfiable with high probability.
+   The variables are 1 to num_vars as in DIMACS files, since DRAT proofs
+   cannot mention variable 0.
+ */
+inline void mk_random_3sat(vector<sat::literal_vector>& clauses, unsigned num_vars, unsigned num_clauses, unsigned seed) {
+    random_gen rand(seed);
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        sat::literal lits[3];
+        for (unsigned j = 0; j < 3; ++j) {
+            sat::bool_var v;
+            do {
+                v = 1 + rand(num_vars);
+            }
+            while ((j > 0 && lits[0].var() == v) || (j > 1 && lits[1].var() == v));
+            lits[j] = sat::literal(v, rand(2) == 0);
+        }
+        clauses.push_back(sat::literal_vector(3, lits));
+    }
+}
+
+inline void mk_random_3sat(sat::solver& s, unsigned num_vars, unsigned num_clauses, unsigned seed) {
+    vector<sat::literal_vector> clauses;
+    mk_random_3sat(clauses, num_vars, num_clauses, seed);
+    for (unsigned v = 0; v <= num_vars; ++v)
+        s.mk_var();
+    for (sat::literal_vector& c : clauses)
+        s.mk_clause(c.size(), c.data());
+}
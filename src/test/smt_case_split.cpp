@@ -0,0 +1,126 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_case_split.cpp
+
+Abstract:
+
+    Compare case split strategies on a generated set of quantifier-free
+    instances: random 3-clauses over Boolean atoms and difference constraints.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "smt/smt_kernel.h"
+#include "smt/params/smt_params.h"
+#include "util/stopwatch.h"
+#include "test/stat_util.h"
+#include <iostream>
+
+namespace {
+
+    struct case_split_result {
+        unsigned m_solved { 0 };
+        unsigned m_sat { 0 };
+        double   m_decisions { 0 };
+        double   m_conflicts { 0 };
+        double   m_time { 0 };
+    };
+
+    void mk_instance(ast_manager& m, unsigned seed, unsigned num_bools, unsigned num_ints, unsigned num_clauses, expr_ref_vector& fmls) {
+        arith_util a(m);
+        random_gen rand(seed);
+        expr_ref_vector bools(m), ints(m);
+        for (unsigned i = 0; i < num_bools; ++i)
+            bools.push_back(m.mk_const(symbol(("b" + std::to_string(i)).c_str()), m.mk_bool_sort()));
+        for (unsigned i = 0; i < num_ints; ++i)
+            ints.push_back(m.mk_const(symbol(("x" + std::to_string(i)).c_str()), a.mk_int()));
+        for (unsigned i = 0; i < num_clauses; ++i) {
+            expr_ref_vector lits(m);
+            for (unsigned j = 0; j < 3; ++j) {
+                expr_ref lit(m);
+                if (num_ints > 1 && rand(5) == 0) {
+                    expr* x = ints.get(rand(num_ints));
+                    expr* y = ints.get(rand(num_ints));
+                    int c = static_cast<int>(rand(11)) - 5;
+                    lit = a.mk_le(a.mk_sub(x, y), a.mk_int(c));
+                }
+                else
+                    lit = bools.get(rand(num_bools));
+                if (rand(2) == 0)
+                    lit = m.mk_not(lit);
+                lits.push_back(lit);
+            }
+            fmls.push_back(m.mk_or(lits));
+        }
+    }
+
+    void solve(case_split_strategy cs, unsigned num_instances, unsigned max_conflicts, case_split_result& r) {
+        for (unsigned k = 0; k < num_instances; ++k) {
+            ast_manager m;
+            reg_decl_plugins(m);
+            smt_params fp;
+            fp.m_case_split_strategy = cs;
+            fp.m_max_conflicts = max_conflicts;
+            expr_ref_vector fmls(m);
+            mk_instance(m, k, 150, 20, 600, fmls);
+            smt::kernel solver(m, fp);
+            for (expr* f : fmls)
+                solver.assert_expr(f);
+            stopwatch sw;
+            sw.start();
+            lbool res = solver.check();
+            sw.stop();
+            ::statistics st;
+            solver.collect_statistics(st);
+            r.m_time += sw.get_seconds();
+            r.m_decisions += get_stat(st, "decisions");
+            r.m_conflicts += get_stat(st, "conflicts");
+            if (res != l_undef)
+                ++r.m_solved;
+            if (res == l_true)
+                ++r.m_sat;
+        }
+    }
+}
+
+static void compare_strategies(unsigned num_instances, unsigned max_conflicts) {
+    std::pair<char const*, case_split_strategy> strategies[] = {
+        { "activity", CS_ACTIVITY },
+        { "activity-delay-new", CS_ACTIVITY_DELAY_NEW },
+        { "vmtf", CS_VMTF }
+    };
+    unsigned num_sat = UINT_MAX;
+    for (auto const& [name, cs] : strategies) {
+        case_split_result r;
+        solve(cs, num_instances, max_conflicts, r);
+        std::cout << name << ": solved " << r.m_solved << "/" << num_instances
+                  << " sat " << r.m_sat
+                  << " decisions/sec " << (r.m_time > 0 ? r.m_decisions / r.m_time : 0.0)
+                  << " conflicts " << r.m_conflicts
+                  << " time " << r.m_time << "\n";
+        // strategies that solve every instance agree on the satisfiable ones
+        if (r.m_solved == num_instances) {
+            ENSURE(num_sat == UINT_MAX || num_sat == r.m_sat);
+            num_sat = r.m_sat;
+        }
+    }
+}
+
+void tst_smt_case_split() {
+    compare_strategies(3, 20000);
+}
+
+/**
+   usage: smt_case_split_bench [num_instances] [max_conflicts]
+ */
+void tst_smt_case_split_bench(char ** argv, int argc, int& i) {
+    unsigned num_instances = 20, max_conflicts = 20000;
+    if (i + 1 < argc && argv[i + 1][0] != '/')
+        num_instances = atoi(argv[++i]);
+    if (i + 1 < argc && argv[i + 1][0] != '/')
+        max_conflicts = atoi(argv[++i]);
+    compare_strategies(num_instances, max_conflicts);
+}
@@ -0,0 +1,128 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_cg_table.cpp
+
+Abstract:
+
+    Check the congruences found after merges that reinsert many parents
+    into the congruence table, and compare the hashes computed in batches
+    by cg_table::mk_hashes with the hashes computed one at a time.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "smt/smt_kernel.h"
+#include "smt/smt_context.h"
+#include "smt/params/smt_params.h"
+#include "util/stopwatch.h"
+#include <iostream>
+
+namespace {
+
+    struct cg_instance {
+        ast_manager&        m;
+        sort_ref            S;
+        func_decl_ref       f, g, h, k;
+        expr_ref_vector     xs, terms;
+        expr_ref            c;
+
+        cg_instance(ast_manager& m, unsigned n): m(m), S(m), f(m), g(m), h(m), k(m), xs(m), terms(m), c(m) {
+            S = m.mk_uninterpreted_sort(symbol("S"));
+            sort* dom[5] = { S, S, S, S, S };
+            f = m.mk_func_decl(symbol("f"), 4, dom, S);
+            g = m.mk_func_decl(symbol("g"), 5, dom, S);
+            h = m.mk_func_decl(symbol("h"), 2, dom, S);
+            k = m.mk_func_decl(symbol("k"), 1, dom, S);
+            c = m.mk_const(symbol("c"), S);
+            for (unsigned i = 0; i < n + 2; ++i)
+                xs.push_back(m.mk_const(symbol(("x" + std::to_string(i)).c_str()), S));
+            for (unsigned i = 0; i < n; ++i) {
+                expr* x0 = xs.get(i), *x1 = xs.get(i + 1), *x2 = xs.get(i + 2);
+                expr* fargs[4] = { x0, x1, c, x0 };
+                expr* gargs[5] = { x0, c, c, x1, x2 };
+                expr* hargs[2] = { x0, c };
+                terms.push_back(m.mk_app(f, 4, fargs));
+                terms.push_back(m.mk_app(g, 5, gargs));
+                terms.push_back(m.mk_app(h, 2, hargs));
+                terms.push_back(m.mk_app(k, 1, &x0));
+            }
+        }
+
+        // merge x_0 .. x_{n-1} in rounds that merge classes of equal size,
+        // so each round reinserts the parents of half of the constants.
+        void merge_all(smt::kernel& s, unsigned n) {
+            for (unsigned step = 1; step < n; step *= 2)
+                for (unsigned i = 0; i + step < n; i += 2 * step)
+                    s.assert_expr(m.mk_eq(xs.get(i), xs.get(i + step)));
+        }
+    };
+}
+
+void tst_smt_cg_table() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    smt_params fp;
+    // keep the equalities for the congruence closure instead of substituting them
+    fp.m_preprocess = false;
+    unsigned n = 1000;
+    cg_instance inst(m, n);
+
+    // all constants are merged, so the f and g applications become congruent.
+    {
+        smt::kernel s(m, fp);
+        for (expr* t : inst.terms)
+            s.assert_expr(m.mk_not(m.mk_eq(t, inst.c)));
+        inst.merge_all(s, n + 2);
+        s.assert_expr(m.mk_not(m.mk_eq(inst.terms.get(0), inst.terms.get(4 * (n - 1)))));
+        stopwatch sw;
+        sw.start();
+        ENSURE(s.check() == l_false);
+        sw.stop();
+        std::cout << "congruence after merges: unsat seconds: " << sw.get_seconds() << "\n";
+    }
+
+    // without the merges of the last constants the instance is satisfiable.
+    {
+        smt::kernel s(m, fp);
+        for (expr* t : inst.terms)
+            s.assert_expr(m.mk_not(m.mk_eq(t, inst.c)));
+        inst.merge_all(s, n / 2);
+        s.assert_expr(m.mk_not(m.mk_eq(inst.terms.get(0), inst.terms.get(4 * (n - 1)))));
+        ENSURE(s.check() == l_true);
+
+        smt::context& ctx = s.get_context();
+        smt::cg_table& cg = ctx.get_cg_table();
+        ptr_vector<smt::enode> apps;
+        for (expr* t : inst.terms) {
+            ENSURE(ctx.e_internalized(t));
+            apps.push_back(ctx.get_enode(t));
+        }
+        unsigned_vector hashes(apps.size(), 0u);
+        cg.mk_hashes(apps.size(), apps.data(), hashes.data());
+        for (unsigned i = 0; i < apps.size(); ++i)
+            ENSURE(hashes[i] == cg.hash(apps[i]));
+
+        // the n-ary applications of f grouped in runs, hashed in batches and one at a time.
+        ptr_vector<smt::enode> fs;
+        for (unsigned i = 0; i < apps.size(); i += 4)
+            fs.push_back(apps[i]);
+        hashes.resize(fs.size());
+        cg.mk_hashes(fs.size(), fs.data(), hashes.data());
+        for (unsigned i = 0; i < fs.size(); ++i)
+            ENSURE(hashes[i] == cg.hash(fs[i]));
+        stopwatch batch_sw, single_sw;
+        for (unsigned r = 0; r < 200; ++r) {
+            batch_sw.start();
+            cg.mk_hashes(fs.size(), fs.data(), hashes.data());
+            batch_sw.stop();
+            single_sw.start();
+            for (unsigned i = 0; i < fs.size(); ++i)
+                hashes[i] = cg.hash(fs[i]);
+            single_sw.stop();
+        }
+        std::cout << "hash " << fs.size() << " applications x 200: batched seconds: " << batch_sw.get_seconds()
+                  << " one at a time seconds: " << single_sw.get_seconds() << "\n";
+    }
+}
@@ -0,0 +1,125 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_checkpoint.cpp
+
+Abstract:
+
+    Solve queries that extend a shared base from a checkpoint of the base,
+    and compare the results with solving base and query from scratch.
+    Check that a restore returns the enodes, Boolean variables and
+    activities of the checkpoint, with and without retained theory lemmas.
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "smt/smt_kernel.h"
+#include "smt/smt_context.h"
+#include "smt/params/smt_params.h"
+#include "util/stopwatch.h"
+#include "test/stat_util.h"
+#include <iostream>
+
+namespace {
+
+    // random 3-clauses over Boolean atoms and difference constraints
+    void mk_clauses(ast_manager& m, random_gen& rand, expr_ref_vector const& bools, expr_ref_vector const& ints,
+                    unsigned num_clauses, expr_ref_vector& fmls) {
+        arith_util a(m);
+        for (unsigned i = 0; i < num_clauses; ++i) {
+            expr_ref_vector lits(m);
+            for (unsigned j = 0; j < 3; ++j) {
+                expr_ref lit(m);
+                if (rand(3) == 0) {
+                    expr* x = ints.get(rand(ints.size()));
+                    expr* y = ints.get(rand(ints.size()));
+                    int c = static_cast<int>(rand(11)) - 5;
+                    lit = a.mk_le(a.mk_sub(x, y), a.mk_int(c));
+                }
+                else
+                    lit = bools.get(rand(bools.size()));
+                if (rand(2) == 0)
+                    lit = m.mk_not(lit);
+                lits.push_back(lit);
+            }
+            fmls.push_back(m.mk_or(lits));
+        }
+    }
+
+    lbool solve_fresh(ast_manager& m, smt_params& fp, expr_ref_vector const& base, expr_ref_vector const& query) {
+        smt::kernel s(m, fp);
+        for (expr* f : base)
+            s.assert_expr(f);
+        for (expr* f : query)
+            s.assert_expr(f);
+        return s.check();
+    }
+
+    bool same_activities(svector<double> const& a, svector<double> const& b) {
+        if (a.size() != b.size())
+            return false;
+        for (unsigned i = 0; i < a.size(); ++i)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+}
+
+void tst_smt_checkpoint() {
+    unsigned num_sat = 0, num_unsat = 0;
+    double retained = 0;
+    stopwatch restore_sw;
+    for (unsigned seed = 0; seed < 8; ++seed) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        arith_util a(m);
+        smt_params fp;
+        fp.m_retain_theory_lemmas = seed % 2 == 1;
+        random_gen rand(seed);
+        expr_ref_vector bools(m), ints(m), base(m);
+        for (unsigned i = 0; i < 40; ++i)
+            bools.push_back(m.mk_const(symbol(("b" + std::to_string(i)).c_str()), m.mk_bool_sort()));
+        for (unsigned i = 0; i < 12; ++i)
+            ints.push_back(m.mk_const(symbol(("x" + std::to_string(i)).c_str()), a.mk_int()));
+        mk_clauses(m, rand, bools, ints, 120, base);
+        smt::kernel s(m, fp);
+        for (expr* f : base)
+            s.assert_expr(f);
+        VERIFY(s.check() == solve_fresh(m, fp, base, expr_ref_vector(m)));
+        unsigned cp = s.checkpoint();
+        smt::context& ctx = s.get_context();
+        unsigned num_vars = ctx.get_num_bool_vars();
+        unsigned num_enodes = ctx.enodes().size();
+        svector<double> activity(ctx.get_activity_vector());
+        for (unsigned q = 0; q < 6; ++q) {
+            expr_ref_vector query(m);
+            mk_clauses(m, rand, bools, ints, 40, query);
+            for (expr* f : query)
+                s.assert_expr(f);
+            lbool r = s.check();
+            VERIFY(r == solve_fresh(m, fp, base, query));
+            if (r == l_true)
+                num_sat++;
+            else if (r == l_false)
+                num_unsat++;
+            restore_sw.start();
+            s.restore(cp);
+            restore_sw.stop();
+            VERIFY(s.get_scope_level() == 1);
+            VERIFY(ctx.get_num_bool_vars() == num_vars);
+            VERIFY(ctx.enodes().size() == num_enodes);
+            VERIFY(same_activities(activity, ctx.get_activity_vector()));
+        }
+        VERIFY(s.check() == solve_fresh(m, fp, base, expr_ref_vector(m)));
+        s.pop(1);
+        VERIFY(ctx.num_checkpoints() == 0);
+        ::statistics st;
+        s.collect_statistics(st);
+        retained += get_stat(st, "retained theory lemmas");
+    }
+    std::cout << "checkpoint queries sat " << num_sat << " unsat " << num_unsat
+              << " retained theory lemmas " << retained << " restore time " << restore_sw.get_seconds() << "\n";
+    VERIFY(num_sat > 0 && num_unsat > 0);
+}
@@ -0,0 +1,158 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_fingerprints.cpp
+
+Abstract:
+
+    Measure insert and lookup throughput and memory use of smt::fingerprint_set
+    and check it against a reference set under backtracking.
+
+--*/
+#include "smt/fingerprints.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "util/stopwatch.h"
+#include <iostream>
+#include <set>
+#include <vector>
+
+namespace {
+
+    struct fingerprint_env {
+        ast_manager        m;
+        region             r;
+        smt::app2enode_t   app2enode;
+        app_ref_vector     consts;
+        ptr_vector<smt::enode> nodes;
+        ptr_vector<void>   data;
+
+        fingerprint_env(unsigned num_nodes, unsigned num_data): consts(m) {
+            reg_decl_plugins(m);
+            arith_util a(m);
+            for (unsigned i = 0; i < num_nodes; ++i) {
+                app* c = m.mk_fresh_const("x", a.mk_int());
+                consts.push_back(c);
+                nodes.push_back(smt::enode::mk(m, r, app2enode, c, 0, true, false, 0, false, false));
+            }
+            for (unsigned i = 0; i < num_data; ++i)
+                data.push_back(consts.get(i % num_nodes));
+        }
+    };
+
+    typedef std::vector<void*> key;
+
+    key mk_key(void* d, unsigned n, smt::enode* const* args) {
+        key k;
+        k.push_back(d);
+        for (unsigned i = 0; i < n; ++i)
+            k.push_back(args[i]);
+        return k;
+    }
+}
+
+/**
+   \brief random inserts and lookups interleaved with push and pop, checked against std::set.
+ */
+static void check_fingerprints(fingerprint_env& env, unsigned num_ops, unsigned seed) {
+    random_gen rand(seed);
+    smt::fingerprint_set s(env.m);
+    std::vector<std::set<key>> scopes(1);
+    auto contains = [&](key const& k) {
+        for (auto const& sc : scopes)
+            if (sc.count(k))
+                return true;
+        return false;
+    };
+    smt::enode* args[3];
+    for (unsigned i = 0; i < num_ops; ++i) {
+        unsigned op = rand(20);
+        if (op == 0) {
+            s.push_scope();
+            scopes.push_back(std::set<key>());
+            continue;
+        }
+        if (op == 1 && scopes.size() > 1) {
+            unsigned n = 1 + rand(scopes.size() - 1);
+            s.pop_scope(n);
+            scopes.resize(scopes.size() - n);
+            continue;
+        }
+        void* d = env.data[rand(env.data.size())];
+        unsigned n = rand(4);
+        for (unsigned j = 0; j < n; ++j)
+            args[j] = env.nodes[rand(env.nodes.size())];
+        key k = mk_key(d, n, args);
+        ENSURE(s.contains(d, reinterpret_cast<size_t>(d) & 0xFFFF, n, args) == contains(k));
+        if (op < 12) {
+            bool is_new = s.insert(d, reinterpret_cast<size_t>(d) & 0xFFFF, n, args, nullptr) != nullptr;
+            ENSURE(is_new == !contains(k));
+            if (is_new)
+                scopes.back().insert(k);
+        }
+        unsigned sz = 0;
+        for (auto const& sc : scopes)
+            sz += static_cast<unsigned>(sc.size());
+        ENSURE(s.size() == sz);
+    }
+}
+
+static void bench_fingerprints(fingerprint_env& env, unsigned num_fingerprints, unsigned num_args) {
+    random_gen rand(0);
+    smt::fingerprint_set s(env.m);
+    svector<smt::enode*> args;
+    unsigned num_keys = 2 * num_fingerprints;
+    for (unsigned i = 0; i < num_keys * num_args; ++i)
+        args.push_back(env.nodes[rand(env.nodes.size())]);
+    auto data = [&](unsigned i) { return env.data[i % env.data.size()]; };
+    auto data_hash = [&](unsigned i) { return i % env.data.size(); };
+
+    stopwatch sw;
+    sw.start();
+    unsigned inserted = 0;
+    for (unsigned i = 0; i < num_fingerprints; ++i)
+        if (s.insert(data(i), data_hash(i), num_args, args.data() + i * num_args, nullptr))
+            ++inserted;
+    sw.stop();
+    double insert_time = sw.get_seconds();
+
+    // half of the lookups hit, the other half use keys that were not inserted.
+    sw.reset();
+    sw.start();
+    unsigned hits = 0;
+    for (unsigned i = 0; i < num_keys; ++i)
+        if (s.contains(data(i), data_hash(i), num_args, args.data() + i * num_args))
+            ++hits;
+    sw.stop();
+    double lookup_time = sw.get_seconds();
+
+    auto rate = [](unsigned n, double secs) { return secs > 0 ? n / secs : 0.0; };
+    std::cout << "args: " << num_args << " fingerprints: " << inserted
+              << " inserts/sec: " << rate(num_fingerprints, insert_time)
+              << " lookups/sec: " << rate(num_keys, lookup_time)
+              << " hits: " << hits
+              << " bytes/fingerprint: " << (inserted ? static_cast<double>(s.memory_size()) / inserted : 0.0) << "\n";
+    ENSURE(hits >= inserted);
+}
+
+void tst_smt_fingerprints() {
+    fingerprint_env env(1000, 16);
+    for (unsigned seed = 1; seed <= 3; ++seed)
+        check_fingerprints(env, 20000, seed);
+}
+
+/**
+   usage: smt_fingerprints_bench [num_fingerprints]
+ */
+void tst_smt_fingerprints_bench(char ** argv, int argc, int& i) {
+    unsigned num_fingerprints = 100000;
+    if (i + 1 < argc && argv[i + 1][0] != '/') {
+        ++i;
+        num_fingerprints = atoi(argv[i]);
+    }
+    fingerprint_env env(1000, 16);
+    for (unsigned num_args : { 1u, 2u, 4u })
+        bench_fingerprints(env, num_fingerprints, num_args);
+}
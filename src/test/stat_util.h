@@ -0,0 +1,28 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    stat_util.h
+
+Abstract:
+
+    Read solver statistics in tests.
+
+--*/
+#pragma once
+
+#include "util/statistics.h"
+#include <cstring>
+
+/**
+   \brief the sum of the values of key in st, statistics collected from 
+   several solvers into st have several entries for the same key.
+ */
+inline double get_stat(::statistics const& st, char const* key) {
+    double r = 0;
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            r += st.is_uint(i) ? st.get_uint_value(i) : st.get_double_value(i);
+    return r;
+}
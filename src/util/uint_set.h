@@ -17,6 +17,7 @@ Revision History:
 
 --*/
 #pragma once
+#include <execinfo.h>
 
 #include "util/util.h"
 #include "util/vector.h"
@@ -319,6 +320,7 @@ public:
     {}
 
     void insert(unsigned x) {
+        if (contains(x)) { void* bt[30]; int k = backtrace(bt, 30); backtrace_symbols_fd(bt, k, 2); }
         SASSERT(!contains(x));
         m_index.reserve(x + 1, UINT_MAX);
         m_elems.reserve(m_size + 1);